@@ -0,0 +1,140 @@
+/**
+ * @file SharedFrameWriter.cpp
+ * @brief Stand-alone example that animates a SharedFrame segment for `main.out --shm`.
+ *
+ * Only SharedFrame.h is needed; the writer does not link against the rest of
+ * the project. Run it first, then the viewer in another terminal:
+ *
+ *     ./bin/SharedFrameWriter.out /terminal-fun 160x90 &
+ *     ./bin/main.out --shm /terminal-fun
+ *
+ * It writes 60 frames a second until it is interrupted or, when given, the
+ * number of seconds has passed, then closes and removes the segment.
+ */
+
+
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+
+
+#include "SharedFrame.h"
+
+
+namespace
+{
+    volatile std::sig_atomic_t stopRequested = 0;
+
+
+    void requestStop(int)
+    {
+        stopRequested = 1;
+    }
+
+
+    /**
+     * @brief Converts a wave in -1 - 1 to a color channel.
+     */
+    uint8_t toChannel(double wave)
+    {
+        return uint8_t(127.5 + 127.5 * wave);
+    }
+}
+
+
+int main(int argc, char * argv[])
+{
+    if (argc < 2 || argc > 4)
+    {
+        std::cerr << "usage: " << argv[0] << " NAME [WIDTHxHEIGHT] [SECONDS]\n";
+        return 2;
+    }
+
+    std::string name = argv[1];
+    size_t width = 160, height = 90;
+    if (argc > 2 && std::sscanf(argv[2], "%zux%zu", &width, &height) != 2)
+    {
+        std::cerr << "frame size must look like WIDTHxHEIGHT\n";
+        return 2;
+    }
+    double seconds = argc > 3 ? std::atof(argv[3]) : 0.0;
+    if (width == 0 || height == 0 || width > 4096 || height > 4096)
+    {
+        std::cerr << "frame size must be between 1x1 and 4096x4096\n";
+        return 2;
+    }
+
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    size_t size = SharedFrame::getSize(height, width);
+    if (fd < 0 || ftruncate(fd, off_t(size)) != 0)
+    {
+        std::cerr << "cannot create shared frame '" << name << "'\n";
+        return 1;
+    }
+    void * mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        std::cerr << "cannot map shared frame '" << name << "'\n";
+        shm_unlink(name.c_str());
+        return 1;
+    }
+
+    // The size comes first; `magic` tells readers it is valid
+    SharedFrame * frame = new (mapping) SharedFrame{};
+    frame->version = SharedFrame::VERSION;
+    frame->height = uint32_t(height);
+    frame->width = uint32_t(width);
+    frame->magic.store(SharedFrame::MAGIC, std::memory_order_release);
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    // Two interfering ring waves drifting across the frame
+    auto start = std::chrono::steady_clock::now();
+    auto next = start;
+    for (size_t number = 0; !stopRequested; number++)
+    {
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds > 0.0 && time >= seconds)
+            break;
+
+        double ax = 0.5 + 0.35 * std::cos(0.7 * time), ay = 0.5 + 0.35 * std::sin(0.9 * time);
+        double bx = 0.5 + 0.35 * std::cos(1.1 * time + 2.0), by = 0.5 + 0.35 * std::sin(0.5 * time + 1.0);
+
+        frame->beginWrite();
+        std::atomic <uint32_t> * cell = frame->getCells();
+        for (size_t i = 0; i < height; i++)
+        {
+            double y = double(i) / double(height);
+            for (size_t j = 0; j < width; j++)
+            {
+                double x = double(j) / double(width);
+                double a = std::hypot(x - ax, y - ay) * 40.0, b = std::hypot(x - bx, y - by) * 30.0;
+                double value = std::sin(a - 4.0 * time) + std::sin(b - 3.0 * time);
+                (cell++)->store(SharedFrame::pack(toChannel(std::sin(value)), toChannel(std::sin(value + 2.1)),
+                                                  toChannel(std::cos(0.5 * value))), std::memory_order_relaxed);
+            }
+        }
+        frame->endWrite();
+
+        next += std::chrono::microseconds(16667);
+        std::this_thread::sleep_until(next);
+    }
+
+    // Readers keep their mapping; they see `closed` and stop after the last frame
+    frame->closed.store(1, std::memory_order_release);
+    munmap(mapping, size);
+    shm_unlink(name.c_str());
+
+    return 0;
+}
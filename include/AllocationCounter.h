@@ -0,0 +1,44 @@
+/**
+ * @file AllocationCounter.h
+ * @brief Heap allocation counting used to verify allocation-free steady-state frames.
+ *
+ * When the project is built with `TERMINAL_COUNT_ALLOCATIONS` defined (see the
+ * `alloccheck` make target, which builds `bin/alloccheck/main.out`), the
+ * global allocation functions are replaced by counting versions and
+ * `TerminalLoop::run()` fails as soon as a steady-state frame touches the
+ * heap. In regular builds the counter is compiled out.
+ */
+
+
+#pragma once
+
+
+#include <cstddef>
+
+
+/**
+ * @namespace AllocationCounter
+ * @brief Access to the global heap allocation counter.
+ */
+namespace AllocationCounter
+{
+#ifdef TERMINAL_COUNT_ALLOCATIONS
+    /// Whether allocation counting is compiled in.
+    inline constexpr bool ENABLED = true;
+#else
+    /// Whether allocation counting is compiled in.
+    inline constexpr bool ENABLED = false;
+#endif
+
+
+    /// Number of frames allowed to allocate while buffers grow to their steady-state size.
+    inline constexpr size_t WARMUP_FRAMES = 3;
+
+
+    /**
+     * @brief Returns the number of heap allocations performed so far.
+     *
+     * @return size_t Allocation count, always 0 when counting is disabled.
+     */
+    size_t getCount();
+}
@@ -305,8 +305,10 @@ struct Color
      *
      * This sets the red, green, and blue components to their average value,
      * creating a neutral tone while maintaining brightness.
+     *
+     * @param linearLight Whether to average in linear light instead of sRGB. Defaults to false.
      */
-    void convertToGrayscale();
+    void convertToGrayscale(bool linearLight = false);
 
 
     /**
@@ -318,10 +320,15 @@ struct Color
      * fully replaces it with the other color. Values in between create
      * a smooth transition.
      *
+     * With `linearLight`, both colors are converted to linear light through
+     * the ColorSpace tables before interpolating, which keeps mixes of bright
+     * and dark colors from looking too dark.
+     *
      * @param other The other color to blend with.
      * @param factor Blend factor (0.0 = no change, 1.0 = full transition to other color).
+     * @param linearLight Whether to interpolate in linear light instead of sRGB. Defaults to false.
      */
-    void blendWith(const Color & other, double factor = 0.5);
+    void blendWith(const Color & other, double factor = 0.5, bool linearLight = false);
 
 
 private:
@@ -342,6 +349,45 @@ private:
     inline double clampColor(double value) const;
 };
 
+
+// Component getters are defined inline so per-cell loops over grids can be vectorized.
+
+inline int Color::getRed() const
+{
+    return int(red);
+}
+
+
+inline int Color::getGreen() const
+{
+    return int(green);
+}
+
+
+inline int Color::getBlue() const
+{
+    return int(blue);
+}
+
+
+inline double Color::getR() const
+{
+    return red;
+}
+
+
+inline double Color::getG() const
+{
+    return green;
+}
+
+
+inline double Color::getB() const
+{
+    return blue;
+}
+
+
 /**
  * @namespace Colors
  * @brief Contains predefined color constants.
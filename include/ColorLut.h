@@ -0,0 +1,154 @@
+/**
+ * @file ColorLut.h
+ * @brief Defines the ColorLut class, a 3D lookup table for color grading.
+ */
+
+
+#pragma once
+
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+#include "OneSymbol.h"
+
+
+/**
+ * @class ColorLut
+ * @brief Maps every RGB color through a sampled 3D table.
+ *
+ * The table stores the graded color at `size`³ evenly spaced points of the RGB
+ * cube (17³ and 33³ are the usual sizes); colors between the points are
+ * interpolated, either trilinearly from the 8 surrounding points or
+ * tetrahedrally from 4 of them, which is cheaper and preserves the gray axis
+ * exactly. Any per-color transform, however expensive, costs the same per cell
+ * once baked into a table, and `.cube` files from grading tools can be loaded
+ * directly.
+ */
+class ColorLut
+{
+public:
+    /// Usual table sizes.
+    static constexpr size_t SMALL_SIZE = 17;
+    static constexpr size_t LARGE_SIZE = 33;
+
+
+    /**
+     * @brief How colors between table points are computed.
+     */
+    enum class Interpolation
+    {
+        Trilinear,      ///< Weighted from the 8 corners of the enclosing cell.
+        Tetrahedral     ///< Weighted from the 4 corners of the enclosing tetrahedron.
+    };
+
+
+    /**
+     * @brief Builds the identity table.
+     *
+     * @param Size Points per axis, at least 2.
+     */
+    explicit ColorLut(size_t Size = LARGE_SIZE);
+
+
+    /**
+     * @brief Builds a table by sampling a color transform at every table point.
+     *
+     * @tparam Transform Callable taking a `const Color &` and returning the graded Color.
+     * @param transform The transform to bake.
+     * @param size Points per axis, at least 2.
+     * @return ColorLut The baked table.
+     */
+    template <typename Transform>
+    static ColorLut fromFunction(const Transform & transform, size_t size = LARGE_SIZE)
+    {
+        ColorLut lut(size);
+        double step = 255.0 / double(size - 1);
+        for (size_t b = 0; b < size; b++)
+            for (size_t g = 0; g < size; g++)
+                for (size_t r = 0; r < size; r++)
+                    lut.setPoint(r, g, b, transform(Color(double(r) * step, double(g) * step, double(b) * step)));
+
+        return lut;
+    }
+
+
+    /**
+     * @brief Loads an Adobe/Resolve `.cube` 3D table.
+     *
+     * @param path Path of the file.
+     * @return ColorLut The loaded table.
+     *
+     * @throws std::runtime_error If the file cannot be read or is not a valid 3D table.
+     */
+    static ColorLut loadCube(const std::string & path);
+
+
+    /**
+     * @brief Builds one of the built-in grades.
+     *
+     * Available presets are `sepia`, `night` (dim red-shifted view that keeps
+     * dark adaptation) and `deuteranopia` (shifts red-green contrast into
+     * lightness and blue for red-green colorblind viewers).
+     *
+     * @param name Preset name.
+     * @param size Points per axis.
+     * @return ColorLut The baked table.
+     *
+     * @throws std::invalid_argument If the preset is unknown.
+     */
+    static ColorLut preset(std::string_view name, size_t size = LARGE_SIZE);
+
+
+    /**
+     * @brief Grades a single color.
+     *
+     * @param color Color to grade.
+     * @return Color The graded color.
+     */
+    Color apply(const Color & color) const;
+
+
+    /**
+     * @brief Grades the foreground and background of every cell, rows in parallel.
+     *
+     * @param grid The grid to grade, usually the scaled grid.
+     */
+    void applyToGrid(std::vector < std::vector < OneSymbol > > & grid) const;
+
+
+    /**
+     * @brief Selects the interpolation used by `apply()` and `applyToGrid()`.
+     *
+     * @param newInterpolation The interpolation.
+     */
+    void setInterpolation(Interpolation newInterpolation);
+
+
+    /**
+     * @brief Returns the number of points per axis.
+     *
+     * @return size_t Points per axis.
+     */
+    size_t getSize() const;
+
+private:
+    size_t size;                ///< Points per axis.
+    std::vector <float> table;  ///< Graded RGB (0-255) per point, red index fastest.
+    Interpolation interpolation = Interpolation::Tetrahedral;   ///< Interpolation in use.
+
+
+    /**
+     * @brief Stores the graded color of one table point.
+     */
+    void setPoint(size_t r, size_t g, size_t b, const Color & color);
+
+
+    /**
+     * @brief Grades one row of cells with a fixed interpolation.
+     */
+    template <Interpolation Mode>
+    void applyToRow(OneSymbol * row, size_t count) const;
+};
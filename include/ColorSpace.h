@@ -0,0 +1,61 @@
+/**
+ * @file ColorSpace.h
+ * @brief Lookup tables converting between sRGB and linear light.
+ */
+
+
+#pragma once
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+
+/**
+ * @namespace ColorSpace
+ * @brief Table-driven sRGB <-> linear-light conversion.
+ *
+ * Averaging or interpolating sRGB values directly darkens mixed colors, because
+ * sRGB is not proportional to light intensity. Converting through `std::pow`
+ * for every sample is too slow for per-frame use, so both directions are
+ * precomputed: 8-bit sRGB expands to 16-bit linear light, and 16-bit linear
+ * light is reduced to 12 bits to index the way back.
+ */
+namespace ColorSpace
+{
+    /// Largest linear-light value; 1.0 in linear light.
+    constexpr uint16_t LINEAR_MAX = 65535;
+
+    /// Number of bits of linear light used to index the sRGB table.
+    constexpr unsigned LINEAR_INDEX_BITS = 12;
+
+
+    extern const std::array <uint16_t, 256> SRGB_TO_LINEAR;                         ///< 8-bit sRGB to 16-bit linear light.
+    extern const std::array <uint8_t, size_t(1) << LINEAR_INDEX_BITS> LINEAR_TO_SRGB;  ///< 12-bit linear light to 8-bit sRGB.
+
+
+    /**
+     * @brief Converts an sRGB component to linear light.
+     *
+     * @param value sRGB component (0-255); rounded and clamped.
+     * @return uint16_t Linear light (0-65535).
+     */
+    inline uint16_t toLinear(double value)
+    {
+        return SRGB_TO_LINEAR[size_t(value <= 0.0 ? 0.0 : value >= 255.0 ? 255.0 : value + 0.5)];
+    }
+
+
+    /**
+     * @brief Converts linear light back to an sRGB component.
+     *
+     * @param value Linear light (0-65535); clamped.
+     * @return uint8_t sRGB component (0-255).
+     */
+    inline uint8_t toSrgb(double value)
+    {
+        double clamped = value <= 0.0 ? 0.0 : value >= LINEAR_MAX ? LINEAR_MAX : value;
+        return LINEAR_TO_SRGB[size_t(clamped + 0.5) >> (16 - LINEAR_INDEX_BITS)];
+    }
+}
@@ -0,0 +1,113 @@
+/**
+ * @file Compositor.h
+ * @brief Defines the Compositor class that flattens a stack of layers into one grid.
+ */
+
+
+#pragma once
+
+
+#include <memory>
+#include <vector>
+
+
+#include "Layer.h"
+
+
+/**
+ * @class Compositor
+ * @brief Blends a z-ordered stack of layers into a target grid, recomposing only dirty tiles.
+ *
+ * The screen is split into `Layer::TILE_ROWS` x `Layer::TILE_COLS` tiles. A tile
+ * is recomposed only when at least one layer changed it since the last
+ * composite; every other tile of the target keeps its previous contents, so a
+ * static background under a changing overlay is not redrawn. Within a dirty
+ * tile, composition starts at the topmost fully opaque layer and skips hidden
+ * and fully transparent layers. Rows are blended with the vectorized
+ * `TerminalEffects::blendRow`.
+ */
+class Compositor
+{
+public:
+    /**
+     * @brief Constructs an empty compositor.
+     *
+     * @param Height Height of every layer and of the composite, in cells.
+     * @param Width Width of every layer and of the composite, in cells.
+     */
+    Compositor(size_t Height, size_t Width);
+
+
+    /**
+     * @brief Adds a transparent layer to the stack.
+     *
+     * Layers with equal z-order are drawn in the order they were added.
+     *
+     * @param zOrder Stacking position; higher layers are drawn on top.
+     * @param opacity Opacity of the whole layer (0.0 - 1.0). Defaults to 1.0.
+     * @return Layer& The new layer, owned by the compositor.
+     */
+    Layer & addLayer(int zOrder, double opacity = 1.0);
+
+
+    /**
+     * @brief Removes a layer from the stack.
+     *
+     * @param layer The layer to remove; references to it become invalid.
+     */
+    void removeLayer(const Layer & layer);
+
+
+    /**
+     * @brief Resizes the composite and every layer.
+     *
+     * @param newHeight New height in cells.
+     * @param newWidth New width in cells.
+     */
+    void resize(size_t newHeight, size_t newWidth);
+
+
+    /**
+     * @brief Sets the symbol shown where no layer covers a cell.
+     *
+     * @param oneSymbol The backdrop symbol.
+     */
+    void setBackdrop(const OneSymbol & oneSymbol);
+
+
+    /**
+     * @brief Composes the dirty tiles of the stack into a grid.
+     *
+     * The target is resized to the compositor size if needed, which forces a
+     * full composite; otherwise clean tiles are left untouched.
+     *
+     * @param target The grid to compose into, usually the terminal's active grid.
+     * @return size_t Number of tiles that were recomposed.
+     */
+    size_t composite(std::vector < std::vector < OneSymbol > > & target);
+
+private:
+    std::vector < std::unique_ptr < Layer > > layers;   ///< Layer stack, sorted by z-order before composing.
+    OneSymbol backdrop;         ///< Shown where no layer covers a cell.
+    size_t height;              ///< Height in cells.
+    size_t width;               ///< Width in cells.
+    bool fullComposite;         ///< Set when every tile must be recomposed regardless of layer state.
+
+
+    /**
+     * @brief Stably sorts the stack by z-order without allocating.
+     */
+    void sortLayers();
+
+
+    /**
+     * @brief Recomposes one tile from the stack.
+     */
+    void compositeTile(std::vector < std::vector < OneSymbol > > & target, size_t tileRow, size_t tileCol) const;
+
+
+    /**
+     * @brief Reports whether a span starting or ending at `col` would split a wide glyph of a layer from `bottom - 1` up.
+     */
+    bool splitsWideGlyph(size_t row, size_t col, size_t bottom) const;
+};
@@ -0,0 +1,185 @@
+/**
+ * @file EffectTimeline.h
+ * @brief Defines the EffectTimeline class that schedules keyframed effects over frame ranges.
+ */
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <vector>
+
+
+#include "OneSymbol.h"
+
+
+/**
+ * @class EffectTimeline
+ * @brief Runs scripted brightness, color increment and blend effects with eased, keyframed parameters.
+ *
+ * Each track applies one effect from TerminalEffects to every cell while the
+ * frame number is within its range, with a parameter interpolated between
+ * keyframes. All three effects are per-channel `clamp(value * scale + offset)`
+ * maps, so every frame the active tracks are reduced to a short list of such
+ * steps and applied in a single pass over the grid, rows in parallel. When
+ * no track is active, or every active track is at its neutral value, the
+ * grid is not touched at all.
+ *
+ * Scripting a long-running display then means adding tracks once instead of
+ * counting frames in `update()`:
+ *
+ *     timeline.blend(0, 45, Colors::BLACK).key(0, 1.0).key(45, 0.0, EffectTimeline::Easing::EaseOut);
+ */
+class EffectTimeline
+{
+public:
+    /**
+     * @brief How a parameter moves from the previous keyframe to the next.
+     */
+    enum class Easing
+    {
+        Step,       ///< Holds the previous value, then jumps at the keyframe.
+        Linear,     ///< Constant speed.
+        EaseIn,     ///< Starts slowly (quadratic).
+        EaseOut,    ///< Ends slowly (quadratic).
+        EaseInOut   ///< Starts and ends slowly (smoothstep).
+    };
+
+
+    /**
+     * @brief What a track does with its parameter.
+     */
+    enum class Effect
+    {
+        Brightness,     ///< Adds the parameter to every channel, like `adjustBrightnessByIncrementEffect`.
+        ColorIncrement, ///< Adds the track colors scaled by the parameter, like `incrementColorEffect`.
+        Blend           ///< Blends towards the track colors by the parameter (0-1).
+    };
+
+
+    /**
+     * @brief A parameter value at a frame.
+     */
+    struct Keyframe
+    {
+        size_t frame;       ///< Frame the value is reached at.
+        double value;       ///< The value.
+        Easing easing;      ///< Curve from the previous keyframe to this one.
+    };
+
+
+    /**
+     * @brief One effect over a range of frames.
+     */
+    struct Track
+    {
+        Effect effect;                      ///< The effect.
+        size_t firstFrame;                  ///< First frame the track is active in.
+        size_t lastFrame;                   ///< Last frame the track is active in.
+        Color foreground;                   ///< Foreground increment or blend target.
+        Color background;                   ///< Background increment or blend target.
+        std::vector <Keyframe> keyframes;   ///< Sorted by frame.
+
+
+        /**
+         * @brief Adds a keyframe, replacing one at the same frame.
+         *
+         * @param frame Absolute frame number.
+         * @param value Parameter value at that frame.
+         * @param easing Curve from the previous keyframe. Defaults to linear.
+         * @return Track & This track, for chaining.
+         */
+        Track & key(size_t frame, double value, Easing easing = Easing::Linear);
+
+
+        /**
+         * @brief Returns the parameter at a frame; held constant before the first and after the last keyframe.
+         *
+         * @param frame Absolute frame number.
+         * @return double The parameter, 0 when there are no keyframes.
+         */
+        double valueAt(size_t frame) const;
+    };
+
+
+    /**
+     * @brief Adds a brightness track; the parameter is the increment per channel.
+     *
+     * @param firstFrame First active frame.
+     * @param lastFrame Last active frame.
+     * @return Track & The new track, valid until the next track is added.
+     */
+    Track & brightness(size_t firstFrame, size_t lastFrame);
+
+
+    /**
+     * @brief Adds a color increment track; the parameter scales the increments.
+     *
+     * @param firstFrame First active frame.
+     * @param lastFrame Last active frame.
+     * @param foreground Foreground increment at parameter 1.
+     * @param background Background increment at parameter 1.
+     * @return Track & The new track, valid until the next track is added.
+     */
+    Track & colorIncrement(size_t firstFrame, size_t lastFrame, const Color & foreground, const Color & background);
+
+
+    /**
+     * @brief Adds a blend track; the parameter is the blend factor towards the target.
+     *
+     * @param firstFrame First active frame.
+     * @param lastFrame Last active frame.
+     * @param target Color both foreground and background blend towards.
+     * @return Track & The new track, valid until the next track is added.
+     */
+    Track & blend(size_t firstFrame, size_t lastFrame, const Color & target);
+
+
+    /**
+     * @brief Removes every track.
+     */
+    void clear();
+
+
+    /**
+     * @brief Reports whether any track is active in a frame.
+     *
+     * @param frame Absolute frame number.
+     * @return bool True if `apply()` would evaluate at least one track.
+     */
+    bool isActive(size_t frame) const;
+
+
+    /**
+     * @brief Applies every track active in a frame to a grid, in the order the tracks were added.
+     *
+     * Does not allocate once the tracks are set up.
+     *
+     * @param grid The grid to modify.
+     * @param frame Absolute frame number.
+     * @return bool Whether the grid was modified.
+     */
+    bool apply(std::vector < std::vector < OneSymbol > > & grid, size_t frame);
+
+private:
+    /**
+     * @brief A track evaluated for one frame: `clamp(channel * scale + offset)`.
+     */
+    struct Step
+    {
+        double scale;               ///< Factor applied to every channel.
+        double foreground[3];       ///< Offsets of the foreground channels.
+        double background[3];       ///< Offsets of the background channels.
+    };
+
+
+    std::vector <Track> tracks;     ///< Tracks in the order they were added.
+    std::vector <Step> steps;       ///< Steps of the current frame; capacity kept for every track.
+
+
+    /**
+     * @brief Appends a track and makes room for its step.
+     */
+    Track & addTrack(Effect effect, size_t firstFrame, size_t lastFrame, const Color & foreground, const Color & background);
+};
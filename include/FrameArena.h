@@ -0,0 +1,97 @@
+/**
+ * @file FrameArena.h
+ * @brief Defines a monotonic per-frame allocator for frame temporaries.
+ *
+ * The FrameArena hands out memory by bumping an offset inside one large block
+ * and releases everything at once when the frame ends. After the first few
+ * frames the block has grown to the high-water mark and steady-state frames
+ * no longer touch the heap.
+ */
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+
+/**
+ * @class FrameArena
+ * @brief Monotonic memory resource that is reset at the end of every frame.
+ *
+ * Memory is carved out of a single contiguous block. When a frame needs more
+ * than the block holds, the extra requests are served from overflow blocks and
+ * the next `reset()` replaces the main block with one large enough for the
+ * whole frame. Deallocation is a no-op; all memory is reclaimed by `reset()`.
+ *
+ * Being a `std::pmr::memory_resource`, the arena can also back `std::pmr`
+ * containers used as effect temporaries.
+ */
+class FrameArena : public std::pmr::memory_resource
+{
+public:
+    /**
+     * @brief Constructs an arena with an initial block.
+     *
+     * @param InitialCapacity Size of the first block in bytes. Defaults to 1 MiB.
+     */
+    explicit FrameArena(size_t InitialCapacity = size_t(1) << 20);
+
+
+    /**
+     * @brief Allocates an uninitialized array of `count` objects of type `T`.
+     *
+     * Intended for trivially destructible types; destructors are never run.
+     *
+     * @tparam T Element type.
+     * @param count Number of elements.
+     * @return T* Pointer to the first element, valid until the next `reset()`.
+     */
+    template <typename T>
+    T * allocateArray(size_t count)
+    {
+        return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+
+    /**
+     * @brief Releases every allocation made since the previous reset.
+     *
+     * If the frame spilled into overflow blocks, the main block is regrown
+     * to the frame's total usage so that the next frame fits without spilling.
+     */
+    void reset();
+
+
+    /**
+     * @brief Returns the number of bytes handed out since the last reset.
+     *
+     * @return size_t Bytes in use, including alignment padding.
+     */
+    size_t getUsed() const;
+
+
+    /**
+     * @brief Returns the size of the main block in bytes.
+     *
+     * @return size_t Capacity available before the arena spills into overflow blocks.
+     */
+    size_t getCapacity() const;
+
+
+protected:
+    void * do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void * pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override;
+
+
+private:
+    std::unique_ptr <std::byte[]> block;                      ///< Main block reused every frame.
+    size_t capacity;                                          ///< Size of the main block.
+    size_t offset;                                            ///< Bump offset inside the main block.
+    size_t overflowBytes;                                     ///< Bytes served from overflow blocks this frame.
+    std::vector < std::unique_ptr <std::byte[]> > overflow;   ///< Blocks allocated after the main block ran out.
+};
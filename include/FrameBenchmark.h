@@ -0,0 +1,102 @@
+/**
+ * @file FrameBenchmark.h
+ * @brief Defines the FrameBenchmark class that measures frame encoding on synthetic scenes.
+ */
+
+
+#pragma once
+
+
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+
+#include "OneSymbol.h"
+#include "FrameEncoder.h"
+#include "FrameArena.h"
+
+
+/**
+ * @class FrameBenchmark
+ * @brief Encodes fixed synthetic frames repeatedly and reports sizes and timings.
+ *
+ * The scenes are generated from a fixed seed and never touch the terminal, so
+ * results are comparable between runs and machines: a gradient of uniform
+ * rows (like GrayScaleGradient), a text screen over a plain background, and
+ * per-cell noise that defeats any run merging.
+ */
+class FrameBenchmark
+{
+public:
+    /**
+     * @brief Builds the scenes.
+     *
+     * @param Height Rows of every scene.
+     * @param Width Columns of every scene.
+     * @param Iterations Encodes timed per measurement.
+     */
+    FrameBenchmark(size_t Height = 60, size_t Width = 200, size_t Iterations = 200);
+
+
+    /**
+     * @brief Runs every measurement and writes a human-readable report.
+     *
+     * @param report Stream receiving the report.
+     */
+    void run(std::ostream & report);
+
+private:
+    /**
+     * @brief A named synthetic frame.
+     */
+    struct Scene
+    {
+        std::string_view name;                                  ///< Name printed in the report.
+        std::vector < std::vector < OneSymbol > > grid;         ///< The frame.
+    };
+
+
+    std::vector <Scene> scenes;     ///< Frames every measurement runs on.
+    size_t iterations;              ///< Encodes timed per measurement.
+    FrameArena arena;               ///< Output buffers, reset after every encode.
+
+
+    /**
+     * @brief Reports encoded bytes, compression against per-cell encoding and encode time for every span mode.
+     */
+    void reportSpans(std::ostream & report);
+
+
+    /**
+     * @brief Reports the cost of SGR color emission per palette, with every cell encoded on its own.
+     */
+    void reportColors(std::ostream & report);
+
+
+    /**
+     * @brief Reports how parallel row encoding scales with the number of threads.
+     */
+    void reportThreads(std::ostream & report);
+
+
+    /**
+     * @brief Encodes a scene `iterations` times.
+     *
+     * @param encoder The configured encoder.
+     * @param scene The scene to encode.
+     * @param bytes Receives the size of one encoded frame.
+     * @return double Microseconds per frame.
+     */
+    double timeEncode(const FrameEncoder & encoder, const Scene & scene, size_t & bytes);
+
+
+    /**
+     * @brief Encodes a scene `iterations` times with `FrameEncoder::encodeParallel()`.
+     *
+     * @param encoder The configured encoder.
+     * @param scene The scene to encode.
+     * @return double Microseconds per frame.
+     */
+    double timeParallelEncode(const FrameEncoder & encoder, const Scene & scene);
+};
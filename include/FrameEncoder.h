@@ -0,0 +1,302 @@
+/**
+ * @file FrameEncoder.h
+ * @brief Defines the FrameEncoder class that turns a symbol grid into ANSI output.
+ */
+
+
+#pragma once
+
+
+#include <string_view>
+#include <sys/uio.h>
+#include <vector>
+
+
+#include "OneSymbol.h"
+#include "FrameArena.h"
+
+
+/**
+ * @class FrameEncoder
+ * @brief Encodes grids of OneSymbol objects into ANSI escape sequences.
+ *
+ * The encoder writes directly into caller-provided memory, typically a block
+ * taken from the per-frame FrameArena, so encoding a frame performs no heap
+ * allocation and no iostream formatting. Runs of identical cells, such as the
+ * uniform rows of a gradient, are emitted as spans that cost a handful of
+ * bytes instead of a full escape sequence per cell. Glyphs are copied from
+ * their pre-encoded GlyphTable entries, whatever their UTF-8 length.
+ */
+class FrameEncoder
+{
+public:
+    /// Upper bound on the bytes produced for a single cell.
+    static constexpr size_t MAX_CELL_BYTES = 56;
+
+    /// Upper bound on the bytes of a cursor move in a diff frame.
+    static constexpr size_t MAX_CURSOR_BYTES = 24;
+
+    /// Most slices `encodeSlices()` splits a frame into.
+    static constexpr size_t MAX_SLICES = 64;
+
+
+    /**
+     * @brief Which parts of a cell are emitted.
+     */
+    enum class Mode
+    {
+        Full,               ///< Foreground color, background color and glyph.
+        ForegroundOnly,     ///< Foreground color and glyph; the terminal's background shows through.
+        Monochrome          ///< Glyph only, without any escape sequences.
+    };
+
+
+    /**
+     * @brief How colors are written.
+     */
+    enum class Palette
+    {
+        TrueColor,  ///< 24-bit SGR colors.
+        Indexed     ///< The closest entry of the xterm 256-color palette, for terminals without 24-bit color.
+    };
+
+
+    /**
+     * @brief How runs of identical cells are emitted.
+     *
+     * Every span mode writes the colors once per run instead of once per cell.
+     */
+    enum class Spans
+    {
+        None,       ///< Every cell is encoded on its own.
+        Plain,      ///< Colors once, then the glyph repeated; works on any terminal.
+        Erase,      ///< Long runs of spaces become ECH (erase characters) plus a cursor move.
+        Repeat      ///< Long runs become the glyph once plus REP (repeat preceding character).
+    };
+
+
+    /**
+     * @brief A rectangle of cells, in grid coordinates.
+     */
+    struct Region
+    {
+        size_t top;     ///< First row.
+        size_t left;    ///< First column.
+        size_t height;  ///< Number of rows.
+        size_t width;   ///< Number of columns.
+    };
+
+
+    /**
+     * @brief Encodes one symbol with its foreground and background colors.
+     *
+     * In `Mode::Full` every cell resets its attributes; the other modes leave
+     * that to the end of the frame.
+     *
+     * @param oneSymbol The symbol to encode.
+     * @param out Destination buffer with room for at least `MAX_CELL_BYTES` bytes.
+     * @param mode Which parts of the cell to emit. Defaults to `Mode::Full`.
+     * @param palette How colors are written. Defaults to `Palette::TrueColor`.
+     * @return size_t Number of bytes written.
+     */
+    static size_t encodeCell(const OneSymbol & oneSymbol, char * out, Mode mode = Mode::Full, Palette palette = Palette::TrueColor);
+
+
+    /**
+     * @brief Returns the worst-case encoded size of a grid.
+     *
+     * @param grid The grid that will be encoded.
+     * @return size_t Upper bound on the number of bytes `encode()` may write.
+     */
+    static size_t maxEncodedSize(const std::vector < std::vector < OneSymbol > > & grid);
+
+
+    /**
+     * @brief Returns the worst-case size of a diff frame of a grid.
+     *
+     * @param grid The grid that will be encoded.
+     * @return size_t Upper bound on the number of bytes `encodeDiff()` may write.
+     */
+    static size_t maxDiffSize(const std::vector < std::vector < OneSymbol > > & grid);
+
+
+    /**
+     * @brief Encodes a whole grid row by row.
+     *
+     * @param grid The grid to encode.
+     * @param out Destination buffer with room for `maxEncodedSize(grid)` bytes.
+     * @return size_t Number of bytes written.
+     */
+    size_t encode(const std::vector < std::vector < OneSymbol > > & grid, char * out) const;
+
+
+    /**
+     * @brief Encodes only the cells that changed since the previous frame.
+     *
+     * Changed cells are grouped into spans, short unchanged gaps included, and
+     * each span is preceded by an absolute cursor move. The output is only
+     * correct when the screen still shows `previous`, and partially applied
+     * diffs look worse than torn full frames, so it is meant to be written
+     * inside a synchronized update.
+     *
+     * @param grid The grid to encode.
+     * @param previous The grid on screen; must have the same size as `grid`.
+     * @param out Destination buffer with room for `maxDiffSize(grid)` bytes.
+     * @return size_t Number of bytes written.
+     */
+    size_t encodeDiff(const std::vector < std::vector < OneSymbol > > & grid,
+                      const std::vector < std::vector < OneSymbol > > & previous, char * out) const;
+
+
+    /**
+     * @brief Encodes a grid in slices of rows, in parallel on the TileScheduler.
+     *
+     * Rows do not depend on each other: every cell sets its own colors, and
+     * diff spans start with an absolute cursor move. So each slice is encoded
+     * on its own into a fixed share of `out`, sized for its rows' worst case,
+     * and the slices are returned in row order, ready to be written with one
+     * `writev()`. With one thread the whole grid is a single slice.
+     *
+     * @param grid The grid to encode.
+     * @param previous The grid on screen to encode only the changes against, like `encodeDiff()`; null for the whole grid.
+     * @param out Destination buffer with room for `maxEncodedSize(grid)` bytes, or `maxDiffSize(grid)` with `previous`.
+     * @param slices Receives the slices in row order; room for `MAX_SLICES` entries.
+     * @return size_t Number of slices.
+     */
+    size_t encodeSlices(const std::vector < std::vector < OneSymbol > > & grid,
+                        const std::vector < std::vector < OneSymbol > > * previous, char * out, iovec * slices) const;
+
+
+    /**
+     * @brief Encodes a whole grid like `encode()`, with the rows split over threads by `encodeSlices()`.
+     *
+     * @param grid The grid to encode.
+     * @param out Destination buffer with room for `maxEncodedSize(grid)` bytes.
+     * @return size_t Number of bytes written; the slices are moved together in row order.
+     */
+    size_t encodeParallel(const std::vector < std::vector < OneSymbol > > & grid, char * out) const;
+
+
+    /**
+     * @brief Returns the worst-case size of a region encoded by `encodeRegion()`.
+     *
+     * @param region The region.
+     * @return size_t Upper bound on the number of bytes `encodeRegion()` may write.
+     */
+    static size_t maxRegionSize(const Region & region);
+
+
+    /**
+     * @brief Encodes a rectangle of a grid, each row preceded by an absolute cursor move.
+     *
+     * Lets parts of the screen that changed be repainted without touching the
+     * rest, whether or not the output is synchronized. The region is clipped
+     * to the grid.
+     *
+     * @param grid The grid to encode.
+     * @param region The cells to encode.
+     * @param out Destination buffer with room for `maxRegionSize(region)` bytes.
+     * @return size_t Number of bytes written.
+     */
+    size_t encodeRegion(const std::vector < std::vector < OneSymbol > > & grid, const Region & region, char * out) const;
+
+
+    /**
+     * @brief Encodes a whole grid into memory taken from a frame arena.
+     *
+     * @param grid The grid to encode.
+     * @param arena Arena providing the output buffer.
+     * @return std::string_view The encoded frame, valid until the arena is reset.
+     */
+    std::string_view encode(const std::vector < std::vector < OneSymbol > > & grid, FrameArena & arena) const;
+
+
+    /**
+     * @brief Selects which parts of each cell are emitted.
+     *
+     * @param newMode The output mode.
+     */
+    void setMode(Mode newMode);
+
+
+    /**
+     * @brief Returns the current output mode.
+     *
+     * @return Mode The output mode.
+     */
+    Mode getMode() const;
+
+
+    /**
+     * @brief Selects how runs of identical cells are emitted.
+     *
+     * `Spans::Erase` and `Spans::Repeat` need terminal support for ECH and REP
+     * respectively; `Spans::Plain` works everywhere.
+     *
+     * @param newSpans The span mode.
+     */
+    void setSpans(Spans newSpans);
+
+
+    /**
+     * @brief Returns the current span mode.
+     *
+     * @return Spans The span mode.
+     */
+    Spans getSpans() const;
+
+
+    /**
+     * @brief Selects how colors are written.
+     *
+     * @param newPalette The palette.
+     */
+    void setPalette(Palette newPalette);
+
+
+    /**
+     * @brief Returns the current palette.
+     *
+     * @return Palette The palette.
+     */
+    Palette getPalette() const;
+
+
+private:
+    Mode mode = Mode::Full;         ///< Which parts of each cell are emitted.
+    Spans spans = Spans::Plain;     ///< How runs of identical cells are emitted.
+    Palette palette = Palette::TrueColor;   ///< How colors are written.
+
+
+    /**
+     * @brief Reports whether two cells look the same in the current mode.
+     *
+     * The foreground color of a space is invisible and is ignored.
+     */
+    bool sameCell(const OneSymbol & first, const OneSymbol & second) const;
+
+
+    /**
+     * @brief Encodes a range of rows, whole or as a diff, without the final reset.
+     *
+     * @param grid The grid to encode.
+     * @param previous The grid on screen, or null to encode whole rows.
+     * @param firstRow First row to encode.
+     * @param lastRow One past the last row to encode.
+     * @param out Destination buffer with room for the rows' worst case.
+     * @return size_t Number of bytes written.
+     */
+    size_t encodeRows(const std::vector < std::vector < OneSymbol > > & grid,
+                      const std::vector < std::vector < OneSymbol > > * previous, size_t firstRow, size_t lastRow, char * out) const;
+
+
+    /**
+     * @brief Encodes one row, merging runs of identical cells.
+     *
+     * @param row The cells of the row.
+     * @param count Number of cells.
+     * @param out Destination buffer with room for `count * MAX_CELL_BYTES` bytes.
+     * @return size_t Number of bytes written.
+     */
+    size_t encodeRow(const OneSymbol * row, size_t count, char * out) const;
+};
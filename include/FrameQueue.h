@@ -0,0 +1,184 @@
+/**
+ * @file FrameQueue.h
+ * @brief Defines FrameQueue, a pool of grid buffers handed from a producer thread to a rendering loop without locks.
+ */
+
+
+#pragma once
+
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+#include "OneSymbol.h"
+#include "SpscQueue.h"
+
+
+/**
+ * @class FrameQueue
+ * @brief Bounded lock-free hand-over of whole frames from one producer thread to one consumer.
+ *
+ * The queue owns a small pool of grids. The producer `acquire()`s a free
+ * grid, draws straight into it and `submit()`s it; the consumer takes the
+ * newest submitted grid with `takeNewest()`, which recycles every older one,
+ * and gives it back with `release()` once done with it. Frames are never
+ * copied: grids move between the two sides as pool indices through two
+ * rings, submitted frames in one and recycled ones in an SpscQueue.
+ *
+ * When every grid is in use, `acquire()` either takes back the oldest frame
+ * the consumer has not taken yet or waits for the consumer to recycle one,
+ * depending on the back-pressure policy. After the first few frames have
+ * sized the grids, neither side allocates.
+ */
+class FrameQueue
+{
+public:
+    /// A frame: rows of cells.
+    using Grid = std::vector < std::vector < OneSymbol > >;
+
+
+    /**
+     * @brief What `acquire()` does when every grid is in use.
+     */
+    enum class Policy
+    {
+        DropOldest, ///< Reuse the oldest frame the consumer has not taken yet; the producer never waits.
+        Block       ///< Wait until the consumer recycles a grid, so the producer never runs ahead of it by more than the depth.
+    };
+
+
+    /**
+     * @brief Frame counters of the queue.
+     */
+    struct Statistics
+    {
+        size_t submitted;   ///< Frames the producer submitted.
+        size_t dropped;     ///< Submitted frames recycled without being taken.
+        size_t taken;       ///< Frames the consumer took.
+    };
+
+
+    /// Most frames that can wait for the consumer.
+    static constexpr size_t MAX_DEPTH = 8;
+
+
+    /**
+     * @brief Constructs a queue with empty grids.
+     *
+     * @param BackPressure What the producer does when every grid is in use.
+     * @param Depth Frames that can wait for the consumer, clamped to 1 - `MAX_DEPTH`.
+     */
+    FrameQueue(Policy BackPressure = Policy::DropOldest, size_t Depth = 2);
+
+
+    FrameQueue(const FrameQueue &) = delete;
+    FrameQueue & operator = (const FrameQueue &) = delete;
+
+
+    /**
+     * @brief Returns a grid to draw the next frame into; producer thread only.
+     *
+     * The grid is resized to `height` x `width` and keeps whatever it held
+     * before, an older frame of the same producer or of the consumer. The
+     * producer holds at most one grid at a time.
+     *
+     * @param height Rows of the frame.
+     * @param width Columns of the frame.
+     * @return Grid * The grid, or null once the queue is closed.
+     */
+    Grid * acquire(size_t height, size_t width);
+
+
+    /**
+     * @brief Hands a grid from `acquire()` to the consumer; producer thread only.
+     *
+     * @param frame The filled grid.
+     */
+    void submit(Grid * frame);
+
+
+    /**
+     * @brief Takes the newest submitted frame and recycles the older ones; consumer thread only.
+     *
+     * @return Grid * The frame, to be passed back to `release()`, or null if nothing was submitted since the last call.
+     */
+    Grid * takeNewest();
+
+
+    /**
+     * @brief Gives a grid from `takeNewest()` back to the producer; consumer thread only.
+     *
+     * The consumer may swap the grid's contents with a grid of its own of
+     * the same type instead of reading them in place; the producer then
+     * receives that grid's buffers.
+     *
+     * @param frame The grid.
+     */
+    void release(Grid * frame);
+
+
+    /**
+     * @brief Closes the queue: a waiting `acquire()` and all later ones return null.
+     *
+     * Either side may call it; frames already submitted can still be taken.
+     */
+    void close();
+
+
+    /**
+     * @brief Reports whether `close()` was called.
+     *
+     * @return bool True once the queue is closed.
+     */
+    bool isClosed() const;
+
+
+    /**
+     * @brief Returns the frame counters gathered so far.
+     *
+     * @return Statistics Frames submitted, dropped and taken.
+     */
+    Statistics getStatistics() const;
+
+private:
+    /// Grids beyond the depth: one being drawn and one being shown.
+    static constexpr size_t SPARE_GRIDS = 2;
+
+    /// Slots of both rings; at least as many as there are grids, so neither ring can fill up.
+    static constexpr size_t RING_SIZE = 16;
+
+    static_assert(MAX_DEPTH + SPARE_GRIDS <= RING_SIZE, "FrameQueue rings must hold every grid");
+
+
+    /// Distance that keeps the indices of the submitted ring on different cache lines.
+    static constexpr size_t CACHE_LINE = 64;
+
+    const Policy policy;                            ///< Back-pressure policy.
+    const size_t gridCount;                         ///< Grids in the pool, the depth plus the spares.
+    std::array <Grid, RING_SIZE> grids;             ///< The pool; only the first `gridCount` are used.
+    SpscQueue <uint32_t, RING_SIZE> recycled;       ///< Grids the consumer gave back, oldest first.
+    std::atomic <uint32_t> recycledCount;           ///< Bumped after every recycle; a blocked producer waits on it.
+    std::atomic <bool> closed;                      ///< Set by `close()`.
+    std::atomic <size_t> submittedFrames;           ///< Counter for `getStatistics()`.
+    std::atomic <size_t> droppedFrames;             ///< Counter for `getStatistics()`.
+    std::atomic <size_t> takenFrames;               ///< Counter for `getStatistics()`.
+
+    // Submitted ring: the producer appends at `tail`; both sides remove at `head` with a compare-and-swap,
+    // the consumer to take a frame and the producer to drop the oldest one
+    alignas(CACHE_LINE) std::atomic <size_t> head;  ///< Oldest submitted frame not yet taken or dropped.
+    alignas(CACHE_LINE) std::atomic <size_t> tail;  ///< Next slot to submit into; written by the producer.
+    alignas(CACHE_LINE) std::array <std::atomic <uint32_t>, RING_SIZE> submitted;   ///< Pool indices of submitted frames.
+
+
+    /**
+     * @brief Removes the oldest submitted frame; safe from either side.
+     *
+     * @param index Receives the frame's pool index.
+     * @return bool False if no frame was waiting.
+     */
+    bool removeOldest(uint32_t & index);
+};
@@ -0,0 +1,62 @@
+/**
+ * @file FrameQueueSource.h
+ * @brief Defines a loop that displays frames other threads push through a FrameQueue.
+ */
+
+
+#pragma once
+
+
+#include "TerminalLoop.h"
+#include "FrameQueue.h"
+
+
+/**
+ * @class FrameQueueSource
+ * @brief Shows the newest frame a producer thread submitted, so rendering can live outside an `update()` override.
+ *
+ * Producers draw into grids from `getQueue()` at their own pace. Each frame
+ * the loop takes the newest submitted grid and swaps it with its active grid,
+ * so the frame is scaled and printed like any other effect without being
+ * copied, and the grid that was shown before goes back to the producer. When
+ * nothing new arrived the last frame stays on screen. The loop stops once the
+ * queue is closed and empty, and closes it on destruction so a producer
+ * waiting for a grid returns.
+ */
+class FrameQueueSource : public TerminalLoop
+{
+public:
+    /**
+     * @brief Constructs the loop and its queue.
+     *
+     * @param BackPressure What producers do when every grid is in use.
+     * @param Depth Frames that can wait for the loop.
+     * @param FrameRate Target frame rate for display. Defaults to 30.0 FPS.
+     * @param ScaleRatio Whether to maintain aspect ratio when scaling. Defaults to true.
+     */
+    FrameQueueSource(FrameQueue::Policy BackPressure = FrameQueue::Policy::DropOldest, size_t Depth = 2, double FrameRate = 30.0,
+                     bool ScaleRatio = true);
+
+
+    /**
+     * @brief Closes the queue.
+     */
+    ~FrameQueueSource();
+
+
+    /**
+     * @brief Returns the queue producers submit frames to.
+     *
+     * @return FrameQueue & The queue.
+     */
+    FrameQueue & getQueue();
+
+protected:
+    /**
+     * @brief Swaps the newest submitted frame into the grid, or stops once the queue is closed and empty.
+     */
+    void update() override;
+
+private:
+    FrameQueue queue;   ///< Frames from the producer.
+};
@@ -0,0 +1,156 @@
+/**
+ * @file FrameReader.h
+ * @brief Defines the FrameReader class for random access to recorded frame streams.
+ */
+
+
+#pragma once
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+#include "FrameRecording.h"
+
+
+/**
+ * @class FrameReader
+ * @brief Memory-maps a recording and decodes its frames.
+ *
+ * The file is mapped read-only, so decoding copies cells straight out of the
+ * page cache without any read() calls. Seeking binary-searches the keyframe
+ * index stored at the end of the recording (or rebuilt with a single header
+ * scan for recordings that were not closed cleanly) and then applies the
+ * deltas that follow the keyframe, so any frame is reached in O(log n) plus
+ * at most one keyframe interval of deltas.
+ */
+class FrameReader
+{
+public:
+    /**
+     * @brief Maps a recording and loads its keyframe index.
+     *
+     * @param path Path of the recording file.
+     *
+     * @throws std::runtime_error If the file cannot be mapped or is not a recording.
+     */
+    explicit FrameReader(const std::string & path);
+
+
+    /**
+     * @brief Unmaps the recording.
+     */
+    ~FrameReader();
+
+
+    FrameReader(const FrameReader &) = delete;
+    FrameReader & operator = (const FrameReader &) = delete;
+
+
+    /**
+     * @brief Returns the number of frames in the recording.
+     *
+     * @return uint32_t Frame count.
+     */
+    uint32_t getFrameCount() const;
+
+
+    /**
+     * @brief Decodes the frame following the current one.
+     *
+     * @return True if a frame was decoded, false at the end of the recording.
+     *
+     * @throws std::runtime_error If the recording is malformed.
+     */
+    bool next();
+
+
+    /**
+     * @brief Makes `frame` the current frame.
+     *
+     * @param frame Zero-based index of the frame to decode.
+     *
+     * @throws std::out_of_range If `frame` is not in the recording.
+     * @throws std::runtime_error If the recording is malformed.
+     */
+    void seek(uint32_t frame);
+
+
+    /**
+     * @brief Returns the index of the current frame.
+     *
+     * @return uint32_t Frame index; only meaningful after `next()` or `seek()` succeeded.
+     */
+    uint32_t getFrameIndex() const;
+
+
+    /**
+     * @brief Returns the timestamp of the current frame.
+     *
+     * @return uint64_t Microseconds since the recording started.
+     */
+    uint64_t getTimestamp() const;
+
+
+    /**
+     * @brief Returns the height of the current frame in cells.
+     */
+    size_t getHeight() const;
+
+
+    /**
+     * @brief Returns the width of the current frame in cells.
+     */
+    size_t getWidth() const;
+
+
+    /**
+     * @brief Returns the packed cells of the current frame in row-major order.
+     *
+     * @return const std::vector<FrameRecording::PackedCell>& The current frame.
+     */
+    const std::vector <FrameRecording::PackedCell> & getCells() const;
+
+
+    /**
+     * @brief Unpacks the current frame into a symbol grid.
+     *
+     * @param grid Destination grid, resized only when its size differs.
+     */
+    void toGrid(std::vector < std::vector < OneSymbol > > & grid) const;
+
+
+private:
+    int fd;                                                 ///< Descriptor of the mapped file.
+    const char * data;                                      ///< Start of the mapping.
+    size_t size;                                            ///< Size of the mapping.
+    size_t recordsEnd;                                      ///< Offset where frame records end.
+    size_t offset;                                          ///< Offset of the next record to decode.
+    uint32_t frameCount;                                    ///< Number of frames in the recording.
+    FrameRecording::RecordHeader current;                   ///< Header of the current frame.
+    bool hasCurrent;                                        ///< Whether a frame has been decoded.
+    std::vector <FrameRecording::KeyframeEntry> keyframes;  ///< Keyframe index sorted by frame.
+    std::vector <FrameRecording::PackedCell> cells;         ///< Contents of the current frame.
+    mutable FrameRecording::GlyphCache glyphCache;          ///< Glyphs `toGrid()` unpacked before.
+
+
+    /**
+     * @brief Copies a value out of the mapping, checking it lies before `limit`.
+     */
+    template <typename T>
+    T readValue(size_t at, size_t limit) const;
+
+
+    /**
+     * @brief Loads the index from the footer, or rebuilds it by scanning record headers.
+     */
+    void loadIndex();
+
+
+    /**
+     * @brief Decodes the record at `offset` and advances past it.
+     */
+    void decodeRecord();
+};
@@ -0,0 +1,146 @@
+/**
+ * @file FrameRecorder.h
+ * @brief Defines the FrameRecorder class that captures produced frames to disk.
+ */
+
+
+#pragma once
+
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+#include "FrameRecording.h"
+
+
+/**
+ * @class FrameRecorder
+ * @brief Records a stream of frames as keyframes plus per-frame cell deltas.
+ *
+ * Frames are packed and diffed on the calling thread into an in-memory chunk.
+ * Full chunks are handed to a background thread that writes them to the file,
+ * so the render loop never waits on disk unless the writer falls a whole chunk
+ * behind. Chunk buffers are swapped rather than reallocated, and the keyframe
+ * index is collected in a fixed block that is spilled to an anonymous memory
+ * file whenever it fills up, which keeps steady state recording free of heap
+ * allocations however many keyframes a recording has. The file layout is
+ * described in FrameRecording.h.
+ */
+class FrameRecorder
+{
+public:
+    /// Size at which the current chunk is handed to the writer thread.
+    static constexpr size_t CHUNK_BYTES = size_t(1) << 20;
+
+    /// Keyframe index entries kept in memory before they are spilled.
+    static constexpr size_t INDEX_BLOCK = 256;
+
+
+    /**
+     * @brief Creates the recording file and starts the writer thread.
+     *
+     * @param path Path of the recording file, truncated if it exists.
+     * @param KeyframeInterval Maximum number of frames between keyframes. Defaults to 300.
+     *
+     * @throws std::runtime_error If the file or the index spill file cannot be created.
+     */
+    explicit FrameRecorder(const std::string & path, uint32_t KeyframeInterval = 300);
+
+
+    /**
+     * @brief Flushes all pending frames, appends the keyframe index and closes the file.
+     */
+    ~FrameRecorder();
+
+
+    FrameRecorder(const FrameRecorder &) = delete;
+    FrameRecorder & operator = (const FrameRecorder &) = delete;
+
+
+    /**
+     * @brief Appends a frame to the recording.
+     *
+     * A keyframe is written for the first frame, after a size change, every
+     * `keyframeInterval` frames, and whenever more than half of the cells
+     * changed; otherwise only the changed cells are written.
+     *
+     * @param grid The frame to record.
+     *
+     * @throws std::runtime_error If the writer thread failed to write to the file.
+     */
+    void captureFrame(const std::vector < std::vector < OneSymbol > > & grid);
+
+
+    /**
+     * @brief Converts a recording into an asciicast v2 file.
+     *
+     * Each recorded frame becomes one output event that homes the cursor and
+     * repaints the full frame with truecolor escape sequences.
+     *
+     * @param recordingPath Path of the recording to read.
+     * @param castPath Path of the asciicast file to write.
+     *
+     * @throws std::runtime_error If a file cannot be opened or the recording is malformed.
+     */
+    static void exportAsciicast(const std::string & recordingPath, const std::string & castPath);
+
+
+private:
+    int fd;                                                     ///< Output file descriptor.
+    int indexFd;                                                ///< Anonymous memory file holding spilled keyframe index blocks.
+    uint32_t keyframeInterval;                                  ///< Maximum frames between keyframes.
+    uint32_t frameCount;                                        ///< Frames captured so far.
+    uint32_t framesSinceKeyframe;                               ///< Frames since the last keyframe.
+    uint64_t fileOffset;                                        ///< Bytes handed to the writer so far.
+    size_t height;                                              ///< Height of the previous frame.
+    size_t width;                                               ///< Width of the previous frame.
+    std::chrono::steady_clock::time_point startTime;            ///< Time of the first capture.
+
+    std::vector <FrameRecording::PackedCell> previousFrame;     ///< Packed contents of the previous frame.
+    std::vector <FrameRecording::PackedCell> currentFrame;      ///< Packed contents of the frame being captured.
+    std::vector <FrameRecording::DeltaEntry> deltas;            ///< Changed cells of the frame being captured.
+    std::array <FrameRecording::KeyframeEntry, INDEX_BLOCK> keyframes;  ///< Index entries not spilled yet.
+    size_t keyframeCount;                                       ///< Entries used in `keyframes`.
+    uint32_t spilledKeyframes;                                  ///< Entries written to `indexFd`.
+
+    std::vector <char> currentChunk;                            ///< Chunk being filled by the capturing thread.
+    std::vector <char> pendingChunk;                            ///< Chunk owned by the writer thread.
+    bool pendingFull;                                           ///< Whether `pendingChunk` waits to be written.
+    bool stopping;                                              ///< Whether the writer should exit once idle.
+    std::atomic <bool> writeFailed;                             ///< Set when a write to the file failed.
+    std::mutex mutex;                                           ///< Guards `pendingChunk`, `pendingFull` and `stopping`.
+    std::condition_variable condition;                          ///< Signals chunk hand-over in both directions.
+    std::thread writer;                                         ///< Background writer thread.
+
+
+    /**
+     * @brief Appends raw bytes to the current chunk.
+     */
+    void append(const void * data, size_t size);
+
+
+    /**
+     * @brief Writes the full index block to `indexFd` and empties it.
+     */
+    void spillKeyframes();
+
+
+    /**
+     * @brief Hands the current chunk to the writer thread, waiting if the previous one is still pending.
+     */
+    void submitChunk();
+
+
+    /**
+     * @brief Body of the writer thread.
+     */
+    void writerLoop();
+};
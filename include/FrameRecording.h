@@ -0,0 +1,175 @@
+/**
+ * @file FrameRecording.h
+ * @brief Defines the binary layout of recorded frame streams.
+ *
+ * A recording starts with a FileHeader and is followed by frame records.
+ * Every record begins with a RecordHeader; keyframes carry one PackedCell per
+ * cell, delta frames carry a DeltaEntry for each cell that changed since the
+ * previous frame. When the recording is closed cleanly an index of all
+ * keyframes and an IndexFooter are appended so readers can seek without
+ * scanning. All values are stored in host byte order.
+ */
+
+
+#pragma once
+
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+
+#include "OneSymbol.h"
+
+
+/**
+ * @namespace FrameRecording
+ * @brief Layout and helpers shared by frame recorders and readers.
+ */
+namespace FrameRecording
+{
+    inline constexpr char FILE_MAGIC[8] = {'T', 'F', 'R', 'E', 'C', '0', '0', '1'};   ///< Identifies a recording.
+    inline constexpr char INDEX_MAGIC[8] = {'T', 'F', 'I', 'D', 'X', '0', '0', '1'};  ///< Identifies the index footer.
+
+
+    /**
+     * @brief Kind of a frame record.
+     */
+    enum class RecordType : uint8_t
+    {
+        Keyframe = 0,   ///< Complete frame, one PackedCell per cell.
+        Delta = 1       ///< Changed cells relative to the previous frame.
+    };
+
+
+    /**
+     * @brief A cell with both colors packed as 0x00RRGGBB and its glyph bytes.
+     */
+    struct PackedCell
+    {
+        uint32_t foreground;    ///< Foreground color, 0x00RRGGBB.
+        uint32_t background;    ///< Background color, 0x00RRGGBB.
+        uint32_t glyph;         ///< UTF-8 bytes of the glyph, first byte in the lowest bits; 0 for GlyphTable::CONTINUATION.
+
+        bool operator == (const PackedCell & other) const = default;
+    };
+
+
+    /**
+     * @brief Header at the very start of a recording.
+     */
+    struct FileHeader
+    {
+        char magic[8];              ///< Always FILE_MAGIC.
+        uint32_t keyframeInterval;  ///< Maximum number of frames between keyframes.
+        uint32_t reserved;          ///< Zero.
+    };
+
+
+    /**
+     * @brief Header preceding every frame record.
+     */
+    struct RecordHeader
+    {
+        RecordType type;            ///< Keyframe or delta.
+        uint8_t reserved[3];        ///< Zero.
+        uint32_t frameIndex;        ///< Zero-based frame number.
+        uint64_t timestamp;         ///< Microseconds since the recording started.
+        uint16_t height;            ///< Frame height in cells.
+        uint16_t width;             ///< Frame width in cells.
+        uint32_t count;             ///< Number of PackedCell or DeltaEntry items that follow.
+    };
+
+
+    /**
+     * @brief A changed cell inside a delta record.
+     */
+    struct DeltaEntry
+    {
+        uint32_t index;             ///< Row-major cell index.
+        PackedCell cell;            ///< New cell contents.
+    };
+
+
+    /**
+     * @brief One entry of the keyframe index.
+     */
+    struct KeyframeEntry
+    {
+        uint32_t frameIndex;        ///< Frame number of the keyframe.
+        uint32_t reserved;          ///< Zero.
+        uint64_t offset;            ///< File offset of the keyframe's RecordHeader.
+        uint64_t timestamp;         ///< Timestamp of the keyframe.
+    };
+
+
+    /**
+     * @brief Trailer closing a cleanly finished recording.
+     */
+    struct IndexFooter
+    {
+        uint64_t indexOffset;       ///< File offset of the first KeyframeEntry.
+        uint32_t keyframeCount;     ///< Number of KeyframeEntry items.
+        uint32_t frameCount;        ///< Total number of frames in the recording.
+        char magic[8];              ///< Always INDEX_MAGIC.
+    };
+
+
+    /**
+     * @brief Packs a symbol into its on-disk representation.
+     *
+     * @param oneSymbol The symbol to pack.
+     * @return PackedCell The packed cell.
+     */
+    PackedCell packCell(const OneSymbol & oneSymbol);
+
+
+    /**
+     * @struct GlyphCache
+     * @brief Recently unpacked glyphs by their packed bytes, so replaying a frame does not intern every non-ASCII cell again.
+     *
+     * Direct-mapped: a glyph evicts whichever glyph shares its slot. Each
+     * reader keeps its own, so lookups need no lock.
+     */
+    struct GlyphCache
+    {
+        static constexpr size_t SIZE = 256;     ///< Number of slots.
+
+        std::array <uint32_t, SIZE> bytes{};    ///< Packed bytes of the glyph in each slot; 0 for an empty slot.
+        std::array <GlyphId, SIZE> ids{};       ///< Interned ID of the glyph in each slot.
+    };
+
+
+    /**
+     * @brief Restores a symbol from its on-disk representation.
+     *
+     * @param cell The packed cell.
+     * @return OneSymbol The unpacked symbol.
+     */
+    OneSymbol unpackCell(const PackedCell & cell);
+
+
+    /**
+     * @brief Restores a symbol, looking its glyph up in a cache before interning it.
+     *
+     * @param cell The packed cell.
+     * @param cache Glyphs unpacked before by the same reader.
+     * @return OneSymbol The unpacked symbol.
+     */
+    OneSymbol unpackCell(const PackedCell & cell, GlyphCache & cache);
+
+
+    /**
+     * @brief Unpacks a row-major array of cells into a symbol grid.
+     *
+     * The grid is resized to `height` x `width` only when its size differs.
+     *
+     * @param cells Packed cells, `height * width` of them.
+     * @param height Frame height.
+     * @param width Frame width.
+     * @param grid Destination grid.
+     * @param cache Glyphs unpacked before by the same reader.
+     */
+    void unpackFrame(const std::vector <PackedCell> & cells, size_t height, size_t width, std::vector < std::vector < OneSymbol > > & grid,
+                     GlyphCache & cache);
+}
@@ -0,0 +1,92 @@
+/**
+ * @file FrameReplay.h
+ * @brief Defines the FrameReplay class that plays recorded frame streams back.
+ */
+
+
+#pragma once
+
+
+#include <cstdint>
+#include <string>
+
+
+#include "FrameReader.h"
+#include "FrameEncoder.h"
+#include "FrameArena.h"
+
+
+/**
+ * @class FrameReplay
+ * @brief Streams a recording to the terminal or to a headless encoder.
+ *
+ * In terminal mode each decoded frame is scaled to the current terminal size
+ * and printed exactly like a live TerminalLoop frame. In headless mode frames
+ * are only encoded into the frame arena, which turns an as-fast-as-possible
+ * replay into a deterministic benchmark of decoding and encoding that does not
+ * depend on the cost of any effect's `update()`.
+ */
+class FrameReplay
+{
+public:
+    /**
+     * @brief Pacing of the replay.
+     */
+    enum class Timing
+    {
+        Original,           ///< Present frames at their recorded timestamps.
+        AsFastAsPossible    ///< Present frames back to back.
+    };
+
+
+    /**
+     * @brief Destination of the replayed frames.
+     */
+    enum class Output
+    {
+        Terminal,   ///< Scale and print frames to the terminal.
+        Headless    ///< Encode frames without writing them anywhere.
+    };
+
+
+    /**
+     * @brief Totals gathered while replaying.
+     */
+    struct Statistics
+    {
+        size_t frames;      ///< Number of frames presented.
+        size_t bytes;       ///< Number of encoded bytes produced.
+        double seconds;     ///< Wall-clock duration of the replay.
+    };
+
+
+    /**
+     * @brief Opens a recording for replay.
+     *
+     * @param path Path of the recording file.
+     *
+     * @throws std::runtime_error If the recording cannot be opened.
+     */
+    explicit FrameReplay(const std::string & path);
+
+
+    /**
+     * @brief Plays the recording from `firstFrame` to the end.
+     *
+     * In terminal mode pressing 'Q'/'q' stops the replay early.
+     *
+     * @param timing Pacing of the replay.
+     * @param output Destination of the frames.
+     * @param firstFrame Frame to start from. Defaults to the first frame.
+     * @return Statistics Totals of the replay.
+     *
+     * @throws std::out_of_range If `firstFrame` is not in the recording.
+     */
+    Statistics play(Timing timing, Output output, uint32_t firstFrame = 0);
+
+
+private:
+    FrameReader reader;     ///< Source of decoded frames.
+    FrameEncoder encoder;   ///< Encoder used in headless mode.
+    FrameArena arena;       ///< Per-frame memory for headless encoding.
+};
@@ -0,0 +1,60 @@
+/**
+ * @file GlyphRamp.h
+ * @brief Defines the GlyphRamp class mapping luminance to density glyphs.
+ */
+
+
+#pragma once
+
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+
+#include "GlyphTable.h"
+
+
+/**
+ * @class GlyphRamp
+ * @brief Precomputed 256-entry lookup table from luminance to a glyph.
+ *
+ * The ramp lists glyphs from the sparsest to the densest; every luminance value
+ * is assigned the glyph whose position in the ramp matches its brightness, so
+ * a lookup is a single table access per cell.
+ */
+class GlyphRamp
+{
+public:
+    /// Default ramp, from empty to fully covered.
+    static constexpr std::string_view DEFAULT_RAMP = " .:-=+*#%@";
+
+    /// Shade blocks, for terminals with a UTF-8 locale.
+    static constexpr std::string_view BLOCK_RAMP = " \u2591\u2592\u2593\u2588";
+
+
+    /**
+     * @brief Builds the lookup table for a ramp.
+     *
+     * @param Ramp UTF-8 glyphs of one column each, ordered from sparsest to densest; the default ramp when empty.
+     *
+     * @throws std::invalid_argument If a glyph of the ramp is two columns wide.
+     */
+    explicit GlyphRamp(std::string_view Ramp = DEFAULT_RAMP);
+
+
+    /**
+     * @brief Returns the glyph for a luminance value.
+     *
+     * @param luminance Luminance (0-255).
+     * @return GlyphId The glyph representing that luminance.
+     */
+    GlyphId getGlyph(uint8_t luminance) const
+    {
+        return table[luminance];
+    }
+
+
+private:
+    std::array <GlyphId, 256> table;   ///< Glyph for every luminance value.
+};
@@ -0,0 +1,144 @@
+/**
+ * @file GlyphTable.h
+ * @brief Defines GlyphId and the GlyphTable class that interns the glyphs cells refer to.
+ */
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+
+/// Compact handle of an interned glyph; ASCII characters are their own IDs.
+using GlyphId = uint16_t;
+
+
+/**
+ * @class GlyphTable
+ * @brief Process-wide table of interned glyphs with their UTF-8 bytes and display widths.
+ *
+ * A glyph is one user-perceived character: a code point plus any combining
+ * marks, variation selectors or zero-width-joined code points after it.
+ * Cells store only its GlyphId, so a cell stays as small as with a plain
+ * `char`, and the encoder copies the pre-encoded bytes of the entry instead
+ * of transcoding anything per cell.
+ *
+ * IDs 1-127 are the ASCII characters themselves, so `symbol = '#'` and
+ * `symbol == ' '` keep working. ID 0 is `CONTINUATION`, the right half of a
+ * double-width glyph: it prints nothing, and a cell holding a wide glyph
+ * must be followed by one so the row keeps its width, the same way terminals
+ * model wide characters. Other glyphs are numbered in the order they are
+ * first interned.
+ *
+ * Entries are never removed or moved, so `get()` needs no lock; `intern()`
+ * is thread-safe.
+ */
+class GlyphTable
+{
+public:
+    /// Longest UTF-8 sequence a glyph can have; longer clusters become `REPLACEMENT`.
+    static constexpr size_t MAX_GLYPH_BYTES = 14;
+
+    /// Number of distinct glyphs the table can hold.
+    static constexpr size_t CAPACITY = size_t(UINT16_MAX) + 1;
+
+    /// Right half of a double-width glyph; prints nothing.
+    static constexpr GlyphId CONTINUATION = 0;
+
+    /// U+FFFD, used for malformed input and when the table is full.
+    static constexpr GlyphId REPLACEMENT = 128;
+
+
+    /**
+     * @struct Glyph
+     * @brief An interned glyph, 16 bytes so a copy is two moves.
+     */
+    struct Glyph
+    {
+        char bytes[MAX_GLYPH_BYTES];    ///< UTF-8 bytes; unused bytes are zero.
+        uint8_t length;                 ///< Number of bytes used.
+        uint8_t width;                  ///< Columns the glyph covers: 0 for CONTINUATION, 1 or 2.
+    };
+
+
+    /**
+     * @brief Returns the entry of an interned glyph.
+     *
+     * @param id An ID returned by `intern()` or an ASCII character.
+     * @return const Glyph & The entry.
+     */
+    static const Glyph & get(GlyphId id)
+    {
+        return glyphs[id];
+    }
+
+
+    /**
+     * @brief Reports whether a glyph covers two columns, so its cell must be followed by `CONTINUATION`.
+     *
+     * @param id An ID returned by `intern()` or an ASCII character.
+     * @return bool True for double-width glyphs; ASCII is answered without a table lookup.
+     */
+    static bool isWide(GlyphId id)
+    {
+        return id > 127 && glyphs[id].width == 2;
+    }
+
+
+    /**
+     * @brief Interns one glyph given as UTF-8.
+     *
+     * @param utf8 The bytes of exactly one glyph.
+     * @return GlyphId The glyph's ID; `REPLACEMENT` if `utf8` is malformed or too long, a space if empty.
+     */
+    static GlyphId intern(std::string_view utf8);
+
+
+    /**
+     * @brief Interns a single code point.
+     *
+     * @param codePoint The code point; 0 gives `CONTINUATION`.
+     * @return GlyphId The glyph's ID.
+     */
+    static GlyphId intern(char32_t codePoint);
+
+
+    /**
+     * @brief Interns the glyph at the start of a UTF-8 text.
+     *
+     * @param text The text; must not be empty.
+     * @param id Receives the glyph's ID.
+     * @return size_t Bytes of `text` the glyph used.
+     */
+    static size_t next(std::string_view text, GlyphId & id);
+
+
+    /**
+     * @brief Returns the number of columns a code point covers: 0 for combining marks, 2 for wide characters, else 1.
+     *
+     * @param codePoint The code point.
+     * @return int Its width.
+     */
+    static int displayWidth(char32_t codePoint);
+
+
+    /**
+     * @brief Returns the number of interned glyphs, including the reserved ones.
+     *
+     * @return size_t The count.
+     */
+    static size_t size();
+
+private:
+    static Glyph glyphs[CAPACITY];  ///< Entries by ID; filled in order, never moved.
+    static const bool reserved;     ///< Set once CONTINUATION, ASCII and REPLACEMENT are filled in.
+
+
+    /**
+     * @brief Appends an entry; the caller holds the intern lock or runs before `main()`.
+     */
+    static GlyphId add(std::string_view bytes, uint8_t width);
+};
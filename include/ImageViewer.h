@@ -0,0 +1,45 @@
+/**
+ * @file ImageViewer.h
+ * @brief Defines a class for displaying a static image in the terminal.
+ */
+
+
+#pragma once
+
+
+#include <string>
+
+
+#include "TerminalLoop.h"
+
+
+/**
+ * @class ImageViewer
+ * @brief Displays a PPM, PGM or BMP image.
+ *
+ * The image file is memory-mapped and downscaled straight into the active grid
+ * while loading, so the full-resolution image never exists as OneSymbol cells.
+ * The active grid holds at most `DIMENSIONS` rows and `2 * DIMENSIONS` columns,
+ * keeping the image's aspect ratio for cells that are about twice as tall as wide.
+ */
+class ImageViewer : public TerminalLoop
+{
+public:
+    /**
+     * @brief Loads an image and displays it.
+     *
+     * @param path Path of the image file.
+     * @param LinearLight Whether the image is downscaled in linear light. Defaults to false.
+     * @param FrameRate Rate at which the image is rescaled to the terminal. Defaults to 10.0 FPS.
+     * @param ScaleRatio Whether to maintain aspect ratio when scaling. Defaults to false.
+     *
+     * @throws std::runtime_error If the image cannot be loaded.
+     */
+    ImageViewer(const std::string & path, bool LinearLight = false, double FrameRate = 10.0, bool ScaleRatio = false);
+
+protected:
+    /**
+     * @brief Leaves the image unchanged; rendering keeps it fitted to the terminal.
+     */
+    void update() override;
+};
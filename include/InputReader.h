@@ -0,0 +1,206 @@
+/**
+ * @file InputReader.h
+ * @brief Defines the InputReader class that decodes terminal input on its own thread.
+ */
+
+
+#pragma once
+
+
+#include <chrono>
+#include <cstdint>
+#include <signal.h>
+#include <string_view>
+#include <thread>
+
+
+#include "SpscQueue.h"
+
+
+/**
+ * @struct InputEvent
+ * @brief A decoded key press, mouse report or signal.
+ */
+struct InputEvent
+{
+    /**
+     * @brief Kind of event.
+     */
+    enum class Type : uint8_t
+    {
+        Key,        ///< A key press; see `key` and `modifiers`.
+        Mouse,      ///< An SGR mouse report; see `button`, `pressed`, `row` and `col`.
+        Resize,     ///< The terminal window changed size (SIGWINCH).
+        Interrupt   ///< SIGINT or SIGTERM; the program should end.
+    };
+
+
+    /**
+     * @brief Codes of keys without a character; characters use their Unicode code point.
+     */
+    enum Key : uint32_t
+    {
+        TAB = 9,
+        ENTER = 13,
+        ESCAPE = 27,
+        BACKSPACE = 127,
+        UP = 0x110000,
+        DOWN,
+        RIGHT,
+        LEFT,
+        HOME,
+        END,
+        INSERT,
+        DELETE,
+        PAGE_UP,
+        PAGE_DOWN,
+        F1,
+        F2,
+        F3,
+        F4,
+        F5,
+        F6,
+        F7,
+        F8,
+        F9,
+        F10,
+        F11,
+        F12
+    };
+
+
+    /// Modifier bits of keys and mouse reports.
+    static constexpr uint8_t SHIFT = 1, ALT = 2, CONTROL = 4;
+
+
+    Type type = Type::Key;  ///< Kind of event.
+    uint32_t key = 0;       ///< Code point or `Key` code of a key press.
+    uint8_t modifiers = 0;  ///< `SHIFT`, `ALT` and `CONTROL` bits.
+    uint8_t button = 0;     ///< Mouse button: 0-2 left/middle/right, 64/65 wheel up/down; +32 while dragging.
+    bool pressed = false;   ///< Whether the mouse button went down rather than up.
+    uint16_t row = 0;       ///< 0-based row of a mouse report.
+    uint16_t col = 0;       ///< 0-based column of a mouse report.
+};
+
+
+/**
+ * @class InputReader
+ * @brief Reads and decodes terminal input on a dedicated thread.
+ *
+ * The thread blocks in `poll()` on the input descriptor, a signalfd for
+ * SIGWINCH, SIGINT and SIGTERM, and an eventfd used to stop it. Bytes are
+ * decoded into keys, including CSI and SS3 escape sequences for cursor and
+ * function keys and SGR mouse reports, and handed to the consumer through
+ * a lock-free SpscQueue. DCS, OSC and APC strings, which only terminals
+ * answering a query send, are dropped. The consumer is woken through a
+ * second eventfd, so it can sleep until the next event or a deadline,
+ * whichever comes first.
+ *
+ * Signals are only delivered through the signalfd if no thread has them
+ * unblocked, so they are blocked from construction to destruction; threads
+ * created in between inherit the blocked mask. Helper threads that may
+ * start before a reader exists, such as a recorder's writer, block
+ * every signal themselves with `blockSignals()`.
+ */
+class InputReader
+{
+public:
+    /**
+     * @brief Blocks the handled signals and creates the descriptors.
+     *
+     * @throws std::runtime_error If the descriptors cannot be created.
+     */
+    InputReader();
+
+
+    /**
+     * @brief Stops the thread and restores the signal mask.
+     */
+    ~InputReader();
+
+
+    InputReader(const InputReader &) = delete;
+    InputReader & operator = (const InputReader &) = delete;
+
+
+    /**
+     * @brief Starts the reader thread.
+     *
+     * @param Descriptor Descriptor to read input from, or -1 to watch signals only.
+     */
+    void start(int Descriptor);
+
+
+    /**
+     * @brief Stops the reader thread; events not yet popped are kept.
+     */
+    void stop();
+
+
+    /**
+     * @brief Takes the oldest pending event.
+     *
+     * @param event Receives the event.
+     * @return bool False if no event is pending.
+     */
+    bool poll(InputEvent & event);
+
+
+    /**
+     * @brief Sleeps until an event is pending or the timeout passes.
+     *
+     * @param timeout Longest time to sleep.
+     * @return bool Whether an event is pending.
+     */
+    bool wait(std::chrono::milliseconds timeout);
+
+
+    /**
+     * @brief Enables or disables mouse reporting (button events, SGR encoding).
+     *
+     * @param enabled Whether the terminal should report mouse buttons and the wheel.
+     */
+    void setMouseTracking(bool enabled);
+
+
+    /**
+     * @brief Decodes one event from the start of `bytes`.
+     *
+     * @param bytes Input bytes.
+     * @param event Receives the event; key 0, which is not delivered, for sequences that carry no key.
+     * @param final Whether no more bytes are coming soon, so a lone ESC is the Escape key.
+     * @return size_t Bytes consumed; 0 if `bytes` holds only the start of a sequence.
+     */
+    static size_t decode(std::string_view bytes, InputEvent & event, bool final);
+
+
+    /**
+     * @brief Blocks every signal in the calling thread, so a helper thread never takes one meant for the signalfd.
+     */
+    static void blockSignals();
+
+private:
+    /// Time after a lone ESC byte before it counts as the Escape key rather than the start of a sequence.
+    static constexpr int ESCAPE_TIMEOUT_MILLISECONDS = 25;
+
+    int descriptor;                             ///< Input descriptor, -1 for none.
+    int signalDescriptor;                       ///< signalfd for the handled signals.
+    int stopDescriptor;                         ///< eventfd that wakes the thread to stop.
+    int readyDescriptor;                        ///< eventfd the thread signals after pushing events.
+    sigset_t previousMask;                      ///< Signal mask restored on destruction.
+    bool mouseTracking;                         ///< Whether mouse reporting is enabled.
+    SpscQueue <InputEvent, 256> events;         ///< Decoded events, from the thread to the loop.
+    std::thread thread;                         ///< The reader thread.
+
+
+    /**
+     * @brief Body of the reader thread.
+     */
+    void readerLoop();
+
+
+    /**
+     * @brief Queues an event and wakes the consumer; the event is dropped if the queue is full.
+     */
+    void publish(const InputEvent & event);
+};
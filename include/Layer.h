@@ -0,0 +1,242 @@
+/**
+ * @file Layer.h
+ * @brief Defines the Layer class, one plane of a Compositor stack.
+ */
+
+
+#pragma once
+
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+
+#include "OneSymbol.h"
+
+
+/**
+ * @class Layer
+ * @brief A grid of symbols with per-cell coverage, an opacity, a z-order and per-tile dirty state.
+ *
+ * Cells start out transparent. Writing a cell makes it opaque and marks the
+ * tile that contains it as dirty, so the Compositor only recomposes the parts
+ * of the screen that changed since the last composite. Changing the opacity,
+ * z-order or visibility dirties the whole layer.
+ */
+class Layer
+{
+public:
+    /// Height of a dirty-tracking tile in cells.
+    static constexpr size_t TILE_ROWS = 8;
+
+    /// Width of a dirty-tracking tile in cells.
+    static constexpr size_t TILE_COLS = 16;
+
+
+    /**
+     * @brief Constructs a fully transparent layer.
+     *
+     * @param Height Height of the layer in cells.
+     * @param Width Width of the layer in cells.
+     * @param ZOrder Stacking position; higher layers are drawn on top.
+     * @param Opacity Opacity of the whole layer (0.0 - 1.0).
+     */
+    Layer(size_t Height, size_t Width, int ZOrder = 0, double Opacity = 1.0);
+
+
+    /**
+     * @brief Resizes the layer, keeping the overlapping cells, and dirties it.
+     *
+     * @param newHeight New height in cells.
+     * @param newWidth New width in cells.
+     */
+    void resize(size_t newHeight, size_t newWidth);
+
+
+    /**
+     * @brief Writes one opaque cell.
+     *
+     * Writes outside the layer are ignored.
+     *
+     * @param row Row of the cell.
+     * @param col Column of the cell.
+     * @param oneSymbol The symbol to store.
+     */
+    void setSymbol(size_t row, size_t col, const OneSymbol & oneSymbol);
+
+
+    /**
+     * @brief Writes a line of text as opaque cells, clipped to the layer.
+     *
+     * @param row Row of the text.
+     * @param col Column of the first character.
+     * @param text The text to write, in UTF-8; wide glyphs take two cells.
+     * @param foregroundColor Text color.
+     * @param backgroundColor Background color behind the text.
+     */
+    void setText(size_t row, size_t col, std::string_view text, const Color & foregroundColor, const Color & backgroundColor);
+
+
+    /**
+     * @brief Makes one cell transparent.
+     *
+     * @param row Row of the cell.
+     * @param col Column of the cell.
+     */
+    void clearSymbol(size_t row, size_t col);
+
+
+    /**
+     * @brief Makes every cell transparent.
+     */
+    void clear();
+
+
+    /**
+     * @brief Sets every cell to the same opaque symbol.
+     *
+     * @param oneSymbol The symbol to store.
+     */
+    void fill(const OneSymbol & oneSymbol);
+
+
+    /**
+     * @brief Gives direct access to the cells for effects that rewrite the whole layer.
+     *
+     * The whole layer is marked dirty and every cell becomes opaque.
+     *
+     * @return std::vector<std::vector<OneSymbol>>& The layer cells.
+     */
+    std::vector < std::vector < OneSymbol > > & getGrid();
+
+
+    /**
+     * @brief Marks a rectangle of cells as changed, e.g. after writing through `getGrid()` elsewhere.
+     *
+     * @param row First row of the rectangle.
+     * @param col First column of the rectangle.
+     * @param rows Height of the rectangle.
+     * @param cols Width of the rectangle.
+     */
+    void markDirty(size_t row, size_t col, size_t rows, size_t cols);
+
+
+    /**
+     * @brief Sets the opacity of the whole layer and dirties it.
+     *
+     * @param newOpacity Opacity (0.0 - 1.0).
+     */
+    void setOpacity(double newOpacity);
+
+
+    /**
+     * @brief Returns the opacity of the whole layer.
+     *
+     * @return double Opacity (0.0 - 1.0).
+     */
+    double getOpacity() const;
+
+
+    /**
+     * @brief Moves the layer in the stack and dirties it.
+     *
+     * @param newZOrder Stacking position; higher layers are drawn on top.
+     */
+    void setZOrder(int newZOrder);
+
+
+    /**
+     * @brief Returns the stacking position.
+     *
+     * @return int Stacking position.
+     */
+    int getZOrder() const;
+
+
+    /**
+     * @brief Shows or hides the layer and dirties it.
+     *
+     * @param newVisible Whether the layer is drawn.
+     */
+    void setVisible(bool newVisible);
+
+
+    /**
+     * @brief Checks whether the layer is shown.
+     *
+     * @return True if the layer is drawn.
+     */
+    bool isVisible() const;
+
+
+    /**
+     * @brief Returns the height of the layer.
+     *
+     * @return size_t Height in cells.
+     */
+    size_t getHeight() const;
+
+
+    /**
+     * @brief Returns the width of the layer.
+     *
+     * @return size_t Width in cells.
+     */
+    size_t getWidth() const;
+
+
+    /**
+     * @brief Checks whether the layer contributes to the composite at all.
+     *
+     * @return True if the layer is visible with a non-zero opacity.
+     */
+    bool isDrawn() const;
+
+
+    /**
+     * @brief Checks whether the layer hides everything below it.
+     *
+     * @return True if the layer is drawn at full opacity and has no transparent cells.
+     */
+    bool isOpaque() const;
+
+private:
+    friend class Compositor;
+
+    std::vector < std::vector < OneSymbol > > grid;     ///< Layer cells.
+    std::vector <uint8_t> coverage;     ///< Per-cell coverage, row-major: 0 transparent, 255 opaque.
+    std::vector <uint8_t> dirtyTiles;   ///< Per-tile dirty flags, row-major.
+    size_t height;                      ///< Height in cells.
+    size_t width;                       ///< Width in cells.
+    size_t tileCols;                    ///< Number of tile columns.
+    size_t transparentCells;            ///< Number of cells with zero coverage.
+    double opacity;                     ///< Opacity of the whole layer.
+    int zOrder;                         ///< Stacking position.
+    bool visible;                       ///< Whether the layer is drawn.
+    bool dirty;                         ///< Whether any tile is dirty.
+
+
+    /**
+     * @brief Marks the tile containing a cell as dirty.
+     */
+    void markCell(size_t row, size_t col);
+
+
+    /**
+     * @brief Marks every tile as dirty.
+     */
+    void markAll();
+
+
+    /**
+     * @brief Clears every dirty flag after a composite.
+     */
+    void markClean();
+
+
+    /**
+     * @brief Sets the coverage of one cell and keeps `transparentCells` in sync.
+     */
+    void setCoverage(size_t row, size_t col, uint8_t value);
+};
@@ -0,0 +1,57 @@
+/**
+ * @file LayeredOverlay.h
+ * @brief Defines a demo that stacks a sprite and a status line over an animated background.
+ */
+
+
+#pragma once
+
+
+#include "TerminalLoop.h"
+#include "Compositor.h"
+
+
+/**
+ * @class LayeredOverlay
+ * @brief Composes a background, a translucent sprite and a HUD with the Compositor.
+ *
+ * The background bands scroll only every few frames, the sprite moves every
+ * frame and the HUD text changes every frame, so most frames recompose just the
+ * tiles under the sprite and the status line. The stack is sized to the
+ * terminal so the status line is never resampled.
+ */
+class LayeredOverlay : public TerminalLoop
+{
+public:
+    /**
+     * @brief Constructs the layered demo.
+     *
+     * @param FrameRate Target frame rate for animation. Defaults to 30.0 FPS.
+     * @param ScaleRatio Whether to maintain aspect ratio when scaling. Defaults to false.
+     */
+    LayeredOverlay(double FrameRate = 30.0, bool ScaleRatio = false);
+
+protected:
+    /**
+     * @brief Advances the layers and composes the dirty tiles into the active grid.
+     */
+    void update() override;
+
+private:
+    Compositor compositor;  ///< Owns the layer stack.
+    Layer & background;     ///< Scrolling color bands, fully opaque.
+    Layer & sprite;         ///< Translucent bouncing block.
+    Layer & hud;            ///< Status line on top.
+    size_t frame;           ///< Number of updates so far.
+    size_t spriteRow;       ///< Top row of the sprite.
+    size_t spriteCol;       ///< Left column of the sprite.
+    int rowStep;            ///< Vertical sprite velocity.
+    int colStep;            ///< Horizontal sprite velocity.
+    size_t composedTiles;   ///< Tiles recomposed by the last update.
+
+
+    /**
+     * @brief Redraws the background bands shifted by the current frame.
+     */
+    void drawBackground();
+};
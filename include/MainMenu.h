@@ -10,10 +10,17 @@
 #include <vector>
 #include <functional>
 #include <iostream>
+#include <string>
+#include <string_view>
 
 
 #include "RandomColors.h"
 #include "GrayScaleGradient.h"
+#include "LayeredOverlay.h"
+#include "SceneManager.h"
+#include "WidgetSwarm.h"
+#include "TiledLayout.h"
+#include "FrameQueueSource.h"
 #include "OneSymbol.h"
 
 
@@ -41,14 +48,16 @@ void displayMenu(const std::vector <MenuOption> & options);
  *
  * This function keeps displaying the menu and processing user input
  * until the user chooses to exit.
+ *
+ * @param options Options applied to every selected effect.
  */
-void runMainMenu();
+void runMainMenu(const LoopOptions & options = LoopOptions());
 
 
 /**
  * @brief Converts a std::string to a std::vector<OneSymbol> with specified colors.
  *
- * @param text The string to convert.
+ * @param text The string to convert, in UTF-8; wide glyphs are followed by a GlyphTable::CONTINUATION cell.
  * @param fgColor The foreground color to apply to each character.
  * @param bgColor The background color to apply to each character.
  * @return std::vector<OneSymbol> The vector containing colored symbols.
@@ -56,6 +65,20 @@ void runMainMenu();
 std::vector <OneSymbol> stringToOneSymbolVector(const std::string & text, const Color & fgColor, const Color & bgColor);
 
 
+/**
+ * @brief Converts text into an existing std::vector<OneSymbol> with specified colors.
+ *
+ * The vector is cleared and refilled, reusing its capacity, so repeated calls
+ * with text of similar length do not allocate.
+ *
+ * @param text The text to convert, in UTF-8.
+ * @param fgColor The foreground color to apply to each character.
+ * @param bgColor The background color to apply to each character.
+ * @param result The vector receiving the colored symbols.
+ */
+void stringToOneSymbolVector(std::string_view text, const Color & fgColor, const Color & bgColor, std::vector <OneSymbol> & result);
+
+
 /**
  * @brief Overloads the stream operator to print a vector of OneSymbol.
  *
@@ -0,0 +1,72 @@
+/**
+ * @file MappedImage.h
+ * @brief Defines the MappedImage class that exposes an image file's pixels in place.
+ */
+
+
+#pragma once
+
+
+#include <string>
+
+
+#include "PixelView.h"
+
+
+/**
+ * @class MappedImage
+ * @brief Memory-maps a PPM, PGM or BMP file and describes its pixels without decoding them.
+ *
+ * Only the header is parsed; the pixel payload stays in the mapping and is
+ * sampled directly through the PixelView, so loading a large image costs page
+ * cache rather than heap. Supported formats are binary PGM (P5) and PPM (P6)
+ * with 8-bit samples, and uncompressed 24/32-bit BMP, top-down or bottom-up.
+ */
+class MappedImage
+{
+public:
+    /**
+     * @brief Maps an image file and parses its header.
+     *
+     * @param path Path of the image.
+     *
+     * @throws std::runtime_error If the file cannot be mapped or its format is unsupported.
+     */
+    explicit MappedImage(const std::string & path);
+
+
+    /**
+     * @brief Unmaps the image.
+     */
+    ~MappedImage();
+
+
+    MappedImage(const MappedImage &) = delete;
+    MappedImage & operator = (const MappedImage &) = delete;
+
+
+    /**
+     * @brief Returns a view of the image pixels, valid while the MappedImage lives.
+     *
+     * @return const PixelView& The pixel view.
+     */
+    const PixelView & getView() const;
+
+
+private:
+    const uint8_t * data;   ///< Start of the mapping.
+    size_t size;            ///< Size of the mapping.
+    PixelView view;         ///< Pixels inside the mapping.
+
+
+    /**
+     * @brief Parses a binary PGM/PPM header and sets up `view`.
+     */
+    void parseNetpbm();
+
+
+    /**
+     * @brief Parses a BMP header and sets up `view`.
+     */
+    void parseBitmap();
+};
@@ -2,8 +2,8 @@
  * @file OneSymbol.h
  * @brief Defines the OneSymbol class for handling symbols with colors.
  *
- * The OneSymbol class represents a Unicode character with associated
- * foreground and background colors. It provides constructors for
+ * The OneSymbol class represents a Unicode character, stored as the ID of
+ * an interned glyph, with associated foreground and background colors. It provides constructors for
  * initialization and a method to invert colors. The class also supports
  * output streaming for easy visualization.
  */
@@ -16,6 +16,7 @@
 
 
 #include "Color.h"
+#include "GlyphTable.h"
 
 
 /**
@@ -40,11 +41,11 @@ public:
      * This constructor initializes the symbol with a Unicode character and sets the foreground and background
      * colors for the symbol.
      *
-     * @param Symbol The Unicode character to represent.
+     * @param Symbol The glyph to represent; an ASCII character or an ID from GlyphTable::intern().
      * @param ForegroundColor The foreground color of the symbol.
      * @param BackgroundColor The background color of the symbol.
      */
-    OneSymbol(const char Symbol, const Color & ForegroundColor, const Color & BackgroundColor);
+    OneSymbol(const GlyphId Symbol, const Color & ForegroundColor, const Color & BackgroundColor);
 
 
     /**
@@ -91,7 +92,7 @@ public:
      */
     std::string toString() const;
 
-    char symbol;                  ///< The character symbol represented by the OneSymbol object.
+    GlyphId symbol;               ///< The glyph represented by the OneSymbol object.
     Color foregroundColor;        ///< The foreground color of the symbol.
     Color backgroundColor;        ///< The background color of the symbol.
 };
@@ -0,0 +1,50 @@
+/**
+ * @file PixelView.h
+ * @brief Defines a non-owning view of 8-bit image pixels.
+ */
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+#include "Color.h"
+
+
+/**
+ * @struct PixelView
+ * @brief Describes pixels stored somewhere else, e.g. in a memory-mapped file.
+ *
+ * Rows may be padded and may run bottom-up (negative `rowStride`), which lets
+ * the view describe PPM, PGM and BMP payloads in place without copying them.
+ */
+struct PixelView
+{
+    const uint8_t * data;   ///< First byte of the top image row.
+    size_t width;           ///< Width in pixels.
+    size_t height;          ///< Height in pixels.
+    size_t channels;        ///< Bytes per pixel: 1 (gray), 3 or 4.
+    ptrdiff_t rowStride;    ///< Byte distance from one image row to the next one down.
+    bool bgr;               ///< Whether color channels are stored blue first.
+
+
+    /**
+     * @brief Returns the color of a pixel.
+     *
+     * @param row Row index, 0 being the top row.
+     * @param col Column index.
+     * @return Color The pixel color; gray pixels are expanded to all channels.
+     */
+    Color getColor(size_t row, size_t col) const
+    {
+        const uint8_t * pixel = data + ptrdiff_t(row) * rowStride + ptrdiff_t(col * channels);
+        if (channels < 3)
+            return Color(pixel[0], pixel[0], pixel[0]);
+        if (bgr)
+            return Color(pixel[2], pixel[1], pixel[0]);
+        return Color(pixel[0], pixel[1], pixel[2]);
+    }
+};
@@ -0,0 +1,118 @@
+/**
+ * @file Resampler.h
+ * @brief Defines the Resampler class, a separable image resampler with selectable filters.
+ */
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+
+#include "FrameArena.h"
+
+
+/**
+ * @class Resampler
+ * @brief Resizes planar color images with nearest, bilinear or Lanczos-3 kernels.
+ *
+ * Each axis has a fixed number of taps per target cell, and the weights of
+ * both axes are kept between calls and only rebuilt when the sizes or the
+ * scale change. Rows are filtered first, as a weighted sum of whole source
+ * rows, and then columns; both passes run over contiguous memory so the
+ * innermost loops vectorize. When shrinking, the kernels are widened by the
+ * scale so every source cell still contributes.
+ */
+class Resampler
+{
+public:
+    /**
+     * @brief The resampling kernel.
+     */
+    enum class Filter
+    {
+        Area,       ///< Box average of the covered cells; handled by the area scaler, not by Resampler.
+        Nearest,    ///< The source cell under the target cell's center; the fastest.
+        Bilinear,   ///< Triangle kernel of radius 1.
+        Lanczos3    ///< Windowed sinc of radius 3; the sharpest, may ring at hard edges.
+    };
+
+
+    /**
+     * @brief Looks up a filter by its command-line name.
+     *
+     * @param name One of `area`, `nearest`, `bilinear` or `lanczos`.
+     * @return Filter The filter.
+     *
+     * @throws std::invalid_argument If the name is unknown.
+     */
+    static Filter parseFilter(std::string_view name);
+
+
+    /**
+     * @brief Selects the kernel used by `resample()`.
+     *
+     * @param newFilter The filter; `Filter::Area` is accepted but not resampled here.
+     */
+    void setFilter(Filter newFilter);
+
+
+    /**
+     * @brief Returns the selected kernel.
+     *
+     * @return Filter The filter.
+     */
+    Filter getFilter() const;
+
+
+    /**
+     * @brief Resamples three planes of `sourceHeight` x `sourceWidth` values into three planes of the target size.
+     *
+     * Target cells whose center lies outside the source are set to 0.
+     *
+     * @param source Planes of the source, one after the other.
+     * @param sourceHeight Number of source rows.
+     * @param sourceWidth Number of source columns.
+     * @param target Planes receiving the result, one after the other.
+     * @param targetHeight Number of target rows.
+     * @param targetWidth Number of target columns.
+     * @param rowScale Source rows per target row.
+     * @param colScale Source columns per target column.
+     * @param arena Arena providing the intermediate planes.
+     */
+    void resample(const float * source, size_t sourceHeight, size_t sourceWidth,
+                  float * target, size_t targetHeight, size_t targetWidth,
+                  double rowScale, double colScale, FrameArena & arena);
+
+private:
+    /**
+     * @brief Taps and weights of every target cell along one axis.
+     *
+     * Target cell `t` samples source cells `first[t]` to `first[t] + taps - 1`
+     * with weights `weight[t * taps]` onwards; unused taps weigh 0.
+     */
+    struct Kernel
+    {
+        size_t targetSize = 0;          ///< Number of target cells the kernel was built for.
+        size_t sourceSize = 0;          ///< Number of source cells the kernel was built for.
+        double scale = 0.0;             ///< Source cells per target cell the kernel was built for.
+        Filter filter = Filter::Area;   ///< Filter the kernel was built for.
+        size_t taps = 0;                ///< Taps per target cell.
+        std::vector <size_t> first;     ///< First source cell of every target cell.
+        std::vector <float> weight;     ///< Normalized weights, `taps` per target cell.
+    };
+
+
+    Filter filter = Filter::Area;   ///< Selected kernel.
+    Kernel rowKernel;               ///< Cached vertical weights.
+    Kernel columnKernel;            ///< Cached horizontal weights.
+
+
+    /**
+     * @brief Rebuilds a kernel unless it already matches the sizes, scale and filter.
+     */
+    void updateKernel(Kernel & kernel, size_t targetSize, size_t sourceSize, double scale) const;
+};
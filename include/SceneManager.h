@@ -0,0 +1,98 @@
+/**
+ * @file SceneManager.h
+ * @brief Defines the SceneManager class that switches between loops with crossfades.
+ */
+
+
+#pragma once
+
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+
+#include "TerminalLoop.h"
+
+
+/**
+ * @class SceneManager
+ * @brief Runs several TerminalLoop scenes on one terminal and crossfades between them.
+ *
+ * Running scenes one after another through their own `run()` tears down
+ * each one's TerminalControl, which restores the terminal settings and
+ * clears the screen, then sets everything up again for the next scene. The
+ * manager instead owns the only printing loop: scenes are created while its
+ * TerminalControl is alive, so theirs leave the terminal alone, and are
+ * driven through `renderOffscreen()`. During a switch both the outgoing and
+ * the incoming scene keep running into their own grids, and the printed
+ * frame is the outgoing one faded into the incoming one with
+ * `TerminalEffects::crossfadeRow()` over a fixed number of frames.
+ *
+ * Digits switch to that scene, Tab and the right arrow to the next one and
+ * the left arrow to the previous one; scenes can also advance on their own.
+ */
+class SceneManager : public TerminalLoop
+{
+public:
+    /// Creates a scene; called each time the scene is switched to.
+    using Factory = std::function <std::unique_ptr <TerminalLoop>()>;
+
+
+    /**
+     * @brief Constructs a manager without scenes.
+     *
+     * @param SceneOptions Options whose scaling settings every scene gets; the rest applies through `configure()`.
+     * @param TransitionFrames Frames a crossfade lasts; 0 switches at once.
+     * @param AutoAdvanceFrames Frames after which the next scene fades in on its own; 0 never.
+     * @param FrameRate Target frame rate (FPS).
+     */
+    SceneManager(const LoopOptions & SceneOptions, size_t TransitionFrames = 30, size_t AutoAdvanceFrames = 0, double FrameRate = 30.0);
+
+
+    /**
+     * @brief Appends a scene; the first one added is shown first.
+     *
+     * @param factory Creates the scene.
+     */
+    void addScene(Factory factory);
+
+
+    /**
+     * @brief Starts a crossfade to a scene; during a crossfade, the scene being left is dropped.
+     *
+     * @param index Index of the scene, in the order they were added.
+     * @throws std::out_of_range If there is no such scene.
+     */
+    void switchTo(size_t index);
+
+protected:
+    /**
+     * @brief Advances to the next scene once the current one has been shown long enough.
+     */
+    void update() override;
+
+
+    /**
+     * @brief Renders the current scene, and the outgoing one during a crossfade, into the printed grid.
+     */
+    void compose() override;
+
+
+    /**
+     * @brief Switches scenes on digits, Tab and the arrow keys; everything else as usual.
+     */
+    void handleInput(const InputEvent & event) override;
+
+private:
+    LoopOptions sceneOptions;                   ///< Scaling options applied to every new scene.
+    std::vector <Factory> factories;            ///< Scene factories by index.
+    std::unique_ptr <TerminalLoop> current;     ///< Scene being shown or faded in.
+    std::unique_ptr <TerminalLoop> outgoing;    ///< Scene being faded out, null outside crossfades.
+    size_t currentIndex;                        ///< Index of `current`.
+    size_t currentFrame;                        ///< Frames rendered by `current`.
+    size_t outgoingFrame;                       ///< Frames rendered by `outgoing`.
+    size_t transitionFrames;                    ///< Length of a crossfade.
+    size_t transitionFrame;                     ///< Frames of the running crossfade shown so far.
+    size_t autoAdvanceFrames;                   ///< Frames each scene is shown before the next, 0 for never.
+};
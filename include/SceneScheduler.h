@@ -0,0 +1,274 @@
+/**
+ * @file SceneScheduler.h
+ * @brief Defines the SceneTask coroutine type and the SceneScheduler that resumes scene coroutines every frame.
+ */
+
+
+#pragma once
+
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <vector>
+
+
+#include "InputReader.h"
+
+
+class SceneScheduler;
+
+
+/**
+ * @class SceneTask
+ * @brief A scene coroutine: a multi-phase animation written as straight-line code.
+ *
+ * Instead of a state machine advanced by `update()`, a task suspends until
+ * the next frame, a number of frames, an amount of time or an input event:
+ *
+ *     SceneTask blink(Widget & widget)
+ *     {
+ *         while (true)
+ *         {
+ *             widget.visible = !widget.visible;
+ *             co_await SceneTask::seconds(0.5);
+ *         }
+ *     }
+ *
+ * A task does nothing until it is handed to `SceneScheduler::spawn()`, which
+ * owns it from then on. Coroutine frames come from per-thread free lists of
+ * fixed size classes instead of the heap, so once a task of a given size has
+ * finished, spawning another one of that size does not allocate. A frame goes
+ * back to the list of the thread that destroys the task, so tasks must be
+ * spawned and destroyed on the same thread for their frames to be reused; a
+ * thread's lists are freed when it ends.
+ */
+class SceneTask
+{
+public:
+    /**
+     * @brief What a suspended task waits for.
+     */
+    enum class Wait
+    {
+        Frame,  ///< A frame number, see `nextFrame()` and `frames()`.
+        Time,   ///< A scheduler time, see `seconds()`.
+        Input   ///< The next input event, see `input()`.
+    };
+
+
+    /**
+     * @brief Coroutine promise: the wait condition and where the frame memory comes from.
+     */
+    struct promise_type
+    {
+        SceneScheduler * scheduler = nullptr;   ///< Scheduler running the task, set by `spawn()`.
+        Wait wait = Wait::Frame;                ///< What the task waits for.
+        size_t resumeFrame = 0;                 ///< Frame to resume at when waiting for a frame.
+        double resumeTime = 0.0;                ///< Time to resume at when waiting for time.
+        InputEvent event;                       ///< Event handed to a task waiting for input.
+        std::exception_ptr exception;           ///< Exception that ended the task, rethrown by the scheduler.
+
+
+        SceneTask get_return_object()
+        {
+            return SceneTask(std::coroutine_handle <promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { exception = std::current_exception(); }
+
+
+        /**
+         * @brief Takes a coroutine frame from the free list of its size class, or the heap if it is empty or too large.
+         */
+        static void * operator new(size_t size);
+
+
+        /**
+         * @brief Puts a coroutine frame back on this thread's free list of its size class.
+         */
+        static void operator delete(void * pointer, size_t size);
+    };
+
+
+    /**
+     * @brief Suspends a task until a frame number.
+     */
+    struct FrameAwaiter
+    {
+        size_t count;   ///< Frames to wait, at least one.
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle <promise_type> handle) const noexcept;
+        void await_resume() const noexcept {}
+    };
+
+
+    /**
+     * @brief Suspends a task until the scheduler time has advanced far enough.
+     */
+    struct TimeAwaiter
+    {
+        double duration;    ///< Seconds to wait.
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle <promise_type> handle) const noexcept;
+        void await_resume() const noexcept {}
+    };
+
+
+    /**
+     * @brief Suspends a task until the next input event and returns it.
+     */
+    struct InputAwaiter
+    {
+        promise_type * promise = nullptr;   ///< Promise of the waiting task, holding the event once resumed.
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle <promise_type> handle) noexcept;
+        InputEvent await_resume() const noexcept { return promise->event; }
+    };
+
+
+    SceneTask(SceneTask && other) noexcept;
+    SceneTask & operator = (SceneTask && other) noexcept;
+    SceneTask(const SceneTask &) = delete;
+    SceneTask & operator = (const SceneTask &) = delete;
+
+
+    /**
+     * @brief Destroys the coroutine if the task still owns one.
+     */
+    ~SceneTask();
+
+
+    /**
+     * @brief Waits until the next frame.
+     */
+    static FrameAwaiter nextFrame() { return FrameAwaiter{1}; }
+
+
+    /**
+     * @brief Waits a number of frames; 0 is treated as 1.
+     */
+    static FrameAwaiter frames(size_t count) { return FrameAwaiter{count > 0 ? count : 1}; }
+
+
+    /**
+     * @brief Waits until at least `duration` seconds of scheduler time have passed; always at least one frame.
+     */
+    static TimeAwaiter seconds(double duration) { return TimeAwaiter{duration}; }
+
+
+    /**
+     * @brief Waits for the next input event the scheduler dispatches.
+     */
+    static InputAwaiter input() { return InputAwaiter{}; }
+
+private:
+    friend class SceneScheduler;
+
+    std::coroutine_handle <promise_type> handle;    ///< The coroutine, null once moved from.
+
+
+    explicit SceneTask(std::coroutine_handle <promise_type> Handle);
+};
+
+
+/**
+ * @class SceneScheduler
+ * @brief Resumes scene coroutines on the loop thread, once per frame and on input.
+ *
+ * Every `tick()` advances the frame counter and the clock and resumes, in
+ * spawn order, every task whose frame or time has come; `dispatch()` resumes
+ * every task waiting for input. Everything runs on the calling thread, so
+ * tasks can touch the loop's grids without locks, and a tick is a loop over
+ * a vector of handles: resuming a task costs about as much as a virtual call.
+ * Finished tasks are destroyed and their frames recycled; a task that ends
+ * with an exception is destroyed and the exception rethrown from `tick()` or
+ * `dispatch()`.
+ */
+class SceneScheduler
+{
+public:
+    /**
+     * @brief Constructs an empty scheduler.
+     *
+     * @param Capacity Number of tasks to reserve room for, so spawning up to that many does not grow the list.
+     */
+    explicit SceneScheduler(size_t Capacity = 64);
+
+
+    /**
+     * @brief Takes over a task; it first runs at the next tick, or later in the current one when spawned by a task.
+     *
+     * @param task The task.
+     */
+    void spawn(SceneTask task);
+
+
+    /**
+     * @brief Advances to the next frame and resumes the tasks that are due.
+     *
+     * The clock starts at 0 on the first tick.
+     */
+    void tick();
+
+
+    /**
+     * @brief Resumes every task waiting for input with an event.
+     *
+     * @param event The event.
+     * @return bool Whether any task was waiting for it.
+     */
+    bool dispatch(const InputEvent & event);
+
+
+    /**
+     * @brief Destroys every task. Must not be called from a task.
+     */
+    void clear();
+
+
+    /**
+     * @brief Returns the number of ticks so far.
+     *
+     * @return size_t The frame number.
+     */
+    size_t getFrame() const;
+
+
+    /**
+     * @brief Returns the time of the last tick.
+     *
+     * @return double Seconds since the first tick.
+     */
+    double getTime() const;
+
+
+    /**
+     * @brief Returns the number of live tasks.
+     *
+     * @return size_t The count.
+     */
+    size_t size() const;
+
+private:
+    std::vector <SceneTask> tasks;                      ///< Live tasks in spawn order.
+    size_t frame;                                       ///< Ticks so far.
+    double time;                                        ///< Seconds from the first tick to the last one.
+    std::chrono::steady_clock::time_point start;        ///< Time of the first tick.
+
+
+    /**
+     * @brief Resumes a task and destroys it if it finished.
+     *
+     * @return bool Whether the task is still live; otherwise the tasks after it moved down by one.
+     * @throws The exception the task ended with, if any.
+     */
+    bool resume(size_t index);
+};
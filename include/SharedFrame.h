@@ -0,0 +1,140 @@
+/**
+ * @file SharedFrame.h
+ * @brief Defines the layout of a frame shared between processes through POSIX shared memory.
+ */
+
+
+#pragma once
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+
+/**
+ * @struct SharedFrame
+ * @brief Header of a shared-memory segment holding one grid of packed colors, guarded by a sequence lock.
+ *
+ * The header is followed by `height * width` cells, row by row, each a
+ * background color packed as `0x00RRGGBB`. A writer makes the sequence odd
+ * before it changes any cell and even again afterwards; a reader that sees
+ * the same even sequence before and after reading the cells has read a
+ * whole frame, and otherwise simply tries again later. Neither side locks or
+ * makes a system call per frame; reading the cells is the only copy.
+ *
+ * Cells are relaxed atomics so that a reader racing a writer is well
+ * defined; on every supported platform they compile to plain loads and
+ * stores. The header only uses fixed-size, address-free types, so the writer
+ * does not need to link against this project.
+ */
+struct SharedFrame
+{
+    /// Set by the writer once the header is filled in ("TFSF").
+    static constexpr uint32_t MAGIC = 0x46534654;
+
+    /// Layout version; readers reject other versions.
+    static constexpr uint32_t VERSION = 1;
+
+
+    std::atomic <uint32_t> magic;           ///< `MAGIC` once `version`, `height` and `width` are valid.
+    uint32_t version;                       ///< Layout version.
+    uint32_t height;                        ///< Rows of the grid.
+    uint32_t width;                         ///< Columns of the grid.
+    std::atomic <uint32_t> closed;          ///< Set by the writer when no more frames will come.
+    alignas(64) std::atomic <uint64_t> sequence;    ///< Odd while a frame is being written; counts frames times two.
+
+
+    /**
+     * @brief Returns the size of a segment holding a grid.
+     *
+     * @param height Rows of the grid.
+     * @param width Columns of the grid.
+     * @return size_t Bytes of the header and the cells.
+     */
+    static constexpr size_t getSize(size_t height, size_t width)
+    {
+        return sizeof(SharedFrame) + height * width * sizeof(uint32_t);
+    }
+
+
+    /**
+     * @brief Packs a color into a cell value.
+     *
+     * @return uint32_t The color as `0x00RRGGBB`.
+     */
+    static constexpr uint32_t pack(uint8_t red, uint8_t green, uint8_t blue)
+    {
+        return uint32_t(red) << 16 | uint32_t(green) << 8 | uint32_t(blue);
+    }
+
+
+    /**
+     * @brief Returns the cells, which follow the header.
+     *
+     * @return std::atomic <uint32_t> * The first cell of the top row.
+     */
+    std::atomic <uint32_t> * getCells()
+    {
+        return reinterpret_cast<std::atomic <uint32_t> *>(this + 1);
+    }
+
+
+    /**
+     * @brief Returns the cells, which follow the header.
+     *
+     * @return const std::atomic <uint32_t> * The first cell of the top row.
+     */
+    const std::atomic <uint32_t> * getCells() const
+    {
+        return reinterpret_cast<const std::atomic <uint32_t> *>(this + 1);
+    }
+
+
+    /**
+     * @brief Starts writing a frame; readers ignore the cells until `endWrite()`.
+     */
+    void beginWrite()
+    {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+
+    /**
+     * @brief Publishes the frame written since `beginWrite()`.
+     */
+    void endWrite()
+    {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+
+    /**
+     * @brief Starts reading a frame.
+     *
+     * @return uint64_t The sequence to pass to `endRead()`; odd while a frame is being written, so the cells are not worth reading.
+     */
+    uint64_t beginRead() const
+    {
+        return sequence.load(std::memory_order_acquire);
+    }
+
+
+    /**
+     * @brief Reports whether the cells read since `beginRead()` form one whole frame.
+     *
+     * @param started What `beginRead()` returned.
+     * @return bool False if a writer was busy when the read started or has started a frame since.
+     */
+    bool endRead(uint64_t started) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return (started & 1) == 0 && sequence.load(std::memory_order_relaxed) == started;
+    }
+};
+
+
+static_assert(std::atomic <uint32_t>::is_always_lock_free && std::atomic <uint64_t>::is_always_lock_free,
+              "SharedFrame needs address-free atomics to work across processes");
+static_assert(sizeof(SharedFrame) % alignof(std::atomic <uint32_t>) == 0, "SharedFrame cells must be aligned");
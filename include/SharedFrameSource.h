@@ -0,0 +1,111 @@
+/**
+ * @file SharedFrameSource.h
+ * @brief Defines a loop that displays frames another process writes into POSIX shared memory.
+ */
+
+
+#pragma once
+
+
+#include <string>
+#include <vector>
+
+
+#include "TerminalLoop.h"
+#include "SharedFrame.h"
+
+
+/**
+ * @class SharedFrameSource
+ * @brief Shows the grid of a SharedFrame segment, so a simulation can run in a process of its own.
+ *
+ * The segment is mapped once. Each frame the loop checks the sequence
+ * counter and, when a new frame is complete, unpacks the cells from the
+ * mapping into a spare grid, which is swapped in if the counter did not move
+ * in the meantime; a frame the writer changed while it was being read is
+ * dropped and the next frame tries again. That unpacking is the one copy a
+ * frame costs, a packed color converted into each cell; the path takes no
+ * lock and makes no system call. The loop stops once the writer closes the
+ * segment.
+ */
+class SharedFrameSource : public TerminalLoop
+{
+public:
+    /**
+     * @brief Frame counters of the source.
+     */
+    struct Statistics
+    {
+        size_t framesShown;     ///< Frames swapped into the grid.
+        size_t framesTorn;      ///< Reads discarded because the writer changed the frame meanwhile.
+        uint64_t framesWritten; ///< Frames the writer has published.
+    };
+
+
+    /**
+     * @brief What `readFrame()` found.
+     */
+    enum class Read
+    {
+        Shown,      ///< A new whole frame was unpacked.
+        Unchanged,  ///< No frame was published since the last one shown.
+        Busy,       ///< The writer is in the middle of a frame.
+        Torn,       ///< The writer started a frame while the cells were unpacked; they are not usable.
+        Closed      ///< The writer closed the segment and every frame has been shown.
+    };
+
+
+    /**
+     * @brief Maps a segment a writer has created.
+     *
+     * @param name Name of the segment as given to `shm_open()`, e.g. "/terminal-fun".
+     * @param FrameRate Target frame rate for display. Defaults to 30.0 FPS.
+     * @param ScaleRatio Whether to maintain aspect ratio when scaling. Defaults to true.
+     *
+     * @throws std::runtime_error If the segment does not exist, is too small or was not written by a SharedFrame writer.
+     */
+    SharedFrameSource(const std::string & name, double FrameRate = 30.0, bool ScaleRatio = true);
+
+
+    /**
+     * @brief Unmaps the segment; the writer owns and removes it.
+     */
+    ~SharedFrameSource();
+
+
+    SharedFrameSource(const SharedFrameSource &) = delete;
+    SharedFrameSource & operator = (const SharedFrameSource &) = delete;
+
+
+    /**
+     * @brief Returns the frame counters gathered so far.
+     *
+     * @return Statistics Frames shown, torn and written.
+     */
+    Statistics getStatistics() const;
+
+
+    /**
+     * @brief Unpacks the segment's frame into a grid if it is new and complete; the loop's whole data path.
+     *
+     * @param frame The segment.
+     * @param shownSequence Sequence of the frame shown last, updated when a new one is read.
+     * @param grid Grid of the segment's size the cells are unpacked into; only a whole frame when `Read::Shown` is returned.
+     * @return Read What was found.
+     */
+    static Read readFrame(const SharedFrame & frame, uint64_t & shownSequence, std::vector < std::vector < OneSymbol > > & grid);
+
+protected:
+    /**
+     * @brief Swaps in the newest complete frame, or stops once the writer has closed the segment.
+     */
+    void update() override;
+
+private:
+    const SharedFrame * frame;  ///< Header of the mapped segment.
+    size_t size;                ///< Size of the mapping.
+    uint64_t shownSequence;     ///< Sequence of the frame in the grid.
+    size_t framesShown;         ///< Frames swapped into the grid.
+    size_t framesTorn;          ///< Reads discarded as torn.
+    std::vector < std::vector < OneSymbol > > pending;  ///< Grid the next frame is unpacked into.
+};
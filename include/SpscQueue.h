@@ -0,0 +1,88 @@
+/**
+ * @file SpscQueue.h
+ * @brief Defines SpscQueue, a bounded lock-free queue for one producer and one consumer thread.
+ */
+
+
+#pragma once
+
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+
+/**
+ * @class SpscQueue
+ * @brief Fixed-capacity ring buffer handing values from one thread to another without locks.
+ *
+ * The producer only writes `tail` and the consumer only writes `head`, each
+ * publishing its progress with a release store that the other side reads
+ * with an acquire load, so neither side ever waits for the other. The two
+ * indices live on separate cache lines so the threads do not invalidate each
+ * other's line on every operation. Storage is part of the object; pushing and
+ * popping never allocate.
+ *
+ * @tparam T Element type; must be default-constructible and assignable.
+ * @tparam Capacity Number of slots; a power of two.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    /**
+     * @brief Appends a value; called by the producer thread only.
+     *
+     * @param value The value to append.
+     * @return bool False if the queue was full and the value was dropped.
+     */
+    bool push(const T & value)
+    {
+        size_t currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail - head.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        slots[currentTail & (Capacity - 1)] = value;
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+
+    /**
+     * @brief Removes the oldest value; called by the consumer thread only.
+     *
+     * @param value Receives the value.
+     * @return bool False if the queue was empty.
+     */
+    bool pop(T & value)
+    {
+        size_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == tail.load(std::memory_order_acquire))
+            return false;
+
+        value = slots[currentHead & (Capacity - 1)];
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+
+    /**
+     * @brief Reports whether the queue is empty; exact only on the consumer thread.
+     *
+     * @return True if there is nothing to pop.
+     */
+    bool empty() const
+    {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    /// Distance that keeps the two indices on different cache lines.
+    static constexpr size_t CACHE_LINE = 64;
+
+    alignas(CACHE_LINE) std::atomic <size_t> head{0};   ///< Next slot to pop; written by the consumer.
+    alignas(CACHE_LINE) std::atomic <size_t> tail{0};   ///< Next slot to push; written by the producer.
+    alignas(CACHE_LINE) std::array <T, Capacity> slots{};   ///< Ring storage.
+};
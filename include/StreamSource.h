@@ -0,0 +1,180 @@
+/**
+ * @file StreamSource.h
+ * @brief Defines a loop that displays raw video frames read from stdin or a pipe.
+ */
+
+
+#pragma once
+
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <termios.h>
+#include <thread>
+#include <vector>
+
+
+#include "TerminalLoop.h"
+
+
+/**
+ * @class StreamSource
+ * @brief Displays a stream of RGB24, PPM/PGM or PAM frames.
+ *
+ * A read-ahead thread pulls whole frames from the source with large `read()`
+ * calls straight into a frame buffer, so reading frame N+1 overlaps scaling and
+ * printing frame N. Headers are parsed from a small internal buffer; pixel data
+ * never goes through iostreams. Each displayed frame is copied into the active
+ * grid, which is resized to the frame's dimensions, and then scaled by
+ * `setUpScaledGrid` like any other effect. The loop stops at end of stream.
+ */
+class StreamSource : public TerminalLoop
+{
+public:
+    /**
+     * @brief Encoding of the incoming frames.
+     */
+    enum class Format
+    {
+        RawRGB24,   ///< Headerless frames of `width * height * 3` bytes.
+        Netpbm      ///< PPM (P6), PGM (P5) or PAM (P7) frames, each with its own header.
+    };
+
+
+    /**
+     * @brief Throughput counters of the stream.
+     */
+    struct Statistics
+    {
+        size_t framesRead;      ///< Frames fully read from the source.
+        size_t framesShown;     ///< Frames copied into the grid.
+        size_t bytesRead;       ///< Bytes read from the source.
+        double seconds;         ///< Time since the stream was opened.
+    };
+
+
+    /**
+     * @brief Opens the source and starts the read-ahead thread.
+     *
+     * When the source is standard input the quit key is read from `/dev/tty` instead.
+     *
+     * @param path Path of a file or FIFO, or "-" for standard input.
+     * @param StreamFormat Encoding of the frames.
+     * @param RawWidth Frame width, required for `Format::RawRGB24`.
+     * @param RawHeight Frame height, required for `Format::RawRGB24`.
+     * @param FrameRate Target frame rate for display. Defaults to 30.0 FPS.
+     * @param ScaleRatio Whether to maintain aspect ratio when scaling. Defaults to true.
+     *
+     * @throws std::runtime_error If the source cannot be opened or raw dimensions are missing.
+     */
+    StreamSource(const std::string & path, Format StreamFormat, size_t RawWidth = 0, size_t RawHeight = 0,
+                 double FrameRate = 30.0, bool ScaleRatio = true);
+
+
+    /**
+     * @brief Stops the read-ahead thread and closes the source.
+     */
+    ~StreamSource();
+
+
+    /**
+     * @brief Returns the throughput counters gathered so far.
+     *
+     * @return Statistics Frames and bytes read and shown.
+     */
+    Statistics getStatistics() const;
+
+
+protected:
+    /**
+     * @brief Copies the newest complete frame into the grid, or stops at end of stream.
+     *
+     * @throws std::runtime_error If the read-ahead thread hit a malformed frame or a read error.
+     */
+    void update() override;
+
+
+private:
+    /**
+     * @brief A decoded frame: tightly packed 8-bit samples.
+     */
+    struct Frame
+    {
+        std::vector <uint8_t> pixels;   ///< `height * width * channels` samples.
+        size_t width = 0;               ///< Width in pixels.
+        size_t height = 0;              ///< Height in pixels.
+        size_t channels = 0;            ///< 1 (gray), 3 (RGB) or 4 (RGB + alpha).
+    };
+
+    int sourceDescriptor;               ///< Descriptor frames are read from.
+    int ttyDescriptor;                  ///< `/dev/tty` when the source is standard input, -1 otherwise.
+    struct termios ttySettings;         ///< Settings of `ttyDescriptor` restored on destruction.
+    int wakeDescriptor;                 ///< Event descriptor that interrupts a blocked read on shutdown.
+    Format format;                      ///< Encoding of the frames.
+    size_t rawWidth;                    ///< Width of raw frames.
+    size_t rawHeight;                   ///< Height of raw frames.
+
+    std::vector <uint8_t> readBuffer;   ///< Buffered bytes for header parsing.
+    size_t readPosition;                ///< Next unread byte in `readBuffer`.
+    size_t readEnd;                     ///< End of valid bytes in `readBuffer`.
+
+    Frame backFrame;                    ///< Frame being filled by the read-ahead thread.
+    Frame readyFrame;                   ///< Complete frame waiting for `update()`.
+    Frame frontFrame;                   ///< Frame last copied into the grid.
+    bool readyFull;                     ///< Whether `readyFrame` holds an unseen frame.
+    bool endOfStream;                   ///< Whether the reader reached the end of the source.
+    bool stopping;                      ///< Whether the reader should exit.
+    std::string readerError;            ///< Error reported by the read-ahead thread.
+    size_t framesRead;                  ///< Frames fully read.
+    size_t framesShown;                 ///< Frames copied into the grid.
+    std::atomic <size_t> bytesRead;     ///< Bytes read from the source.
+    std::chrono::steady_clock::time_point openTime; ///< Time the stream was opened.
+    mutable std::mutex mutex;           ///< Guards the hand-over state above.
+    std::condition_variable condition;  ///< Signals frame hand-over in both directions.
+    std::thread reader;                 ///< Read-ahead thread.
+
+
+    /**
+     * @brief Body of the read-ahead thread.
+     */
+    void readerLoop();
+
+
+    /**
+     * @brief Reads the next frame into `backFrame`.
+     *
+     * @return True on success, false on a clean end of stream.
+     */
+    bool readFrame();
+
+
+    /**
+     * @brief Reads exactly `size` bytes, draining buffered header bytes first.
+     *
+     * @return True on success, false if the stream ended first.
+     */
+    bool readExact(uint8_t * destination, size_t size);
+
+
+    /**
+     * @brief Returns the next byte of the stream, or -1 at end of stream.
+     */
+    int nextByte();
+
+
+    /**
+     * @brief Reads the next whitespace-separated header token, skipping `#` comments.
+     */
+    std::string nextToken();
+
+
+    /**
+     * @brief Parses a P5/P6/P7 header into `backFrame`.
+     *
+     * @return True on success, false on a clean end of stream before the header.
+     */
+    bool readNetpbmHeader();
+};
@@ -11,9 +11,15 @@
 #include <unistd.h>
 #include <iostream>
 #include <termios.h>
+#include <vector>
 
 
 #include "OneSymbol.h"
+#include "FrameArena.h"
+#include "FrameEncoder.h"
+#include "PixelView.h"
+#include "FixedColor.h"
+#include "Resampler.h"
 
 
 #define GRID(terminal) (static_cast<std::vector<std::vector<OneSymbol>>&>(terminal))
@@ -33,7 +39,10 @@ public:
      * @brief Constructor that sets up the terminal environment and initializes the active grid.
      *
      * This constructor disables cursor visibility, prevents input characters
-     * from being echoed to the terminal, and resizes the active grid.
+     * from being echoed to the terminal, and resizes the active grid. Only
+     * the first of several live instances changes the terminal settings, so
+     * loops created while another one owns the terminal, such as the scenes
+     * of a SceneManager, leave the screen alone.
      *
      * @param Height The initial height of the active grid.
      * @param Width The initial width of the active grid.
@@ -44,7 +53,7 @@ public:
      * @brief Destructor that restores the terminal settings.
      *
      * This destructor ensures the cursor is re-enabled and input character echoing
-     * is restored when the object goes out of scope.
+     * is restored when the object goes out of scope; only the last live instance does.
      */
     ~TerminalControl();
 
@@ -73,28 +82,125 @@ public:
     /**
      * @brief Prints the scaled terminal grid content to the output.
      *
-     * This function iterates over `scaledGrid` and prints each element
-     * to the standard output.
+     * The whole `scaledGrid` is encoded into a buffer taken from the frame arena
+     * and written to the standard output in a single call. With synchronized
+     * output the frame is wrapped in begin/end synchronized update sequences
+     * (DEC private mode 2026) so the terminal never shows it half drawn, and
+     * with sparse frames only the cells that changed since the last printed
+     * frame are sent.
+     *
+     * @return size_t Number of bytes written.
+     */
+    size_t printTerminal();
+
+
+    /**
+     * @brief Prints only some rectangles of the scaled grid, leaving the rest of the screen as it is.
+     *
+     * Each row of each region is sent behind an absolute cursor move, in one
+     * write and inside a synchronized update when synchronized output is on.
+     * The screen must already show the rest of the grid, e.g. from an earlier
+     * `printTerminal()`.
+     *
+     * @param regions The rectangles to print.
+     * @return size_t Number of bytes written.
+     */
+    size_t printRegions(const std::vector <FrameEncoder::Region> & regions);
+
+
+    /**
+     * @brief Enables or disables synchronized output, usually from the TerminalProfile.
+     *
+     * @param enabled Whether frames are wrapped in synchronized updates.
+     */
+    void setSynchronizedOutput(bool enabled);
+
+
+    /**
+     * @brief Reports whether frames are wrapped in synchronized updates.
+     *
+     * @return True if synchronized output is enabled.
+     */
+    bool hasSynchronizedOutput() const;
+
+
+    /**
+     * @brief Enables or disables sparse frames.
+     *
+     * Sparse frames only take effect while synchronized output is enabled;
+     * the first frame and frames after a resize are always printed in full.
+     *
+     * @param enabled Whether frames only send the cells that changed.
      */
-    void printTerminal() const;
+    void setSparseFrames(bool enabled);
 
 
     /**
      * @brief Converts the terminal grid into a formatted string.
      *
-     * This function iterates over the `scaledGrid` and converts each `OneSymbol`
-     * into a string representation using `OneSymbol::toString()`. The resulting
-     * strings are concatenated into a single output buffer.
+     * This function encodes the `scaledGrid` with the frame encoder into a
+     * single output buffer that is sized once up front.
      *
      * @return A formatted string representing the terminal grid.
      */
     std::string toString() const;
 
+
+    /**
+     * @brief Retrieves the scaled grid produced by the last `setUpScaledGrid()` call.
+     *
+     * @return const std::vector<std::vector<OneSymbol>>& The grid that is printed to the terminal.
+     */
+    const std::vector < std::vector < OneSymbol > > & getScaledGrid() const;
+
+
+    /**
+     * @brief Retrieves the scaled grid for post-processing before it is printed.
+     *
+     * @return std::vector<std::vector<OneSymbol>>& The grid that is printed to the terminal.
+     */
+    std::vector < std::vector < OneSymbol > > & getScaledGrid();
+
+
+    /**
+     * @brief Retrieves the encoder used to print frames.
+     *
+     * @return FrameEncoder& The frame encoder.
+     */
+    FrameEncoder & getEncoder();
+
+
+    /**
+     * @brief Retrieves the arena used for per-frame temporaries.
+     *
+     * Memory taken from the arena stays valid until `endFrame()` is called.
+     *
+     * @return FrameArena& The per-frame arena.
+     */
+    FrameArena & getFrameArena();
+
+
+    /**
+     * @brief Marks the end of a frame and releases all per-frame temporaries.
+     */
+    void endFrame();
+
+
+    /**
+     * @brief Reports whether the last `setUpScaledGrid()` call changed the grid size.
+     *
+     * @return True if `scaledGrid` was resized, false otherwise.
+     */
+    bool wasResized() const;
+
     /**
      * @brief Adjusts the scaled grid to fit the current terminal size.
      *
      * This function retrieves the current terminal size, resizes `scaledGrid`
-     * accordingly, and scales `activeGrid` to fit within it.
+     * accordingly, and scales `activeGrid` to fit within it. Background colors
+     * are area-averaged or resampled with the filter chosen by
+     * `setResampleFilter()`; glyphs and foreground colors come from the source
+     * cell under each target cell's center.
      *
      * @param scaleRatio If true, scales proportionally; otherwise, scales uniformly.
      *
@@ -103,12 +209,82 @@ public:
     void setUpScaledGrid(bool scaleRatio = true);
 
 
+    /**
+     * @brief Sizes the scaled grid to the terminal without filling it, for callers that compose frames themselves.
+     *
+     * Updates `wasResized()` like `setUpScaledGrid()` does.
+     */
+    void resizeScaledGrid();
+
+
+    /**
+     * @brief Fixes the size of the scaled grid instead of following the terminal.
+     *
+     * Used when the grid fills only part of the screen, like a panel of a
+     * TiledLayout. Takes effect at the next `setUpScaledGrid()` or
+     * `resizeScaledGrid()`.
+     *
+     * @param Height Rows of the scaled grid; 0 follows the terminal again.
+     * @param Width Columns of the scaled grid; 0 follows the terminal again.
+     */
+    void setOutputSize(size_t Height, size_t Width);
+
+
+    /**
+     * @brief Replaces the active grid with a downscaled copy of an image.
+     *
+     * The active grid is resized to `Height` x `Width` and each cell's background
+     * is the area average of the image pixels it covers, computed by the same
+     * logic that `setUpScaledGrid` uses. The image is read in place, so memory use
+     * depends only on the target size.
+     *
+     * @param image Pixels to sample, e.g. a memory-mapped file.
+     * @param Height Height of the resulting active grid.
+     * @param Width Width of the resulting active grid.
+     */
+    void loadImage(const PixelView & image, size_t Height, size_t Width);
+
+
+    /**
+     * @brief Selects whether scaling averages colors in linear light.
+     *
+     * Averaging sRGB values darkens downscaled gradients and fine detail;
+     * linear-light averaging converts through the ColorSpace lookup tables.
+     *
+     * @param enabled Whether to average in linear light.
+     */
+    void setLinearLight(bool enabled);
+
+
+    /**
+     * @brief Selects how `setUpScaledGrid()` resamples background colors.
+     *
+     * Area averaging suits shrinking; when the terminal is larger than the
+     * active grid, bilinear or Lanczos-3 gives smooth output and nearest is the
+     * cheapest.
+     *
+     * @param filter The filter.
+     */
+    void setResampleFilter(Resampler::Filter filter);
+
+
 private:
     size_t width;           ///< Width of the terminal in columns.
     size_t height;          ///< Height of the terminal in rows.
+    size_t outputWidth;     ///< Fixed width of the scaled grid, 0 to follow the terminal.
+    size_t outputHeight;    ///< Fixed height of the scaled grid, 0 to follow the terminal.
 
     std::vector < std::vector < OneSymbol > > activeGrid;  ///< The main grid being modified (Also referenced as terminalGrid)
     std::vector < std::vector < OneSymbol > > scaledGrid;  ///< The scaled grid used for printing
+    std::vector < std::vector < OneSymbol > > printedGrid; ///< The last grid printed, kept for sparse frames
+
+    FrameArena frameArena;  ///< Memory for per-frame temporaries, reset by `endFrame()`
+    FrameEncoder encoder;   ///< Encodes `scaledGrid` into ANSI output
+    bool resized;           ///< Whether the last `setTerminalSize()` changed the grid size
+    bool linearLight;       ///< Whether scaling averages colors in linear light
+    bool synchronizedOutput;    ///< Whether frames are wrapped in synchronized updates
+    bool sparseFrames;      ///< Whether frames only send changed cells while synchronized
+    Resampler resampler;    ///< Scales `activeGrid` when a filter other than area averaging is selected
 
 
     /**
@@ -116,7 +292,8 @@ private:
     *
     * This function adjusts the size of `scaledGrid` to match the
     * current `height` and `width`. It ensures that each row is resized
-    * correctly to maintain a consistent grid structure.
+    * correctly to maintain a consistent grid structure. Nothing is touched
+    * when the dimensions did not change.
     *
     * @note Assumes `height` and `width` must be already set.
     */
@@ -127,7 +304,8 @@ private:
      * @brief Retrieves the current terminal size.
      *
      * This function queries the terminal for its current dimensions (columns and rows)
-     * and updates the `width` and `height` member variables accordingly.
+     * and updates the `width` and `height` member variables accordingly, unless
+     * `setOutputSize()` fixed them.
      *
      * @note This function is platform-dependent and only works on terminals that
      *       support the `TIOCGWINSZ` ioctl command (POSIX systems).
@@ -135,14 +313,82 @@ private:
     void getTerminalSize();
 
 
+    /**
+     * @brief Area-averages a source into the background colors of a target grid.
+     *
+     * @tparam LinearLight Whether `sample` returns linear light (0-65535) to be averaged and converted back to sRGB.
+     * @tparam Sample Callable returning the Color at `(row, col)` of the source.
+     * @param sample Accessor for source colors.
+     * @param sourceHeight Number of source rows.
+     * @param sourceWidth Number of source columns.
+     * @param target Grid to fill; its current size is the target size.
+     * @param scaleRatio If true, scales each axis independently; otherwise, scales uniformly.
+     */
+    template <bool LinearLight, typename Sample>
+    void scaleArea(const Sample & sample, size_t sourceHeight, size_t sourceWidth,
+                   std::vector < std::vector < OneSymbol > > & target, bool scaleRatio) const;
+
+
+    /**
+     * @brief Resamples the background colors of `activeGrid` into `scaledGrid` with the selected filter.
+     *
+     * @param scaleRatio If true, scales each axis independently; otherwise, scales uniformly.
+     */
+    void resampleBackground(bool scaleRatio);
+
+
+    /**
+     * @brief Source taps and 8.8 fixed-point weights of every target cell along one axis.
+     *
+     * Taps of target cell `t` are `offset[t]` to `offset[t + 1] - 1`; the first
+     * of them samples source cell `first[t]`, the following ones the next cells.
+     */
+    struct AxisWeights
+    {
+        const size_t * first;                       ///< First source cell of every target cell.
+        const size_t * offset;                      ///< Start of every target cell's taps; one extra entry ends the last cell.
+        const FixedColor::Coefficient * weight;     ///< Overlap of every tap, 1.0 being a full source cell.
+    };
+
+
+    /**
+     * @brief Area-averages 8-bit pixels into the background colors of a target grid with integer arithmetic.
+     *
+     * Overlaps are quantized to 8.8 fixed point per axis and the weighted sums
+     * are accumulated in integers; the result matches `scaleArea<false>` within ±1.
+     *
+     * @param source Pixels to scale.
+     * @param target Grid to fill; its current size is the target size.
+     * @param scaleRatio If true, scales each axis independently; otherwise, scales uniformly.
+     */
+    void scaleAreaFixed(const PixelView & source, std::vector < std::vector < OneSymbol > > & target, bool scaleRatio);
+
+
+    /**
+     * @brief Computes the taps and weights of one axis into memory taken from the frame arena.
+     *
+     * @param targetSize Number of target cells along the axis.
+     * @param sourceSize Number of source cells along the axis.
+     * @param scale Source cells per target cell.
+     * @param arena Arena providing the tables.
+     * @return AxisWeights The tables, valid until the arena is reset.
+     */
+    static AxisWeights buildAxisWeights(size_t targetSize, size_t sourceSize, double scale, FrameArena & arena);
+
+
     /**
      * @brief Computes scaling factors for row and column adjustments.
      *
+     * @param sourceHeight Number of source rows.
+     * @param sourceWidth Number of source columns.
+     * @param targetHeight Number of target rows.
+     * @param targetWidth Number of target columns.
      * @param rowScale Reference to store the computed row scaling factor.
      * @param colScale Reference to store the computed column scaling factor.
      * @param scaleRatio If true, maintains the aspect ratio while scaling.
      */
-    void computeScalingFactors(double & rowScale, double & colScale, bool scaleRatio) const;
+    void computeScalingFactors(size_t sourceHeight, size_t sourceWidth, size_t targetHeight, size_t targetWidth,
+                               double & rowScale, double & colScale, bool scaleRatio) const;
 
 
     /**
@@ -174,30 +420,35 @@ private:
      * @param srcRowEnd Source row end position.
      * @param srcColStart Source column start position.
      * @param srcColEnd Source column end position.
+     * @param sourceHeight Number of source rows.
+     * @param sourceWidth Number of source columns.
      * @param rowStart Reference to store computed row start index.
      * @param rowEnd Reference to store computed row end index.
      * @param colStart Reference to store computed column start index.
      * @param colEnd Reference to store computed column end index.
      */
     void getSourceBounds(double srcRowStart, double srcRowEnd, double srcColStart, double srcColEnd,
+                         size_t sourceHeight, size_t sourceWidth,
                          size_t & rowStart, size_t & rowEnd, size_t & colStart, size_t & colEnd) const;
 
     /**
      * @brief Computes the averaged color values for scaling.
      *
-     * @param rowStart Start row index in activeGrid.
-     * @param rowEnd End row index in activeGrid.
-     * @param colStart Start column index in activeGrid.
-     * @param colEnd End column index in activeGrid.
+     * @tparam LinearLight Whether the samples are linear light and the average is converted back to sRGB.
+     * @tparam Sample Callable returning the Color at `(row, col)` of the source.
+     * @param sample Accessor for source colors.
+     * @param rowStart Start row index in the source.
+     * @param rowEnd End row index in the source.
+     * @param colStart Start column index in the source.
+     * @param colEnd End column index in the source.
      * @param srcRowStart Source row start position.
      * @param srcRowEnd Source row end position.
      * @param srcColStart Source column start position.
      * @param srcColEnd Source column end position.
-     * @param red Reference to store computed red color value.
-     * @param green Reference to store computed green color value.
-     * @param blue Reference to store computed blue color value.
+     * @param computedColor Reference to store the computed color.
      */
-    void computeAveragedColor(size_t rowStart, size_t rowEnd, size_t colStart, size_t colEnd,
+    template <bool LinearLight, typename Sample>
+    void computeAveragedColor(const Sample & sample, size_t rowStart, size_t rowEnd, size_t colStart, size_t colEnd,
                               double srcRowStart, double srcRowEnd, double srcColStart,
                               double srcColEnd, Color & computedColor) const;
 };
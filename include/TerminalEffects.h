@@ -13,6 +13,8 @@
 #include <vector>
 #include <functional>
 #include "OneSymbol.h"
+#include "GlyphRamp.h"
+#include "FrameArena.h"
 
 
 
@@ -53,9 +55,10 @@ namespace TerminalEffects
      * with the specified `newSymbol`.
      *
      * @param terminalGrid The terminal grid to modify.
-     * @param newSymbol The new symbol character to apply.
+     * @param newSymbol The new glyph to apply.
+     * @throws std::invalid_argument If the glyph is not one column wide.
      */
-    void changeSymbolEffect(std::vector < std::vector <OneSymbol> > & terminalGrid, const char newSymbol);
+    void changeSymbolEffect(std::vector < std::vector <OneSymbol> > & terminalGrid, const GlyphId newSymbol);
 
 
     /**
@@ -65,11 +68,12 @@ namespace TerminalEffects
      * `newSymbol`, `newForegroundColor`, and `newBackgroundColor`.
      *
      * @param terminalGrid The terminal grid to modify.
-     * @param newSymbol The new symbol character to apply.
+     * @param newSymbol The new glyph to apply.
      * @param newForegroundColor The new foreground color to apply.
      * @param newBackgroundColor The new background color to apply.
+     * @throws std::invalid_argument If the glyph is not one column wide.
      */
-    void changeTerminalToEffect(std::vector < std::vector <OneSymbol> > & terminalGrid, const char newSymbol, const Color & newForegroundColor, const Color & newBackgroundColor);
+    void changeTerminalToEffect(std::vector < std::vector <OneSymbol> > & terminalGrid, const GlyphId newSymbol, const Color & newForegroundColor, const Color & newBackgroundColor);
 
 
 
@@ -91,6 +95,7 @@ namespace TerminalEffects
      * @param terminalGrid The terminal grid to modify.
      * @param increment The value by which to increase or decrease each color component.
      *                  Positive values brighten the color, while negative values darken it.
+     *                  Whole increments take the saturating integer path of FixedColor.
      */
     void adjustBrightnessByIncrementEffect(std::vector < std::vector <OneSymbol> > & terminalGrid, const double increment);
 
@@ -99,11 +104,70 @@ namespace TerminalEffects
     * @brief Increments the foreground and background colors of all symbols in the terminal grid.
     *
     * This function iterates through the `terminalGrid` and adjusts the foreground and background
-    * colors of each symbol by the specified increments.
+    * colors of each symbol by the specified increments. Whole increments take the
+    * saturating integer path of FixedColor.
     *
     * @param terminalGrid The terminal grid to modify.
     * @param foregroundColorIncrement The amount to increment the foreground color.
     * @param backgroundColorIncrement The amount to increment the background color.
     */
     void incrementColorEffect(std::vector < std::vector <OneSymbol> > & terminalGrid, const Color foregroundColorIncrement, const Color backgroundColorIncrement);
+
+
+    /**
+    * @brief Turns the grid into ASCII art drawn with density glyphs.
+    *
+    * Each cell's luminance is computed from its background color and mapped to a
+    * glyph through the ramp's lookup table. The original color moves to the
+    * foreground and the background becomes black, so the result also reads well
+    * when only foreground colors are emitted. With edge detection, cells on a
+    * strong luminance edge get a line glyph (`-`, `|`, `/`, `\`) following the edge.
+    *
+    * @param terminalGrid The terminal grid to modify, usually the scaled grid.
+    * @param ramp Lookup table from luminance to glyph.
+    * @param arena Arena providing the luminance scratch buffer.
+    * @param detectEdges Whether to replace glyphs on strong edges with line glyphs.
+    */
+    void asciiArtEffect(std::vector < std::vector <OneSymbol> > & terminalGrid, const GlyphRamp & ramp, FrameArena & arena, bool detectEdges = false);
+
+
+    /**
+    * @brief Blends a row of symbols over another row, cell by cell.
+    *
+    * Background colors are interpolated by the blend factor, scaled per cell by
+    * the optional coverage. Where the source cell carries a glyph it replaces the
+    * destination glyph, faded into the blended background; where it is blank the
+    * destination glyph is faded towards the source background instead. The loop
+    * is written without branches so the compiler can vectorize it.
+    *
+    * A wide glyph and its `GlyphTable::CONTINUATION` cell count as one glyph,
+    * visible where its left half is; a wide glyph whose right half lies past
+    * `count` is not drawn. Destination wide glyphs that lost one half become
+    * blanks, so the row keeps its width. Callers pass spans that do not split
+    * any wide glyph.
+    *
+    * @param destination Row to blend into.
+    * @param source Row blended on top, at least `count` cells long.
+    * @param count Number of cells to blend.
+    * @param factor Blend factor (0.0 = no change, 1.0 = source replaces destination).
+    * @param coverage Optional per-cell coverage (0-255) multiplied into the factor; null means fully covered.
+    */
+    void blendRow(OneSymbol * destination, const OneSymbol * source, size_t count, double factor, const uint8_t * coverage = nullptr);
+
+
+    /**
+    * @brief Crossfades a row of symbols towards another row.
+    *
+    * Both colors of every cell are mixed like `Color::blendWith` in sRGB, and
+    * the glyph switches to the source glyph once the factor reaches one half.
+    * Unlike `blendRow`, blank source cells fade the destination glyph's ink
+    * just like any other, so a whole frame dissolves into the next evenly.
+    * The loop is written without branches so the compiler can vectorize it.
+    *
+    * @param destination Row to fade, holding the outgoing frame.
+    * @param source Incoming row, at least `count` cells long.
+    * @param count Number of cells to fade.
+    * @param factor Progress of the fade (0.0 = destination unchanged, 1.0 = source).
+    */
+    void crossfadeRow(OneSymbol * destination, const OneSymbol * source, size_t count, double factor);
 }
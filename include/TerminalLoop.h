@@ -8,15 +8,62 @@
 
 
 #include <chrono>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <thread>
 
 
 #include "TerminalControl.h"
+#include "AllocationCounter.h"
+#include "FrameRecorder.h"
+#include "TerminalEffects.h"
+#include "GlyphRamp.h"
+#include "ColorLut.h"
+#include "TerminalProfile.h"
+#include "InputReader.h"
+#include "EffectTimeline.h"
+#include "SceneScheduler.h"
 
 
 #define DIMENSIONS 100
 
 
+/**
+ * @struct LoopOptions
+ * @brief Command-line choices that apply to whichever loop ends up running.
+ */
+struct LoopOptions
+{
+    /**
+     * @brief Whether frames are wrapped in synchronized updates.
+     */
+    enum class Synchronization
+    {
+        Auto,       ///< Follow the TerminalProfile, which falls back to plain frames when the terminal does not answer.
+        Always,     ///< Assume support without asking.
+        Never       ///< Never wrap frames.
+    };
+
+
+    std::string recordPath;     ///< When not empty, every rendered frame is recorded to this file.
+    bool asciiArt = false;      ///< Whether frames are drawn as luminance glyphs instead of colored blocks.
+    bool asciiEdges = false;    ///< Whether ASCII art draws line glyphs along strong edges.
+    std::string glyphRamp;      ///< Glyphs of ASCII art from sparsest to densest; GlyphRamp::DEFAULT_RAMP when empty.
+    FrameEncoder::Mode encoderMode = FrameEncoder::Mode::Full;  ///< Which parts of each cell are emitted.
+    std::optional <FrameEncoder::Spans> spans;     ///< How runs of identical cells are emitted; the fastest the terminal supports when unset.
+    std::optional <FrameEncoder::Palette> palette; ///< How colors are written; from the TerminalProfile when unset.
+    bool linearLight = false;   ///< Whether scaling averages colors in linear light.
+    std::string lut;            ///< When not empty, a `.cube` file or built-in preset used to grade every frame.
+    size_t lutSize = ColorLut::LARGE_SIZE;  ///< Points per axis of preset LUTs.
+    ColorLut::Interpolation lutInterpolation = ColorLut::Interpolation::Tetrahedral;   ///< LUT interpolation.
+    Resampler::Filter filter = Resampler::Filter::Area; ///< How frames are resized to the terminal.
+    Synchronization synchronization = Synchronization::Auto;   ///< Whether frames are wrapped in synchronized updates.
+    bool sparseFrames = true;   ///< Whether synchronized frames only send the cells that changed.
+};
+
+
 /**
  * @class TerminalLoop
  * @brief Abstract base class for terminal-based rendering loops.
@@ -44,13 +91,91 @@ public:
     /**
      * @brief Starts the main loop, continuously updating and rendering the terminal.
      *
-     * This function runs until 'Q'/'q' is inputed, calling `update()` and `render()` at the specified frame rate.
+     * This function runs until 'Q'/'q' is inputed or `stop()` is called, calling `update()` and `render()`
+     * at the specified frame rate. Input is read and decoded by an InputReader thread; the loop
+     * handles pending events before each frame and wakes early from its frame wait when an
+     * event arrives, so keys take effect without waiting out the frame. The reader is created
+     * by the first call, so loops that only render offscreen never read input.
+     *
+     * @throws std::runtime_error When interrupted by SIGINT or SIGTERM, after the loop has stopped,
+     *                            and in allocation-counting builds, when a steady-state frame allocates.
      */
     void run();
 
+
+    /**
+     * @brief Starts recording every rendered frame to a file.
+     *
+     * Any recording already in progress is finished first.
+     *
+     * @param path Path of the recording file.
+     * @param keyframeInterval Maximum number of frames between keyframes. Defaults to 300.
+     *
+     * @throws std::runtime_error If the file cannot be created.
+     */
+    void startRecording(const std::string & path, uint32_t keyframeInterval = 300);
+
+
+    /**
+     * @brief Finishes the current recording, if any, and closes its file.
+     */
+    void stopRecording();
+
+
+    /**
+     * @brief Applies command-line options: recording, color grading, ASCII art rendering, the output mode, scaling and synchronized output.
+     *
+     * @param options The options to apply.
+     *
+     * @throws std::runtime_error If the recording file cannot be created or the LUT cannot be loaded.
+     * @throws std::invalid_argument If the LUT is neither a `.cube` file nor a known preset, or the glyph ramp has a wide glyph.
+     */
+    void configure(const LoopOptions & options);
+
+
+    /**
+     * @brief Applies only the options that affect scaling: linear light and the resampling filter.
+     *
+     * @param options The options to apply.
+     */
+    void configureScaling(const LoopOptions & options);
+
+
+    /**
+     * @brief Advances the loop by one frame and scales it without printing anything.
+     *
+     * Lets a SceneManager drive several loops while it alone writes to the
+     * terminal. The timeline is applied; color grading, ASCII art and
+     * recording are left to whoever prints the frame.
+     *
+     * @param frame Frame number the timeline is evaluated at.
+     * @return The scaled frame, valid until the next call.
+     */
+    const std::vector < std::vector < OneSymbol > > & renderOffscreen(size_t frame);
+
+
+    /**
+     * @brief Fixes the size frames are scaled to instead of following the terminal, e.g. for a panel of a TiledLayout.
+     *
+     * @param height Rows of the scaled frame; 0 follows the terminal again.
+     * @param width Columns of the scaled frame; 0 follows the terminal again.
+     */
+    void setOutputSize(size_t height, size_t width);
+
+
+    /**
+     * @brief Hands an event to `handleInput()`, e.g. one a TiledLayout routes to the panel it belongs to.
+     *
+     * @param event The event.
+     */
+    void deliverInput(const InputEvent & event);
+
 protected:
     TerminalControl terminal;   ///< Manages terminal size, clearing, and rendering.
     const bool scaleRatio;      ///< Whether to maintain aspect ratio when resizing
+    int inputDescriptor;        ///< Descriptor input is read from, standard input by default; -1 for none
+    EffectTimeline timeline;    ///< Scripted effects applied to the scaled grid, by frame number since `run()` started
+    SceneScheduler scheduler;   ///< Scene coroutines, ticked before every `update()` and handed every input event
 
     /**
      * @brief Updates the state of the effect.
@@ -60,13 +185,91 @@ protected:
      */
     virtual void update() = 0;
 
+    /**
+     * @brief Fills the terminal's scaled grid with the current frame.
+     *
+     * The default scales the active grid; loops that build the frame
+     * differently, like SceneManager, override it.
+     */
+    virtual void compose();
+
+
+    /**
+     * @brief Writes the finished frame to the terminal.
+     *
+     * The default prints the whole scaled grid; loops that know which parts
+     * of the screen changed, like TiledLayout, override it.
+     */
+    virtual void present();
+
+
+    /**
+     * @brief Returns the number of the frame being rendered, the timeline's clock.
+     *
+     * @return size_t Frames since `run()` started, or the frame passed to `renderOffscreen()`.
+     */
+    size_t getFrameNumber() const;
+
+
+    /**
+     * @brief Exempts frames from the steady-state allocation check, e.g. the frames that build and warm up a new scene.
+     *
+     * Called from `handleInput()`, the count starts with the frame that follows.
+     *
+     * @param frames Number of frames to exempt, starting with the current one.
+     */
+    void allowAllocations(size_t frames = 1);
+
+
     /**
      * @brief Renders the updated state to the terminal.
      *
-     * Clears the terminal screen and prints the contents of the terminal grid.
+     * Composes the frame, applies the timeline's effects for the
+     * current frame, the color grade and ASCII art conversion when enabled, hands the frame to the recorder when recording,
+     * presents it, and releases the frame's temporaries.
      */
     void render();
 
+
+    /**
+     * @brief Requests the loop to end once the current frame has been rendered.
+     */
+    void stop();
+
+
+    /**
+     * @brief Handles one input event; called by `run()` before each frame.
+     *
+     * The default hands the event to scene coroutines waiting for input,
+     * then quits on 'Q'/'q' and on interrupts. Overrides that handle
+     * keys of their own should fall back to this for the rest.
+     *
+     * @param event The event.
+     */
+    virtual void handleInput(const InputEvent & event);
+
+
+    /**
+     * @brief Enables or disables mouse reports while the loop runs.
+     *
+     * Reports are turned on when `run()` starts and off again when it returns.
+     *
+     * @param enabled Whether mouse buttons and the wheel are reported as events.
+     */
+    void setMouseTracking(bool enabled);
+
 private:
     double frameDuration;       ///< Time duration of each frame in milliseconds.
+    bool stopRequested;         ///< Set by `stop()` to end `run()`.
+    bool interrupted;           ///< Set when SIGINT or SIGTERM ended `run()`.
+    size_t frameNumber;         ///< Frames since `run()` started; the timeline's clock.
+    size_t exemptFrames;        ///< Frames still exempt from the allocation check, set by `allowAllocations()`.
+    std::unique_ptr <InputReader> input;    ///< Reads and decodes input on its own thread, null until `run()` is first called.
+    bool mouseTracking;         ///< Whether mouse reports are enabled while the loop runs.
+    bool running;               ///< Whether `run()` is reading input, so mouse tracking changes apply at once.
+    std::unique_ptr <FrameRecorder> recorder;   ///< Active frame recorder, null when not recording.
+    std::unique_ptr <ColorLut> grading;     ///< Color grade applied to the scaled grid, null when not grading.
+    GlyphRamp glyphRamp;        ///< Luminance-to-glyph table used in ASCII art mode.
+    bool asciiArt;              ///< Whether the scaled grid is turned into ASCII art before printing.
+    bool asciiEdges;            ///< Whether ASCII art draws line glyphs along edges.
 };
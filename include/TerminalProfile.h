@@ -0,0 +1,113 @@
+/**
+ * @file TerminalProfile.h
+ * @brief Defines the TerminalProfile class, the detected capabilities of the terminal.
+ */
+
+
+#pragma once
+
+
+#include <string>
+#include <string_view>
+
+
+/**
+ * @class TerminalProfile
+ * @brief What the terminal on standard output can do, detected once and cached on disk.
+ *
+ * Environment variables (`TERM`, `COLORTERM`, `TERM_PROGRAM` and a few
+ * emulator-specific ones) identify the terminal and hint at its features.
+ * The rest comes from querying the terminal itself: XTVERSION for its name
+ * and version and DECRQM for synchronized output, followed by a primary
+ * device attributes request that practically every terminal answers, so
+ * the wait ends as soon as the answers are in. Querying costs a round trip
+ * and up to the timeout, so results are stored per identity in
+ * `$XDG_CACHE_HOME/terminal-fun/capabilities` (or `~/.cache/...`) and later
+ * starts from the same terminal skip the queries. A terminal that only sends
+ * a generic `TERM`, as is usual under ssh or screen, could be any emulator
+ * and is queried on every start instead.
+ *
+ * Queries read the answers from standard input, so they must run after
+ * TerminalControl has turned off canonical mode and echo.
+ */
+class TerminalProfile
+{
+public:
+    std::string identity;           ///< Cache key built from the environment; empty when it cannot tell the terminal from others.
+    std::string version;            ///< XTVERSION answer, e.g. "tmux 3.3a"; empty when not answered.
+    bool trueColor = false;         ///< 24-bit SGR colors; 256-color indices otherwise.
+    bool synchronizedOutput = false;    ///< DEC private mode 2026.
+    bool repeat = false;            ///< REP (repeat preceding character).
+    bool erase = false;             ///< ECH (erase characters).
+    bool unicode = false;           ///< A UTF-8 locale, so block and box-drawing characters print.
+
+
+    /**
+     * @brief Returns the profile of the current terminal.
+     *
+     * The first call of a process uses the cached profile of the terminal's
+     * identity when there is one; otherwise it queries the terminal and
+     * caches the result once the terminal has answered completely. A
+     * terminal without an identity is never cached. Later calls return the
+     * same profile without touching the cache file or the terminal, so a
+     * silent terminal costs the timeout once per process. When standard
+     * input or output is not a terminal only the environment is used and
+     * nothing is cached.
+     *
+     * @param useCache Whether a cached profile may be used; a fresh probe still updates the cache.
+     * @param timeoutMilliseconds Longest wait for the terminal's answers.
+     * @return TerminalProfile The profile.
+     */
+    static TerminalProfile detect(bool useCache = true, int timeoutMilliseconds = 100);
+
+
+    /**
+     * @brief Builds a profile from environment variables alone.
+     *
+     * @return TerminalProfile The profile; capabilities that need a query are guessed conservatively.
+     */
+    static TerminalProfile fromEnvironment();
+
+
+    /**
+     * @brief Queries the terminal and refines the profile with its answers.
+     *
+     * @param timeoutMilliseconds Longest wait for the answers.
+     * @return bool Whether the device attributes answer arrived, so every answer is in.
+     */
+    bool probe(int timeoutMilliseconds);
+
+
+    /**
+     * @brief Returns a one-line summary, e.g. for diagnostics.
+     *
+     * @return std::string The summary.
+     */
+    std::string describe() const;
+
+private:
+    /**
+     * @brief Returns the path of the cache file, empty when no home directory is known.
+     */
+    static std::string cachePath();
+
+
+    /**
+     * @brief Looks up the cached profile of `identity`; a profile without one has no entry.
+     *
+     * @return bool Whether the cache had an entry.
+     */
+    bool loadCached();
+
+
+    /**
+     * @brief Adds or replaces this profile's entry in the cache; failures and profiles without an identity are ignored.
+     */
+    void saveCached() const;
+
+
+    /**
+     * @brief Applies what a terminal name, from XTVERSION or `TERM_PROGRAM`, tells about its features.
+     */
+    void applyKnownTerminal(std::string_view name);
+};
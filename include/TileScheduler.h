@@ -0,0 +1,178 @@
+/**
+ * @file TileScheduler.h
+ * @brief Defines the TileScheduler class, a work-stealing pool that frame stages split their rows or tiles over.
+ */
+
+
+#pragma once
+
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+/**
+ * @class TileScheduler
+ * @brief Process-wide pool of persistent workers running index ranges with work stealing.
+ *
+ * A frame stage hands `parallelFor()` a number of items, usually rows, and a
+ * body that processes a range of them. The range is cut into tiles and each
+ * participant, the calling thread included, gets a contiguous share on its
+ * own deque. Participants take tiles from the front of their own deque and,
+ * once it is empty, steal from the back of the others, so stages whose cost
+ * varies across the frame, like dense and empty regions, still keep every
+ * core busy until the end.
+ *
+ * Workers are started once and sleep between stages. Deques are fixed-size
+ * arrays guarded by spin locks that are held only to move an index, and the
+ * body is passed as a function pointer plus context, so a stage never
+ * allocates. A `parallelFor()` issued from inside a body, or while another
+ * thread's stage is running, runs inline on the calling thread.
+ */
+class TileScheduler
+{
+public:
+    /// Most tiles a stage is cut into; larger stages get larger tiles.
+    static constexpr size_t MAX_TILES = 1024;
+
+    /// Most threads `TERMINAL_THREADS` can ask for.
+    static constexpr size_t MAX_THREADS = 256;
+
+
+    /**
+     * @brief Returns the process-wide scheduler, starting its workers on first use.
+     *
+     * It uses one thread per hardware thread, or as many as the
+     * `TERMINAL_THREADS` environment variable says.
+     *
+     * @return TileScheduler & The scheduler.
+     */
+    static TileScheduler & instance();
+
+
+    /**
+     * @brief Stops and joins the workers.
+     */
+    ~TileScheduler();
+
+
+    TileScheduler(const TileScheduler &) = delete;
+    TileScheduler & operator = (const TileScheduler &) = delete;
+
+
+    /**
+     * @brief Calls `body(begin, end)` over disjoint ranges covering `[0, count)` and returns once all are done.
+     *
+     * @tparam Body Callable taking `(size_t begin, size_t end)`; must not throw.
+     * @param count Number of items.
+     * @param grain Smallest number of items worth a tile of its own.
+     * @param body The body.
+     */
+    template <typename Body>
+    void parallelFor(size_t count, size_t grain, const Body & body)
+    {
+        run(count, grain, [](const void * context, size_t begin, size_t end) { (*static_cast<const Body *>(context))(begin, end); }, &body);
+    }
+
+
+    /**
+     * @brief Returns the number of threads that run tiles, the calling thread included.
+     *
+     * @return size_t The number of participants.
+     */
+    size_t getThreadCount() const;
+
+
+    /**
+     * @brief Limits how many threads later stages use, e.g. to measure scaling.
+     *
+     * @param limit Number of participants, clamped to 1 - `getThreadCount()`.
+     */
+    void setThreadLimit(size_t limit);
+
+
+    /**
+     * @brief Returns the number of threads stages use.
+     *
+     * @return size_t The limit set by `setThreadLimit()`, initially `getThreadCount()`.
+     */
+    size_t getThreadLimit() const;
+
+private:
+    /// Type-erased body.
+    using Function = void (*)(const void * context, size_t begin, size_t end);
+
+
+    /**
+     * @brief A range of items and the body to run over it.
+     */
+    struct Tile
+    {
+        Function function;
+        const void * context;
+        size_t begin;
+        size_t end;
+    };
+
+
+    /**
+     * @brief One participant's tiles: taken from the front by the owner, stolen from the back by the others.
+     */
+    struct alignas(64) Deque
+    {
+        std::atomic_flag lock;              ///< Held while `front` or `back` moves.
+        size_t front = 0;                   ///< Next tile the owner takes.
+        size_t back = 0;                    ///< One past the last tile not yet taken.
+        std::array <Tile, MAX_TILES> tiles; ///< Tiles of the current stage.
+    };
+
+
+    std::vector <std::thread> workers;              ///< Persistent worker threads; participant `i + 1` is `workers[i]`.
+    std::unique_ptr <Deque[]> deques;               ///< One deque per participant; 0 belongs to the calling thread.
+    std::atomic <uint32_t> generation;              ///< Bumped to start a stage or stop the workers.
+    std::atomic <size_t> remaining;                 ///< Tiles of the current stage not yet finished.
+    std::atomic <size_t> threadLimit;               ///< Participants stages are split over.
+    std::atomic_flag busy;                          ///< Set while a stage runs; later stages run inline.
+    bool stopping;                                  ///< Set before the workers are woken to exit.
+
+
+    /**
+     * @brief Starts one worker per additional hardware thread.
+     */
+    TileScheduler();
+
+
+    /**
+     * @brief Cuts a stage into tiles, wakes the workers and works along until every tile is done.
+     */
+    void run(size_t count, size_t grain, Function function, const void * context);
+
+
+    /**
+     * @brief Runs tiles, own ones first and then stolen ones, until none is left.
+     *
+     * @param self Index of the participant.
+     */
+    void work(size_t self);
+
+
+    /**
+     * @brief Takes a tile from a deque.
+     *
+     * @param deque The deque.
+     * @param steal Whether to take from the back instead of the front.
+     * @param tile Receives the tile.
+     * @return bool False if the deque was empty.
+     */
+    static bool take(Deque & deque, bool steal, Tile & tile);
+
+
+    /**
+     * @brief Body of a worker thread: sleeps until a stage starts, then works on it.
+     */
+    void workerLoop(size_t self);
+};
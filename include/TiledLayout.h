@@ -0,0 +1,120 @@
+/**
+ * @file TiledLayout.h
+ * @brief Defines the TiledLayout class that shows several loops side by side in one terminal.
+ */
+
+
+#pragma once
+
+
+#include <memory>
+#include <vector>
+
+
+#include "TerminalLoop.h"
+
+
+/**
+ * @class TiledLayout
+ * @brief Runs several TerminalLoop scenes at once, each scaled into its own rectangle of the terminal.
+ *
+ * Like SceneManager, the layout owns the only printing loop and drives its
+ * panels through `renderOffscreen()`, each scene scaling into a grid the
+ * size of its rectangle. Panels have their own frame rates; the ones due in
+ * a frame render in parallel on the tile scheduler, and only their
+ * rectangles are encoded and sent, the rest of the screen keeping what was
+ * printed before. The whole frame is printed after a resize and while the
+ * layout's own timeline is active.
+ *
+ * Rectangles are fractions of the terminal, so the layout follows resizes;
+ * they should not overlap.
+ *
+ * Only the layout reads input. Mouse reports go to the panel under the
+ * pointer, in the panel's own coordinates, and a press there gives it the
+ * focus; keys go to the focused panel, the first one until another is
+ * clicked, and to the layout, so 'Q'/'q' still quits.
+ */
+class TiledLayout : public TerminalLoop
+{
+public:
+    /**
+     * @brief Constructs a layout without panels.
+     *
+     * @param SceneOptions Options whose scaling settings every panel gets; the rest applies through `configure()`.
+     * @param FrameRate Frame rate of the layout, the highest any panel can run at (FPS).
+     */
+    TiledLayout(const LoopOptions & SceneOptions, double FrameRate = 30.0);
+
+
+    /**
+     * @brief Adds a panel.
+     *
+     * @param scene The loop shown in the panel.
+     * @param top Top edge as a fraction of the terminal height (0-1).
+     * @param left Left edge as a fraction of the terminal width (0-1).
+     * @param height Height as a fraction of the terminal height.
+     * @param width Width as a fraction of the terminal width.
+     * @param FrameRate Frames per second of the panel; 0 or above the layout's rate runs it every frame.
+     */
+    void addPanel(std::unique_ptr <TerminalLoop> scene, double top, double left, double height, double width, double FrameRate = 0.0);
+
+protected:
+    /**
+     * @brief Decides which panels are due this frame.
+     */
+    void update() override;
+
+
+    /**
+     * @brief Renders the due panels in parallel and copies every panel into the printed grid.
+     */
+    void compose() override;
+
+
+    /**
+     * @brief Prints only the rectangles of the panels that rendered, or everything after a resize.
+     */
+    void present() override;
+
+
+    /**
+     * @brief Routes an event to the panel it belongs to.
+     *
+     * @param event The event.
+     */
+    void handleInput(const InputEvent & event) override;
+
+private:
+    /**
+     * @struct Panel
+     * @brief A scene and where and how often it is shown.
+     */
+    struct Panel
+    {
+        std::unique_ptr <TerminalLoop> scene;   ///< The loop shown.
+        double top;                             ///< Top edge, fraction of the terminal height.
+        double left;                            ///< Left edge, fraction of the terminal width.
+        double height;                          ///< Height, fraction of the terminal height.
+        double width;                           ///< Width, fraction of the terminal width.
+        double step;                            ///< Panel frames per layout frame, at most 1.
+        double credit;                          ///< Accumulated `step`; the panel renders when it reaches 1.
+        size_t frame;                           ///< Frames the panel has rendered.
+        bool due;                               ///< Whether the panel renders this frame.
+        FrameEncoder::Region region;            ///< Cells the panel covers at the current terminal size.
+        const std::vector < std::vector < OneSymbol > > * output;   ///< Last frame the panel rendered, null before the first.
+    };
+
+
+    LoopOptions sceneOptions;                   ///< Scaling options applied to every panel.
+    const double frameRate;                     ///< Frame rate of the layout.
+    std::vector <Panel> panels;                 ///< Panels in the order they were added.
+    std::vector <FrameEncoder::Region> changed; ///< Regions of the panels that rendered this frame.
+    bool repaint;                               ///< Whether the whole frame must be printed.
+    size_t focus;                               ///< Index of the panel keys go to.
+
+
+    /**
+     * @brief Recomputes every panel's region for a terminal size and resizes its scene.
+     */
+    void layOut(size_t rows, size_t cols);
+};
@@ -0,0 +1,95 @@
+/**
+ * @file WidgetSwarm.h
+ * @brief Defines a demo of many small widgets, each animated by its own scene coroutine.
+ */
+
+
+#pragma once
+
+
+#include <array>
+#include <cstdint>
+
+
+#include "TerminalLoop.h"
+
+
+/**
+ * @class WidgetSwarm
+ * @brief Dozens of squares that appear, pulse, shrink and rest, each driven by one SceneTask.
+ *
+ * Every widget runs the same four-phase animation with its own timing,
+ * written as a loop of `co_await`s instead of a state machine. Space sets
+ * off a spark: a short-lived task that expands a ring and ends, so its
+ * coroutine frame goes back to the pool and the next spark reuses it.
+ */
+class WidgetSwarm : public TerminalLoop
+{
+public:
+    /**
+     * @brief Constructs the demo and spawns its tasks.
+     *
+     * @param FrameRate Target frame rate for animation. Defaults to 30.0 FPS.
+     * @param ScaleRatio Whether to maintain aspect ratio when scaling. Defaults to true.
+     */
+    WidgetSwarm(double FrameRate = 30.0, bool ScaleRatio = true);
+
+protected:
+    /**
+     * @brief Draws every visible widget and spark; the tasks have already moved them.
+     */
+    void update() override;
+
+private:
+    /**
+     * @struct Widget
+     * @brief A square a task animates and `update()` draws.
+     */
+    struct Widget
+    {
+        size_t row = 0;                 ///< Top row.
+        size_t col = 0;                 ///< Left column.
+        size_t size = 0;                ///< Side length; 0 when hidden.
+        double glow = 1.0;              ///< Brightness factor.
+        bool hollow = false;            ///< Whether only the border is drawn.
+        Color color = Colors::WHITE;    ///< Color at full glow.
+    };
+
+
+    static constexpr size_t WIDGET_COUNT = 32;
+    static constexpr size_t SPARK_COUNT = 16;
+
+
+    std::array <Widget, WIDGET_COUNT> widgets;  ///< Widgets, each owned by one `animate()` task.
+    std::array <Widget, SPARK_COUNT> sparks;    ///< Spark slots; a slot is free while its size is 0.
+    uint32_t sparkSeed;                         ///< Random state of the spark positions.
+
+
+    /**
+     * @brief Appears, pulses, shrinks and rests, forever.
+     *
+     * @param widget The widget to animate.
+     * @param seed Random state deciding its positions, colors and timing.
+     */
+    SceneTask animate(Widget & widget, uint32_t seed);
+
+
+    /**
+     * @brief Sets off a spark on every space.
+     */
+    SceneTask listen();
+
+
+    /**
+     * @brief Expands a ring from a point and fades it out, then ends.
+     *
+     * @param spark The free slot to draw into.
+     */
+    SceneTask spark(Widget & spark);
+
+
+    /**
+     * @brief Draws a widget scaled by its glow.
+     */
+    void draw(const Widget & widget);
+};
@@ -0,0 +1,132 @@
+#include "AllocationCounter.h"
+
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+namespace
+{
+    std::atomic <size_t> allocationCount{0};
+}
+
+
+size_t AllocationCounter::getCount()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+
+#ifdef TERMINAL_COUNT_ALLOCATIONS
+
+
+namespace
+{
+    void * countedAllocate(size_t size, size_t alignment)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+        if (size == 0)
+            size = 1;
+
+        void * pointer = nullptr;
+        if (alignment <= alignof(std::max_align_t))
+            pointer = std::malloc(size);
+        else
+            pointer = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+
+        return pointer;
+    }
+}
+
+
+void * operator new(size_t size)
+{
+    if (void * pointer = countedAllocate(size, alignof(std::max_align_t)))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+
+void * operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+
+void * operator new(size_t size, std::align_val_t alignment)
+{
+    if (void * pointer = countedAllocate(size, size_t(alignment)))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+
+void * operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+
+void * operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size, alignof(std::max_align_t));
+}
+
+
+void * operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size, alignof(std::max_align_t));
+}
+
+
+void operator delete(void * pointer) noexcept
+{
+    std::free(pointer);
+}
+
+
+void operator delete[](void * pointer) noexcept
+{
+    std::free(pointer);
+}
+
+
+void operator delete(void * pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+
+void operator delete[](void * pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+
+void operator delete(void * pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+
+void operator delete[](void * pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+
+void operator delete(void * pointer, size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+
+void operator delete[](void * pointer, size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+
+#endif
@@ -1,4 +1,5 @@
 #include "Color.h"
+#include "ColorSpace.h"
 
 
 bool Color::operator == (const Color & other) const
@@ -16,42 +17,6 @@ bool Color::operator != (const Color & other) const
 }
 
 
-int Color::getRed() const
-{
-    return int(red);
-}
-
-
-int Color::getBlue() const
-{
-    return int(blue);
-}
-
-
-int Color::getGreen() const
-{
-    return int(green);
-}
-
-
-double Color::getR() const
-{
-    return red;
-}
-
-
-double Color::getG() const
-{
-    return green;
-}
-
-
-double Color::getB() const
-{
-    return blue;
-}
-
-
 
 void Color::setColor(const Color newColor)
 {
@@ -218,8 +183,15 @@ void Color::adjustColor(const Color increment)
 }
 
 
-void Color::convertToGrayscale()
+void Color::convertToGrayscale(bool linearLight)
 {
+    if (linearLight)
+    {
+        double gray = (ColorSpace::toLinear(red) + ColorSpace::toLinear(green) + ColorSpace::toLinear(blue)) / 3.0;
+        red = green = blue = ColorSpace::toSrgb(gray);
+        return;
+    }
+
     double gray = (red + green + blue) / 3.0;
     red = green = blue = gray;
 
@@ -227,9 +199,17 @@ void Color::convertToGrayscale()
 }
 
 
-void Color::blendWith(const Color & other, double factor)
+void Color::blendWith(const Color & other, double factor, bool linearLight)
 {
     factor = std::clamp(factor, 0.0, 1.0);
+    if (linearLight)
+    {
+        red = ColorSpace::toSrgb((1 - factor) * ColorSpace::toLinear(red) + factor * ColorSpace::toLinear(other.red));
+        green = ColorSpace::toSrgb((1 - factor) * ColorSpace::toLinear(green) + factor * ColorSpace::toLinear(other.green));
+        blue = ColorSpace::toSrgb((1 - factor) * ColorSpace::toLinear(blue) + factor * ColorSpace::toLinear(other.blue));
+        return;
+    }
+
     red = clampColor((1 - factor) * red + factor * other.red);
     green = clampColor((1 - factor) * green + factor * other.green);
     blue = clampColor((1 - factor) * blue + factor * other.blue);
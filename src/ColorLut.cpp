@@ -0,0 +1,264 @@
+#include "ColorLut.h"
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+
+#include "TileScheduler.h"
+
+
+ColorLut::ColorLut(size_t Size)
+    : size(std::clamp<size_t>(Size, 2, 256)), table(size * size * size * 3)
+{
+    double step = 255.0 / double(size - 1);
+    for (size_t b = 0; b < size; b++)
+        for (size_t g = 0; g < size; g++)
+            for (size_t r = 0; r < size; r++)
+                setPoint(r, g, b, Color(double(r) * step, double(g) * step, double(b) * step));
+}
+
+
+ColorLut ColorLut::loadCube(const std::string & path)
+{
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("cannot open LUT '" + path + "'");
+
+    size_t cubeSize = 0;
+    double domainMin[3] = {0.0, 0.0, 0.0};
+    double domainMax[3] = {1.0, 1.0, 1.0};
+    std::vector <double> values;
+
+    std::string line;
+    for (size_t lineNumber = 1; std::getline(file, line); lineNumber++)
+    {
+        std::istringstream fields(line);
+        std::string keyword;
+        if (!(fields >> keyword) || keyword[0] == '#' || keyword == "TITLE")
+            continue;
+
+        auto fail = [&](const std::string & reason)
+        {
+            return std::runtime_error("'" + path + "' line " + std::to_string(lineNumber) + ": " + reason);
+        };
+
+        if (keyword == "LUT_3D_SIZE")
+        {
+            if (!(fields >> cubeSize) || cubeSize < 2 || cubeSize > 256)
+                throw fail("invalid LUT_3D_SIZE");
+            values.reserve(cubeSize * cubeSize * cubeSize * 3);
+        }
+        else if (keyword == "LUT_1D_SIZE")
+            throw fail("1D LUTs are not supported");
+        else if (keyword == "DOMAIN_MIN" || keyword == "DOMAIN_MAX")
+        {
+            double * domain = keyword == "DOMAIN_MIN" ? domainMin : domainMax;
+            if (!(fields >> domain[0] >> domain[1] >> domain[2]))
+                throw fail("invalid " + keyword);
+        }
+        else if ((keyword[0] >= '0' && keyword[0] <= '9') || keyword[0] == '-' || keyword[0] == '.')
+        {
+            double triplet[3];
+            char * end = nullptr;
+            triplet[0] = std::strtod(keyword.c_str(), &end);
+            if (*end != '\0' || !(fields >> triplet[1] >> triplet[2]))
+                throw fail("invalid table entry");
+            values.insert(values.end(), triplet, triplet + 3);
+        }
+        else if (keyword.find_first_not_of("ABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789") != std::string::npos)
+            throw fail("unexpected '" + keyword + "'");
+        // Other upper-case keywords (e.g. LUT_3D_INPUT_RANGE from some tools) carry nothing we use
+    }
+
+    if (cubeSize == 0)
+        throw std::runtime_error("'" + path + "' has no LUT_3D_SIZE");
+    if (values.size() != cubeSize * cubeSize * cubeSize * 3)
+        throw std::runtime_error("'" + path + "' has " + std::to_string(values.size() / 3) + " entries, expected "
+                                 + std::to_string(cubeSize * cubeSize * cubeSize));
+    for (size_t channel = 0; channel < 3; channel++)
+        if (domainMax[channel] <= domainMin[channel])
+            throw std::runtime_error("'" + path + "' has an empty domain");
+
+    // Entries are listed with red changing fastest, the same order as the table
+    ColorLut lut(cubeSize);
+    for (size_t i = 0; i < lut.table.size(); i++)
+    {
+        size_t channel = i % 3;
+        double normalized = (values[i] - domainMin[channel]) / (domainMax[channel] - domainMin[channel]);
+        lut.table[i] = float(std::clamp(normalized, 0.0, 1.0) * 255.0);
+    }
+
+    return lut;
+}
+
+
+ColorLut ColorLut::preset(std::string_view name, size_t size)
+{
+    if (name == "sepia")
+        return fromFunction([](const Color & color)
+        {
+            double r = color.getR(), g = color.getG(), b = color.getB();
+            return Color(std::min(255.0, 0.393 * r + 0.769 * g + 0.189 * b),
+                         std::min(255.0, 0.349 * r + 0.686 * g + 0.168 * b),
+                         std::min(255.0, 0.272 * r + 0.534 * g + 0.131 * b));
+        }, size);
+
+    if (name == "night")
+        return fromFunction([](const Color & color)
+        {
+            // Red light at reduced brightness preserves dark adaptation
+            double luminance = 0.2126 * color.getR() + 0.7152 * color.getG() + 0.0722 * color.getB();
+            return Color(0.8 * luminance, 0.15 * luminance, 0.05 * luminance);
+        }, size);
+
+    if (name == "deuteranopia")
+        return fromFunction([](const Color & color)
+        {
+            double r = color.getR(), g = color.getG(), b = color.getB();
+
+            // Simulate the missing M cones in LMS space (Viénot, Brettel & Mollon 1999)
+            double l = 17.8824 * r + 43.5161 * g + 4.11935 * b;
+            double s = 0.0299566 * r + 0.184309 * g + 1.46709 * b;
+            double m = 0.494207 * l + 1.24827 * s;
+
+            double simulatedR = 0.0809444479 * l - 0.130504409 * m + 0.116721066 * s;
+            double simulatedG = -0.0102485335 * l + 0.0540193266 * m - 0.113614708 * s;
+            double simulatedB = -0.000365296938 * l - 0.00412161469 * m + 0.693511405 * s;
+
+            // Move the lost contrast into channels the viewer can distinguish
+            double errorR = r - simulatedR, errorG = g - simulatedG, errorB = b - simulatedB;
+            return Color(std::clamp(r, 0.0, 255.0),
+                         std::clamp(g + 0.7 * errorR + errorG, 0.0, 255.0),
+                         std::clamp(b + 0.7 * errorR + errorB, 0.0, 255.0));
+        }, size);
+
+    throw std::invalid_argument("unknown LUT preset '" + std::string(name) + "'");
+}
+
+
+Color ColorLut::apply(const Color & color) const
+{
+    OneSymbol cell(color, color);
+    if (interpolation == Interpolation::Trilinear)
+        applyToRow<Interpolation::Trilinear>(&cell, 1);
+    else
+        applyToRow<Interpolation::Tetrahedral>(&cell, 1);
+
+    return cell.backgroundColor;
+}
+
+
+void ColorLut::applyToGrid(std::vector < std::vector < OneSymbol > > & grid) const
+{
+    size_t rows = grid.size();
+
+    TileScheduler::instance().parallelFor(rows, 1, [&](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; i++)
+        {
+            if (interpolation == Interpolation::Trilinear)
+                applyToRow<Interpolation::Trilinear>(grid[i].data(), grid[i].size());
+            else
+                applyToRow<Interpolation::Tetrahedral>(grid[i].data(), grid[i].size());
+        }
+    });
+
+    return;
+}
+
+
+void ColorLut::setInterpolation(Interpolation newInterpolation)
+{
+    interpolation = newInterpolation;
+
+    return;
+}
+
+
+size_t ColorLut::getSize() const
+{
+    return size;
+}
+
+
+void ColorLut::setPoint(size_t r, size_t g, size_t b, const Color & color)
+{
+    float * point = table.data() + ((b * size + g) * size + r) * 3;
+    point[0] = float(std::clamp(color.getR(), 0.0, 255.0));
+    point[1] = float(std::clamp(color.getG(), 0.0, 255.0));
+    point[2] = float(std::clamp(color.getB(), 0.0, 255.0));
+
+    return;
+}
+
+
+template <ColorLut::Interpolation Mode>
+void ColorLut::applyToRow(OneSymbol * row, size_t count) const
+{
+    const float * points = table.data();
+    const size_t strideR = 3, strideG = 3 * size, strideB = 3 * size * size;
+    const double toGrid = double(size - 1) / 255.0;
+    const size_t lastCell = size - 2;
+
+    // Both colors of a cell go through the same branch-free lookup
+    auto grade = [&](const Color & color) -> Color
+    {
+        double x = std::clamp(color.getR(), 0.0, 255.0) * toGrid;
+        double y = std::clamp(color.getG(), 0.0, 255.0) * toGrid;
+        double z = std::clamp(color.getB(), 0.0, 255.0) * toGrid;
+        size_t r = std::min(size_t(x), lastCell), g = std::min(size_t(y), lastCell), b = std::min(size_t(z), lastCell);
+        double dr = x - double(r), dg = y - double(g), db = z - double(b);
+        const float * base = points + r * strideR + g * strideG + b * strideB;
+
+        double out[3];
+        if constexpr (Mode == Interpolation::Trilinear)
+        {
+            for (size_t c = 0; c < 3; c++)
+            {
+                double c00 = base[c] + dr * (base[c + strideR] - base[c]);
+                double c10 = base[c + strideG] + dr * (base[c + strideG + strideR] - base[c + strideG]);
+                double c01 = base[c + strideB] + dr * (base[c + strideB + strideR] - base[c + strideB]);
+                double c11 = base[c + strideB + strideG] + dr * (base[c + strideB + strideG + strideR] - base[c + strideB + strideG]);
+                double c0 = c00 + dg * (c10 - c00);
+                double c1 = c01 + dg * (c11 - c01);
+                out[c] = c0 + db * (c1 - c0);
+            }
+        }
+        else
+        {
+            // The enclosing tetrahedron runs from the cell origin along the largest,
+            // then the middle, then the smallest fractional offset
+            bool maxIsR = dr >= dg && dr >= db;
+            bool maxIsG = !maxIsR && dg >= db;
+            bool minIsB = db <= dr && db <= dg;
+            bool minIsG = !minIsB && dg <= dr;
+
+            double largest = std::max({dr, dg, db});
+            double smallest = std::min({dr, dg, db});
+            double middle = dr + dg + db - largest - smallest;
+
+            size_t first = maxIsR ? strideR : maxIsG ? strideG : strideB;
+            size_t second = strideR + strideG + strideB - (minIsB ? strideB : minIsG ? strideG : strideR);
+            size_t last = strideR + strideG + strideB;
+
+            for (size_t c = 0; c < 3; c++)
+                out[c] = (1.0 - largest) * base[c] + (largest - middle) * base[c + first]
+                         + (middle - smallest) * base[c + second] + smallest * base[c + last];
+        }
+
+        return Color(out[0], out[1], out[2]);
+    };
+
+    #pragma omp simd
+    for (size_t i = 0; i < count; i++)
+    {
+        row[i].foregroundColor = grade(row[i].foregroundColor);
+        row[i].backgroundColor = grade(row[i].backgroundColor);
+    }
+
+    return;
+}
@@ -0,0 +1,44 @@
+#include "ColorSpace.h"
+
+
+#include <cmath>
+
+
+namespace
+{
+    // IEC 61966-2-1 transfer functions on normalized values
+    double decode(double srgb)
+    {
+        return srgb <= 0.04045 ? srgb / 12.92 : std::pow((srgb + 0.055) / 1.055, 2.4);
+    }
+
+
+    double encode(double linear)
+    {
+        return linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+    }
+}
+
+
+namespace ColorSpace
+{
+    const std::array <uint16_t, 256> SRGB_TO_LINEAR = []
+    {
+        std::array <uint16_t, 256> table{};
+        for (size_t i = 0; i < table.size(); i++)
+            table[i] = uint16_t(std::lround(decode(double(i) / 255.0) * LINEAR_MAX));
+        return table;
+    }();
+
+
+    const std::array <uint8_t, size_t(1) << LINEAR_INDEX_BITS> LINEAR_TO_SRGB = []
+    {
+        std::array <uint8_t, size_t(1) << LINEAR_INDEX_BITS> table{};
+
+        // Each entry covers a bucket of 16-bit values; sample the bucket center
+        double bucket = double(size_t(1) << (16 - LINEAR_INDEX_BITS));
+        for (size_t i = 0; i < table.size(); i++)
+            table[i] = uint8_t(std::lround(encode(std::min(1.0, (double(i) + 0.5) * bucket / LINEAR_MAX)) * 255.0));
+        return table;
+    }();
+}
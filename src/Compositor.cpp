@@ -0,0 +1,165 @@
+#include "Compositor.h"
+
+
+#include <algorithm>
+
+
+#include "GlyphTable.h"
+#include "TerminalEffects.h"
+
+
+Compositor::Compositor(size_t Height, size_t Width)
+    : backdrop(Colors::WHITE, Colors::BLACK), height(Height), width(Width), fullComposite(true) {}
+
+
+Layer & Compositor::addLayer(int zOrder, double opacity)
+{
+    layers.push_back(std::make_unique<Layer>(height, width, zOrder, opacity));
+
+    return *layers.back();
+}
+
+
+void Compositor::removeLayer(const Layer & layer)
+{
+    std::erase_if(layers, [&layer](const std::unique_ptr<Layer> & candidate) { return candidate.get() == &layer; });
+    fullComposite = true;
+
+    return;
+}
+
+
+void Compositor::resize(size_t newHeight, size_t newWidth)
+{
+    height = newHeight;
+    width = newWidth;
+    for (auto & layer : layers)
+        layer->resize(height, width);
+    fullComposite = true;
+
+    return;
+}
+
+
+void Compositor::setBackdrop(const OneSymbol & oneSymbol)
+{
+    backdrop = oneSymbol;
+    fullComposite = true;
+
+    return;
+}
+
+
+size_t Compositor::composite(std::vector < std::vector < OneSymbol > > & target)
+{
+    if (target.size() != height || (height > 0 && target.front().size() != width))
+    {
+        target.resize(height);
+        for (auto & row : target)
+            row.resize(width);
+        fullComposite = true;
+    }
+
+    bool anyDirty = fullComposite;
+    for (const auto & layer : layers)
+        anyDirty = anyDirty || layer->dirty;
+    if (!anyDirty)
+        return 0;
+
+    sortLayers();
+
+    size_t tileRows = (height + Layer::TILE_ROWS - 1) / Layer::TILE_ROWS;
+    size_t tileCols = (width + Layer::TILE_COLS - 1) / Layer::TILE_COLS;
+    size_t composed = 0;
+
+    for (size_t tileRow = 0; tileRow < tileRows; tileRow++)
+        for (size_t tileCol = 0; tileCol < tileCols; tileCol++)
+        {
+            size_t tile = tileRow * tileCols + tileCol;
+            bool tileDirty = fullComposite;
+            for (size_t i = 0; i < layers.size() && !tileDirty; i++)
+                tileDirty = layers[i]->dirty && layers[i]->dirtyTiles[tile];
+
+            if (tileDirty)
+            {
+                compositeTile(target, tileRow, tileCol);
+                composed++;
+            }
+        }
+
+    for (auto & layer : layers)
+        layer->markClean();
+    fullComposite = false;
+
+    return composed;
+}
+
+
+void Compositor::sortLayers()
+{
+    auto lower = [](const std::unique_ptr<Layer> & a, const std::unique_ptr<Layer> & b) { return a->zOrder < b->zOrder; };
+    if (std::is_sorted(layers.begin(), layers.end(), lower))
+        return;
+
+    // Insertion sort keeps equal z-orders in insertion order and, unlike std::stable_sort, never allocates
+    for (auto it = layers.begin(); it != layers.end(); ++it)
+        std::rotate(std::upper_bound(layers.begin(), it, *it, lower), it, it + 1);
+
+    return;
+}
+
+
+void Compositor::compositeTile(std::vector < std::vector < OneSymbol > > & target, size_t tileRow, size_t tileCol) const
+{
+    size_t firstRow = tileRow * Layer::TILE_ROWS;
+    size_t lastRow = std::min(firstRow + Layer::TILE_ROWS, height);
+    size_t tileLeft = tileCol * Layer::TILE_COLS;
+    size_t tileRight = std::min(tileLeft + Layer::TILE_COLS, width);
+
+    // Everything below the topmost opaque layer is hidden
+    size_t bottom = layers.size();
+    while (bottom > 0 && !layers[bottom - 1]->isOpaque())
+        bottom--;
+
+    for (size_t row = firstRow; row < lastRow; row++)
+    {
+        // A wide glyph across the tile border is recomposed whole; the neighbouring column comes out the same from either tile
+        size_t firstCol = tileLeft, lastCol = tileRight;
+        while (firstCol > 0 && splitsWideGlyph(row, firstCol, bottom))
+            firstCol--;
+        while (lastCol < width && splitsWideGlyph(row, lastCol, bottom))
+            lastCol++;
+
+        size_t count = lastCol - firstCol;
+        OneSymbol * destination = target[row].data() + firstCol;
+        size_t first = bottom;
+
+        if (bottom > 0)
+            std::copy_n(layers[bottom - 1]->grid[row].data() + firstCol, count, destination);
+        else
+        {
+            std::fill_n(destination, count, backdrop);
+            first = 0;
+        }
+
+        for (size_t i = first; i < layers.size(); i++)
+        {
+            const Layer & layer = *layers[i];
+            if (layer.isDrawn() && layer.transparentCells < layer.coverage.size())
+                TerminalEffects::blendRow(destination, layer.grid[row].data() + firstCol, count, layer.opacity,
+                                          layer.coverage.data() + row * width + firstCol);
+        }
+    }
+
+    return;
+}
+
+
+bool Compositor::splitsWideGlyph(size_t row, size_t col, size_t bottom) const
+{
+    for (size_t i = bottom > 0 ? bottom - 1 : 0; i < layers.size(); i++)
+        if (layers[i]->grid[row][col].symbol == GlyphTable::CONTINUATION)
+            return true;
+
+    return false;
+}
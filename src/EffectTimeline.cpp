@@ -0,0 +1,161 @@
+#include "EffectTimeline.h"
+
+
+#include <algorithm>
+
+
+#include "TileScheduler.h"
+
+
+namespace
+{
+    /**
+     * @brief Maps the linear progress between two keyframes (0-1) onto an easing curve.
+     */
+    double ease(EffectTimeline::Easing easing, double t)
+    {
+        switch (easing)
+        {
+            case EffectTimeline::Easing::Step: return t < 1.0 ? 0.0 : 1.0;
+            case EffectTimeline::Easing::Linear: return t;
+            case EffectTimeline::Easing::EaseIn: return t * t;
+            case EffectTimeline::Easing::EaseOut: return 1.0 - (1.0 - t) * (1.0 - t);
+            case EffectTimeline::Easing::EaseInOut: return t * t * (3.0 - 2.0 * t);
+        }
+        return t;
+    }
+
+
+    inline double clampChannel(double value)
+    {
+        return std::clamp(value, 0.0, 255.0);
+    }
+}
+
+
+EffectTimeline::Track & EffectTimeline::Track::key(size_t frame, double value, Easing easing)
+{
+    auto position = std::lower_bound(keyframes.begin(), keyframes.end(), frame, [](const Keyframe & keyframe, size_t f) { return keyframe.frame < f; });
+    if (position != keyframes.end() && position->frame == frame)
+        *position = Keyframe{frame, value, easing};
+    else
+        keyframes.insert(position, Keyframe{frame, value, easing});
+
+    return *this;
+}
+
+
+double EffectTimeline::Track::valueAt(size_t frame) const
+{
+    if (keyframes.empty())
+        return 0.0;
+    if (frame <= keyframes.front().frame)
+        return keyframes.front().value;
+    if (frame >= keyframes.back().frame)
+        return keyframes.back().value;
+
+    auto next = std::upper_bound(keyframes.begin(), keyframes.end(), frame, [](size_t f, const Keyframe & keyframe) { return f < keyframe.frame; });
+    const Keyframe & before = *(next - 1);
+    double t = double(frame - before.frame) / double(next->frame - before.frame);
+
+    return before.value + (next->value - before.value) * ease(next->easing, t);
+}
+
+
+EffectTimeline::Track & EffectTimeline::brightness(size_t firstFrame, size_t lastFrame)
+{
+    return addTrack(Effect::Brightness, firstFrame, lastFrame, Colors::BLACK, Colors::BLACK);
+}
+
+
+EffectTimeline::Track & EffectTimeline::colorIncrement(size_t firstFrame, size_t lastFrame, const Color & foreground, const Color & background)
+{
+    return addTrack(Effect::ColorIncrement, firstFrame, lastFrame, foreground, background);
+}
+
+
+EffectTimeline::Track & EffectTimeline::blend(size_t firstFrame, size_t lastFrame, const Color & target)
+{
+    return addTrack(Effect::Blend, firstFrame, lastFrame, target, target);
+}
+
+
+void EffectTimeline::clear()
+{
+    tracks.clear();
+    steps.clear();
+
+    return;
+}
+
+
+bool EffectTimeline::isActive(size_t frame) const
+{
+    return std::any_of(tracks.begin(), tracks.end(), [frame](const Track & track) { return frame >= track.firstFrame && frame <= track.lastFrame; });
+}
+
+
+bool EffectTimeline::apply(std::vector < std::vector < OneSymbol > > & grid, size_t frame)
+{
+    steps.clear();
+    for (const Track & track : tracks)
+    {
+        if (frame < track.firstFrame || frame > track.lastFrame)
+            continue;
+
+        // Neutral values would cost a pass without changing anything
+        double value = track.valueAt(frame);
+        if (value == 0.0)
+            continue;
+
+        Step step{1.0, {value, value, value}, {value, value, value}};
+        if (track.effect == Effect::ColorIncrement)
+            step = Step{1.0, {value * track.foreground.getR(), value * track.foreground.getG(), value * track.foreground.getB()},
+                        {value * track.background.getR(), value * track.background.getG(), value * track.background.getB()}};
+        else if (track.effect == Effect::Blend)
+        {
+            double factor = std::clamp(value, 0.0, 1.0);
+            step = Step{1.0 - factor, {factor * track.foreground.getR(), factor * track.foreground.getG(), factor * track.foreground.getB()},
+                        {factor * track.background.getR(), factor * track.background.getG(), factor * track.background.getB()}};
+        }
+        steps.push_back(step);
+    }
+
+    if (steps.empty())
+        return false;
+
+    const Step * first = steps.data();
+    const Step * last = first + steps.size();
+    size_t rows = grid.size();
+
+    TileScheduler::instance().parallelFor(rows, 1, [&](size_t firstRow, size_t lastRow)
+    {
+        for (size_t i = firstRow; i < lastRow; i++)
+        {
+            for (OneSymbol & cell : grid[i])
+            {
+                double foreground[3] = {cell.foregroundColor.getR(), cell.foregroundColor.getG(), cell.foregroundColor.getB()};
+                double background[3] = {cell.backgroundColor.getR(), cell.backgroundColor.getG(), cell.backgroundColor.getB()};
+                for (const Step * step = first; step != last; step++)
+                    for (size_t c = 0; c < 3; c++)
+                    {
+                        foreground[c] = clampChannel(foreground[c] * step->scale + step->foreground[c]);
+                        background[c] = clampChannel(background[c] * step->scale + step->background[c]);
+                    }
+                cell.foregroundColor.setColor(foreground[0], foreground[1], foreground[2]);
+                cell.backgroundColor.setColor(background[0], background[1], background[2]);
+            }
+        }
+    });
+
+    return true;
+}
+
+
+EffectTimeline::Track & EffectTimeline::addTrack(Effect effect, size_t firstFrame, size_t lastFrame, const Color & foreground, const Color & background)
+{
+    tracks.push_back(Track{effect, firstFrame, lastFrame, foreground, background, {}});
+    steps.reserve(tracks.size());
+
+    return tracks.back();
+}
@@ -0,0 +1,65 @@
+#include "FrameArena.h"
+
+
+FrameArena::FrameArena(size_t InitialCapacity)
+    : block(std::make_unique<std::byte[]>(InitialCapacity)), capacity(InitialCapacity), offset(0), overflowBytes(0) {}
+
+
+void FrameArena::reset()
+{
+    if (!overflow.empty())
+    {
+        // Grow once to the frame's total usage so the next frame stays in one block
+        capacity = offset + overflowBytes + overflowBytes / 2;
+        overflow.clear();
+        block = std::make_unique<std::byte[]>(capacity);
+    }
+
+    offset = 0;
+    overflowBytes = 0;
+
+    return;
+}
+
+
+size_t FrameArena::getUsed() const
+{
+    return offset + overflowBytes;
+}
+
+
+size_t FrameArena::getCapacity() const
+{
+    return capacity;
+}
+
+
+void * FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+    size_t aligned = (offset + alignment - 1) & ~(alignment - 1);
+    if (aligned + bytes <= capacity)
+    {
+        offset = aligned + bytes;
+        return block.get() + aligned;
+    }
+
+    // Overflow blocks come from operator new[], which honours fundamental alignment only
+    size_t padded = bytes + alignment;
+    overflow.push_back(std::make_unique<std::byte[]>(padded));
+    overflowBytes += padded;
+
+    void * pointer = overflow.back().get();
+    return std::align(alignment, bytes, pointer, padded);
+}
+
+
+void FrameArena::do_deallocate(void *, size_t, size_t)
+{
+    return;
+}
+
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource & other) const noexcept
+{
+    return this == &other;
+}
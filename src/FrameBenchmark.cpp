@@ -0,0 +1,206 @@
+#include "FrameBenchmark.h"
+
+
+#include <chrono>
+#include <iomanip>
+#include <random>
+
+
+#include "TileScheduler.h"
+
+
+namespace
+{
+    std::vector < std::vector < OneSymbol > > makeGrid(size_t height, size_t width)
+    {
+        return std::vector < std::vector < OneSymbol > >(height, std::vector <OneSymbol>(width, OneSymbol(' ', Colors::WHITE, Colors::BLACK)));
+    }
+
+
+    std::string_view spansName(FrameEncoder::Spans spans)
+    {
+        switch (spans)
+        {
+            case FrameEncoder::Spans::None: return "none";
+            case FrameEncoder::Spans::Plain: return "plain";
+            case FrameEncoder::Spans::Erase: return "erase";
+            case FrameEncoder::Spans::Repeat: return "repeat";
+        }
+        return "";
+    }
+
+
+    /**
+     * @brief Returns the encoding throughput in millions of cells per second, which equals cells per microsecond.
+     */
+    double cellsPerMicrosecond(const std::vector < std::vector < OneSymbol > > & grid, double microseconds)
+    {
+        return double(grid.size() * grid.front().size()) / std::max(microseconds, 1e-9);
+    }
+}
+
+
+FrameBenchmark::FrameBenchmark(size_t Height, size_t Width, size_t Iterations)
+    : iterations(Iterations)
+{
+    std::mt19937 random(42);
+
+    Scene gradient{"gradient", makeGrid(Height, Width)};
+    for (size_t i = 0; i < Height; i++)
+    {
+        double level = 255.0 * double(i) / double(std::max<size_t>(Height - 1, 1));
+        for (auto & cell : gradient.grid[i])
+            cell.backgroundColor.setColor(level, level, level);
+    }
+    scenes.push_back(std::move(gradient));
+
+    Scene text{"text", makeGrid(Height, Width)};
+    std::uniform_int_distribution <int> letter('a', 'z');
+    for (size_t i = 1; i < Height; i += 2)
+    {
+        for (size_t j = 2; j < Width * 2 / 3; j++)
+        {
+            OneSymbol & cell = text.grid[i][j];
+            cell.backgroundColor.setColor(20, 20, 40);
+            cell.symbol = j % 7 == 0 ? ' ' : GlyphId(letter(random));
+            cell.foregroundColor.setColor(j % 23 < 4 ? Colors::YELLOW : Colors::WHITE);
+        }
+    }
+    scenes.push_back(std::move(text));
+
+    Scene noise{"noise", makeGrid(Height, Width)};
+    std::uniform_int_distribution <int> component(0, 255);
+    for (auto & row : noise.grid)
+        for (auto & cell : row)
+            cell.backgroundColor.setColor(component(random), component(random), component(random));
+    scenes.push_back(std::move(noise));
+}
+
+
+void FrameBenchmark::run(std::ostream & report)
+{
+    report << "frame benchmark: " << scenes.front().grid.size() << " x " << scenes.front().grid.front().size()
+           << " cells, " << iterations << " encodes per measurement\n";
+    reportSpans(report);
+    reportColors(report);
+    reportThreads(report);
+
+    return;
+}
+
+
+void FrameBenchmark::reportSpans(std::ostream & report)
+{
+    report << "\nspan encoding (full color)\n"
+           << std::left << std::setw(10) << "scene" << std::setw(8) << "spans"
+           << std::right << std::setw(10) << "bytes" << std::setw(9) << "ratio" << std::setw(12) << "us/frame" << std::setw(12) << "Mcells/s" << "\n";
+
+    FrameEncoder encoder;
+    for (const Scene & scene : scenes)
+    {
+        size_t baseline = 0;
+        for (FrameEncoder::Spans spans : {FrameEncoder::Spans::None, FrameEncoder::Spans::Plain, FrameEncoder::Spans::Erase, FrameEncoder::Spans::Repeat})
+        {
+            encoder.setSpans(spans);
+            size_t bytes = 0;
+            double microseconds = timeEncode(encoder, scene, bytes);
+            if (spans == FrameEncoder::Spans::None)
+                baseline = bytes;
+
+            report << std::left << std::setw(10) << scene.name << std::setw(8) << spansName(spans)
+                   << std::right << std::setw(10) << bytes << std::setw(8) << std::fixed << std::setprecision(1)
+                   << double(baseline) / double(std::max<size_t>(bytes, 1)) << "x" << std::setw(12) << microseconds
+                   << std::setw(12) << cellsPerMicrosecond(scene.grid, microseconds) << "\n";
+        }
+    }
+
+    return;
+}
+
+
+void FrameBenchmark::reportColors(std::ostream & report)
+{
+    report << "\ncolor encoding (every cell on its own)\n"
+           << std::left << std::setw(10) << "scene" << std::setw(11) << "palette"
+           << std::right << std::setw(10) << "bytes" << std::setw(12) << "us/frame" << std::setw(12) << "Mcells/s" << "\n";
+
+    FrameEncoder encoder;
+    encoder.setSpans(FrameEncoder::Spans::None);
+    for (const Scene & scene : scenes)
+    {
+        for (FrameEncoder::Palette palette : {FrameEncoder::Palette::TrueColor, FrameEncoder::Palette::Indexed})
+        {
+            encoder.setPalette(palette);
+            size_t bytes = 0;
+            double microseconds = timeEncode(encoder, scene, bytes);
+
+            report << std::left << std::setw(10) << scene.name << std::setw(11) << (palette == FrameEncoder::Palette::TrueColor ? "truecolor" : "256")
+                   << std::right << std::setw(10) << bytes << std::setw(12) << std::fixed << std::setprecision(1) << microseconds
+                   << std::setw(12) << cellsPerMicrosecond(scene.grid, microseconds) << "\n";
+        }
+    }
+
+    return;
+}
+
+
+void FrameBenchmark::reportThreads(std::ostream & report)
+{
+    TileScheduler & scheduler = TileScheduler::instance();
+    size_t available = scheduler.getThreadCount();
+
+    report << "\nparallel row encoding (plain spans, " << available << " threads available)\n"
+           << std::left << std::setw(10) << "scene" << std::right << std::setw(8) << "threads"
+           << std::setw(12) << "us/frame" << std::setw(12) << "Mcells/s" << std::setw(10) << "speedup" << "\n";
+
+    FrameEncoder encoder;
+    for (const Scene & scene : scenes)
+    {
+        double single = 0.0;
+        for (size_t threads = 1; threads <= available; threads = threads < available && threads * 2 > available ? available : threads * 2)
+        {
+            scheduler.setThreadLimit(threads);
+            double microseconds = timeParallelEncode(encoder, scene);
+            if (threads == 1)
+                single = microseconds;
+
+            report << std::left << std::setw(10) << scene.name << std::right << std::setw(8) << threads
+                   << std::setw(12) << std::fixed << std::setprecision(1) << microseconds
+                   << std::setw(12) << cellsPerMicrosecond(scene.grid, microseconds)
+                   << std::setw(9) << single / std::max(microseconds, 1e-9) << "x\n";
+            if (threads == available)
+                break;
+        }
+    }
+    scheduler.setThreadLimit(available);
+
+    return;
+}
+
+
+double FrameBenchmark::timeEncode(const FrameEncoder & encoder, const Scene & scene, size_t & bytes)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        bytes = encoder.encode(scene.grid, arena).size();
+        arena.reset();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / double(std::max<size_t>(iterations, 1));
+}
+
+
+double FrameBenchmark::timeParallelEncode(const FrameEncoder & encoder, const Scene & scene)
+{
+    char * buffer = arena.allocateArray<char>(FrameEncoder::maxEncodedSize(scene.grid));
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+        encoder.encodeParallel(scene.grid, buffer);
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    arena.reset();
+
+    return elapsed.count() / double(std::max<size_t>(iterations, 1));
+}
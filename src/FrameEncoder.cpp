@@ -0,0 +1,541 @@
+#include "FrameEncoder.h"
+
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+
+#include "TileScheduler.h"
+
+
+namespace
+{
+    /// Resets all attributes.
+    constexpr std::string_view RESET = "\033[0m";
+
+
+    /**
+     * @brief A pre-rendered `;NNN` SGR parameter.
+     */
+    struct Fragment
+    {
+        char text[4];       ///< `;` and up to three digits; unused bytes are zero.
+        uint8_t length;     ///< Bytes used, 2-4.
+    };
+
+
+    /// `;0` to `;255`, so a color component costs one 4-byte copy instead of divisions and branches.
+    constexpr std::array <Fragment, 256> COMPONENT_FRAGMENTS = []
+    {
+        std::array <Fragment, 256> table{};
+        for (int value = 0; value < 256; value++)
+        {
+            Fragment & fragment = table[size_t(value)];
+            size_t length = 0;
+            fragment.text[length++] = ';';
+            if (value >= 100)
+                fragment.text[length++] = char('0' + value / 100);
+            if (value >= 10)
+                fragment.text[length++] = char('0' + value / 10 % 10);
+            fragment.text[length++] = char('0' + value % 10);
+            fragment.length = uint8_t(length);
+        }
+        return table;
+    }();
+
+
+    /**
+     * @brief Writes `;` and a color component (0-255) in decimal without leading zeros.
+     */
+    inline char * writeComponent(char * out, int value)
+    {
+        const Fragment & fragment = COMPONENT_FRAGMENTS[size_t(std::clamp(value, 0, 255))];
+        std::memcpy(out, fragment.text, sizeof(fragment.text));
+        return out + fragment.length;
+    }
+
+
+    /**
+     * @brief Writes a count in decimal without leading zeros.
+     */
+    inline char * writeCount(char * out, size_t value)
+    {
+        char digits[20];
+        size_t length = 0;
+        do
+        {
+            digits[length++] = char('0' + value % 10);
+            value /= 10;
+        }
+        while (value > 0);
+
+        while (length > 0)
+            *out++ = digits[--length];
+
+        return out;
+    }
+
+
+    /**
+     * @brief Writes `ESC [ count final`, e.g. ECH, CUF or REP.
+     */
+    inline char * writeCountSequence(char * out, size_t count, char final)
+    {
+        *out++ = '\033';
+        *out++ = '[';
+        out = writeCount(out, count);
+        *out++ = final;
+
+        return out;
+    }
+
+
+    /// Shortest run worth an ECH and cursor move, which cost at least 8 bytes.
+    constexpr size_t MIN_ERASE_RUN = 9;
+
+    /// Shortest run worth a REP, which costs at least 4 bytes after the first glyph.
+    constexpr size_t MIN_REPEAT_RUN = 6;
+
+
+    /// Longest run of unchanged cells a diff span absorbs instead of starting a new span.
+    constexpr size_t MAX_DIFF_GAP = 4;
+
+    /// Slices per thread of a parallel encode, so threads that got cheap rows help with the rest.
+    constexpr size_t SLICES_PER_THREAD = 4;
+
+
+    /**
+     * @brief Writes CUP, moving the cursor to a 1-based row and column.
+     */
+    inline char * writeCursorPosition(char * out, size_t row, size_t col)
+    {
+        *out++ = '\033';
+        *out++ = '[';
+        out = writeCount(out, row);
+        *out++ = ';';
+        out = writeCount(out, col);
+        *out++ = 'H';
+
+        return out;
+    }
+
+
+    inline bool sameColor(const Color & first, const Color & second)
+    {
+        // Compared as printed, so colors that differ below one step still merge
+        return first.getRed() == second.getRed() && first.getGreen() == second.getGreen() && first.getBlue() == second.getBlue();
+    }
+
+
+    /**
+     * @brief Copies the pre-encoded bytes of a glyph.
+     *
+     * The whole fixed-size entry is copied, which compiles to two moves, so
+     * `out` needs `GlyphTable::MAX_GLYPH_BYTES` bytes of room; only `length` count.
+     */
+    inline char * writeGlyph(char * out, const GlyphTable::Glyph & glyph)
+    {
+        std::memcpy(out, glyph.bytes, GlyphTable::MAX_GLYPH_BYTES);
+        return out + glyph.length;
+    }
+
+
+    inline char * writeLiteral(char * out, std::string_view literal)
+    {
+        std::memcpy(out, literal.data(), literal.size());
+        return out + literal.size();
+    }
+
+
+    /// Channel levels of the 6x6x6 color cube in the xterm 256-color palette.
+    constexpr int CUBE_LEVELS[6] = {0, 95, 135, 175, 215, 255};
+
+
+    /// Nearest cube level of every channel value.
+    constexpr std::array <uint8_t, 256> CUBE_INDEX = []
+    {
+        std::array <uint8_t, 256> table{};
+        for (int value = 0; value < 256; value++)
+        {
+            int nearest = 0;
+            for (int level = 1; level < 6; level++)
+                if (std::abs(CUBE_LEVELS[level] - value) < std::abs(CUBE_LEVELS[nearest] - value))
+                    nearest = level;
+            table[size_t(value)] = uint8_t(nearest);
+        }
+        return table;
+    }();
+
+
+    /**
+     * @brief Maps a color to the closest entry of the 6x6x6 cube (16-231) or the gray ramp (232-255).
+     */
+    inline int toIndexed(const Color & color)
+    {
+        int red = std::clamp(color.getRed(), 0, 255), green = std::clamp(color.getGreen(), 0, 255), blue = std::clamp(color.getBlue(), 0, 255);
+        int r = CUBE_INDEX[size_t(red)], g = CUBE_INDEX[size_t(green)], b = CUBE_INDEX[size_t(blue)];
+
+        // Gray ramp entries are 8, 18, ..., 238
+        int gray = std::clamp(((red + green + blue) / 3 - 3) / 10, 0, 23);
+        int grayLevel = 8 + 10 * gray;
+
+        auto distance = [&](int toRed, int toGreen, int toBlue)
+        {
+            return (red - toRed) * (red - toRed) + (green - toGreen) * (green - toGreen) + (blue - toBlue) * (blue - toBlue);
+        };
+
+        if (distance(grayLevel, grayLevel, grayLevel) < distance(CUBE_LEVELS[r], CUBE_LEVELS[g], CUBE_LEVELS[b]))
+            return 232 + gray;
+        return 16 + 36 * r + 6 * g + b;
+    }
+
+
+    /**
+     * @brief Writes an SGR color, e.g. `ESC [ 38;2;r;g;b m` or `ESC [ 38;5;n m`.
+     *
+     * @param prefix `ESC [ 38;` for the foreground or `ESC [ 48;` for the background.
+     */
+    inline char * writeColor(char * out, std::string_view prefix, const Color & color, FrameEncoder::Palette palette)
+    {
+        out = writeLiteral(out, prefix);
+        if (palette == FrameEncoder::Palette::Indexed)
+        {
+            *out++ = '5';
+            out = writeComponent(out, toIndexed(color));
+        }
+        else
+        {
+            *out++ = '2';
+            out = writeComponent(out, color.getRed());
+            out = writeComponent(out, color.getGreen());
+            out = writeComponent(out, color.getBlue());
+        }
+        *out++ = 'm';
+
+        return out;
+    }
+}
+
+
+size_t FrameEncoder::encodeCell(const OneSymbol & oneSymbol, char * out, Mode mode, Palette palette)
+{
+    const GlyphTable::Glyph & glyph = GlyphTable::get(oneSymbol.symbol);
+    if (glyph.length == 0)
+        return 0;
+
+    char * cursor = out;
+    if (mode != Mode::Monochrome)
+        cursor = writeColor(cursor, "\033[38;", oneSymbol.foregroundColor, palette);
+    if (mode == Mode::Full)
+        cursor = writeColor(cursor, "\033[48;", oneSymbol.backgroundColor, palette);
+    cursor = writeGlyph(cursor, glyph);
+    if (mode == Mode::Full)
+        cursor = writeLiteral(cursor, RESET);
+
+    return size_t(cursor - out);
+}
+
+
+size_t FrameEncoder::maxEncodedSize(const std::vector < std::vector < OneSymbol > > & grid)
+{
+    if (grid.empty())
+        return 0;
+
+    return grid.size() * grid.front().size() * MAX_CELL_BYTES + RESET.size();
+}
+
+
+size_t FrameEncoder::maxDiffSize(const std::vector < std::vector < OneSymbol > > & grid)
+{
+    if (grid.empty())
+        return 0;
+
+    return maxEncodedSize(grid) + grid.size() * grid.front().size() * MAX_CURSOR_BYTES;
+}
+
+
+size_t FrameEncoder::encode(const std::vector < std::vector < OneSymbol > > & grid, char * out) const
+{
+    char * cursor = out + encodeRows(grid, nullptr, 0, grid.size(), out);
+    if (mode == Mode::ForegroundOnly)
+        cursor = writeLiteral(cursor, RESET);
+
+    return size_t(cursor - out);
+}
+
+
+size_t FrameEncoder::encodeDiff(const std::vector < std::vector < OneSymbol > > & grid,
+                               const std::vector < std::vector < OneSymbol > > & previous, char * out) const
+{
+    char * cursor = out + encodeRows(grid, &previous, 0, grid.size(), out);
+    if (mode == Mode::ForegroundOnly)
+        cursor = writeLiteral(cursor, RESET);
+
+    return size_t(cursor - out);
+}
+
+
+size_t FrameEncoder::encodeSlices(const std::vector < std::vector < OneSymbol > > & grid,
+                                 const std::vector < std::vector < OneSymbol > > * previous, char * out, iovec * slices) const
+{
+    size_t rows = grid.size();
+    if (rows == 0)
+        return 0;
+
+    // Every row gets a fixed share of the buffer, so slices can be written without knowing each other's sizes
+    size_t threads = TileScheduler::instance().getThreadLimit();
+    size_t count = std::min({rows, MAX_SLICES, threads > 1 ? threads * SLICES_PER_THREAD : size_t(1)});
+    size_t rowBytes = grid.front().size() * (previous != nullptr ? MAX_CELL_BYTES + MAX_CURSOR_BYTES : MAX_CELL_BYTES);
+
+    TileScheduler::instance().parallelFor(count, 1, [&](size_t first, size_t last)
+    {
+        for (size_t s = first; s < last; s++)
+        {
+            size_t firstRow = s * rows / count, lastRow = (s + 1) * rows / count;
+            char * start = out + firstRow * rowBytes;
+            char * cursor = start + encodeRows(grid, previous, firstRow, lastRow, start);
+
+            // The last slice's share includes the room for the final reset
+            if (lastRow == rows && mode == Mode::ForegroundOnly)
+                cursor = writeLiteral(cursor, RESET);
+            slices[s] = iovec{start, size_t(cursor - start)};
+        }
+    });
+
+    return count;
+}
+
+
+size_t FrameEncoder::encodeParallel(const std::vector < std::vector < OneSymbol > > & grid, char * out) const
+{
+    iovec slices[MAX_SLICES];
+    size_t count = encodeSlices(grid, nullptr, out, slices);
+
+    // Slices start at or after the end of the bytes before them, so moving each down in order is safe
+    char * cursor = out;
+    for (size_t s = 0; s < count; s++)
+    {
+        std::memmove(cursor, slices[s].iov_base, slices[s].iov_len);
+        cursor += slices[s].iov_len;
+    }
+
+    return size_t(cursor - out);
+}
+
+
+size_t FrameEncoder::maxRegionSize(const Region & region)
+{
+    // One extra cell per row for a wide glyph straddling the left edge
+    return region.height * ((region.width + 1) * MAX_CELL_BYTES + MAX_CURSOR_BYTES) + RESET.size();
+}
+
+
+size_t FrameEncoder::encodeRegion(const std::vector < std::vector < OneSymbol > > & grid, const Region & region, char * out) const
+{
+    char * cursor = out;
+    size_t lastRow = std::min(region.top + region.height, grid.size());
+    for (size_t i = region.top; i < lastRow; i++)
+    {
+        const OneSymbol * row = grid[i].data();
+        size_t first = region.left, last = std::min(region.left + region.width, grid[i].size());
+        if (first >= last)
+            continue;
+
+        // A region starting on a right half repaints the wide glyph it belongs to
+        if (first > 0 && row[first].symbol == GlyphTable::CONTINUATION)
+            first--;
+
+        cursor = writeCursorPosition(cursor, i + 1, first + 1);
+        if (spans != Spans::None)
+            cursor += encodeRow(row + first, last - first, cursor);
+        else
+            for (size_t k = first; k < last; k++)
+                cursor += encodeCell(row[k], cursor, mode, palette);
+    }
+
+    if (mode == Mode::ForegroundOnly)
+        cursor = writeLiteral(cursor, RESET);
+
+    return size_t(cursor - out);
+}
+
+
+std::string_view FrameEncoder::encode(const std::vector < std::vector < OneSymbol > > & grid, FrameArena & arena) const
+{
+    char * buffer = arena.allocateArray<char>(maxEncodedSize(grid));
+    return std::string_view(buffer, encode(grid, buffer));
+}
+
+
+void FrameEncoder::setMode(Mode newMode)
+{
+    mode = newMode;
+
+    return;
+}
+
+
+FrameEncoder::Mode FrameEncoder::getMode() const
+{
+    return mode;
+}
+
+
+void FrameEncoder::setSpans(Spans newSpans)
+{
+    spans = newSpans;
+
+    return;
+}
+
+
+FrameEncoder::Spans FrameEncoder::getSpans() const
+{
+    return spans;
+}
+
+
+size_t FrameEncoder::encodeRows(const std::vector < std::vector < OneSymbol > > & grid,
+                               const std::vector < std::vector < OneSymbol > > * previous, size_t firstRow, size_t lastRow, char * out) const
+{
+    char * cursor = out;
+    for (size_t i = firstRow; i < lastRow; i++)
+    {
+        const OneSymbol * row = grid[i].data();
+        size_t count = grid[i].size();
+
+        if (previous == nullptr)
+        {
+            if (spans != Spans::None)
+                cursor += encodeRow(row, count, cursor);
+            else
+                for (size_t j = 0; j < count; j++)
+                    cursor += encodeCell(row[j], cursor, mode, palette);
+            continue;
+        }
+
+        const OneSymbol * before = (*previous)[i].data();
+        for (size_t j = 0; j < count;)
+        {
+            if (sameCell(row[j], before[j]))
+            {
+                j++;
+                continue;
+            }
+
+            // A changed right half is repainted through the wide glyph it belongs to
+            if (j > 0 && row[j].symbol == GlyphTable::CONTINUATION)
+                j--;
+
+            // Short unchanged gaps are cheaper to repaint than to jump over
+            size_t end = j + 1, unchanged = 0;
+            for (size_t k = end; k < count && unchanged < MAX_DIFF_GAP; k++)
+            {
+                if (sameCell(row[k], before[k]))
+                    unchanged++;
+                else
+                {
+                    unchanged = 0;
+                    end = k + 1;
+                }
+            }
+
+            cursor = writeCursorPosition(cursor, i + 1, j + 1);
+            if (spans != Spans::None)
+                cursor += encodeRow(row + j, end - j, cursor);
+            else
+                for (size_t k = j; k < end; k++)
+                    cursor += encodeCell(row[k], cursor, mode, palette);
+            j = end;
+        }
+    }
+
+    return size_t(cursor - out);
+}
+
+
+bool FrameEncoder::sameCell(const OneSymbol & first, const OneSymbol & second) const
+{
+    if (first.symbol != second.symbol)
+        return false;
+    if (mode == Mode::Full && !sameColor(first.backgroundColor, second.backgroundColor))
+        return false;
+
+    return mode == Mode::Monochrome || first.symbol == ' ' || sameColor(first.foregroundColor, second.foregroundColor);
+}
+
+
+size_t FrameEncoder::encodeRow(const OneSymbol * row, size_t count, char * out) const
+{
+    char * cursor = out;
+    for (size_t j = 0; j < count;)
+    {
+        size_t run = 1;
+        while (j + run < count && sameCell(row[j], row[j + run]))
+            run++;
+
+        const OneSymbol & cell = row[j];
+        const GlyphTable::Glyph & glyph = GlyphTable::get(cell.symbol);
+        if (glyph.length == 0)
+        {
+            // Right halves of wide glyphs, already covered by the glyph before them
+            j += run;
+            continue;
+        }
+
+        if (mode != Mode::Monochrome)
+            cursor = writeColor(cursor, "\033[38;", cell.foregroundColor, palette);
+        if (mode == Mode::Full)
+            cursor = writeColor(cursor, "\033[48;", cell.backgroundColor, palette);
+
+        if (spans == Spans::Erase && cell.symbol == ' ' && run >= MIN_ERASE_RUN)
+        {
+            // Only printed characters complete a pending line wrap and the cursor move stops at
+            // the margin, so the first and last cells of a row are printed around the erased span
+            size_t leading = j == 0 ? 1 : 0, trailing = j + run == count ? 1 : 0;
+            size_t erased = run - leading - trailing;
+            if (leading > 0)
+                *cursor++ = ' ';
+            cursor = writeCountSequence(cursor, erased, 'X');
+            cursor = writeCountSequence(cursor, erased, 'C');
+            if (trailing > 0)
+                *cursor++ = ' ';
+        }
+        else if (spans == Spans::Repeat && run >= MIN_REPEAT_RUN && glyph.width == 1)
+        {
+            cursor = writeGlyph(cursor, glyph);
+            cursor = writeCountSequence(cursor, run - 1, 'b');
+        }
+        else if (glyph.length == 1)
+        {
+            std::memset(cursor, glyph.bytes[0], run);
+            cursor += run;
+        }
+        else
+            for (size_t k = 0; k < run; k++)
+                cursor = writeGlyph(cursor, glyph);
+
+        if (mode == Mode::Full)
+            cursor = writeLiteral(cursor, RESET);
+        j += run;
+    }
+
+    return size_t(cursor - out);
+}
+
+
+void FrameEncoder::setPalette(Palette newPalette)
+{
+    palette = newPalette;
+
+    return;
+}
+
+
+FrameEncoder::Palette FrameEncoder::getPalette() const
+{
+    return palette;
+}
@@ -0,0 +1,135 @@
+#include "FrameQueue.h"
+
+
+#include <algorithm>
+#include <thread>
+
+
+FrameQueue::FrameQueue(Policy BackPressure, size_t Depth)
+    : policy(BackPressure), gridCount(std::clamp<size_t>(Depth, 1, MAX_DEPTH) + SPARE_GRIDS), recycledCount(0), closed(false),
+      submittedFrames(0), droppedFrames(0), takenFrames(0), head(0), tail(0)
+{
+    for (uint32_t i = 0; i < gridCount; i++)
+        recycled.push(i);
+}
+
+
+FrameQueue::Grid * FrameQueue::acquire(size_t height, size_t width)
+{
+    uint32_t index = 0;
+    while (true)
+    {
+        uint32_t seen = recycledCount.load(std::memory_order_acquire);
+        if (closed.load(std::memory_order_acquire))
+            return nullptr;
+        if (recycled.pop(index))
+            break;
+
+        if (policy == Policy::DropOldest)
+        {
+            if (removeOldest(index))
+            {
+                droppedFrames.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+
+            // The consumer is between taking the last frames and recycling them
+            std::this_thread::yield();
+        }
+        else
+            recycledCount.wait(seen, std::memory_order_acquire);
+    }
+
+    Grid & grid = grids[index];
+    if (grid.size() != height)
+        grid.resize(height);
+    for (auto & row : grid)
+        if (row.size() != width)
+            row.resize(width);
+
+    return &grid;
+}
+
+
+void FrameQueue::submit(Grid * frame)
+{
+    // The ring has a slot for every grid, so it never fills up
+    size_t currentTail = tail.load(std::memory_order_relaxed);
+    submitted[currentTail & (RING_SIZE - 1)].store(uint32_t(frame - grids.data()), std::memory_order_relaxed);
+    tail.store(currentTail + 1, std::memory_order_release);
+    submittedFrames.fetch_add(1, std::memory_order_relaxed);
+
+    return;
+}
+
+
+FrameQueue::Grid * FrameQueue::takeNewest()
+{
+    uint32_t newest = 0, index = 0;
+    bool found = false;
+    while (removeOldest(index))
+    {
+        if (found)
+        {
+            release(&grids[newest]);
+            droppedFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+        newest = index;
+        found = true;
+    }
+    if (!found)
+        return nullptr;
+
+    takenFrames.fetch_add(1, std::memory_order_relaxed);
+
+    return &grids[newest];
+}
+
+
+void FrameQueue::release(Grid * frame)
+{
+    recycled.push(uint32_t(frame - grids.data()));
+    recycledCount.fetch_add(1, std::memory_order_release);
+    if (policy == Policy::Block)
+        recycledCount.notify_one();
+
+    return;
+}
+
+
+void FrameQueue::close()
+{
+    closed.store(true, std::memory_order_release);
+    recycledCount.fetch_add(1, std::memory_order_release);
+    recycledCount.notify_all();
+
+    return;
+}
+
+
+bool FrameQueue::isClosed() const
+{
+    return closed.load(std::memory_order_acquire);
+}
+
+
+FrameQueue::Statistics FrameQueue::getStatistics() const
+{
+    return Statistics{submittedFrames.load(std::memory_order_relaxed), droppedFrames.load(std::memory_order_relaxed),
+                      takenFrames.load(std::memory_order_relaxed)};
+}
+
+
+bool FrameQueue::removeOldest(uint32_t & index)
+{
+    size_t currentHead = head.load(std::memory_order_acquire);
+    while (currentHead != tail.load(std::memory_order_acquire))
+    {
+        // The slot is only rewritten after `head` moves past it, so a stale read always loses the exchange
+        index = submitted[currentHead & (RING_SIZE - 1)].load(std::memory_order_relaxed);
+        if (head.compare_exchange_weak(currentHead, currentHead + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,39 @@
+#include "FrameQueueSource.h"
+
+
+#include <utility>
+
+
+FrameQueueSource::FrameQueueSource(FrameQueue::Policy BackPressure, size_t Depth, double FrameRate, bool ScaleRatio)
+    : TerminalLoop(DIMENSIONS, DIMENSIONS, FrameRate, ScaleRatio), queue(BackPressure, Depth) {}
+
+
+FrameQueueSource::~FrameQueueSource()
+{
+    queue.close();
+}
+
+
+FrameQueue & FrameQueueSource::getQueue()
+{
+    return queue;
+}
+
+
+void FrameQueueSource::update()
+{
+    FrameQueue::Grid * frame = queue.takeNewest();
+    if (frame == nullptr)
+    {
+        if (queue.isClosed())
+            stop();
+        return;
+    }
+
+    // Scaling needs at least one cell; an empty frame keeps the last one on screen
+    if (!frame->empty() && !frame->front().empty())
+        std::swap(GRID(terminal), *frame);
+    queue.release(frame);
+
+    return;
+}
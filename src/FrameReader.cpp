@@ -0,0 +1,245 @@
+#include "FrameReader.h"
+
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+FrameReader::FrameReader(const std::string & path)
+    : fd(open(path.c_str(), O_RDONLY | O_CLOEXEC)), data(nullptr), size(0), recordsEnd(0), offset(0), frameCount(0), current{}, hasCurrent(false)
+{
+    if (fd < 0)
+        throw std::runtime_error("cannot open recording '" + path + "'");
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size < off_t(sizeof(FrameRecording::FileHeader)))
+    {
+        close(fd);
+        throw std::runtime_error("'" + path + "' is not a frame recording");
+    }
+
+    size = size_t(status.st_size);
+    void * mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        close(fd);
+        throw std::runtime_error("cannot map recording '" + path + "'");
+    }
+    data = static_cast<const char *>(mapping);
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    try
+    {
+        if (std::memcmp(data, FrameRecording::FILE_MAGIC, sizeof(FrameRecording::FILE_MAGIC)) != 0)
+            throw std::runtime_error("'" + path + "' is not a frame recording");
+        loadIndex();
+    }
+    catch (...)
+    {
+        munmap(const_cast<char *>(data), size);
+        close(fd);
+        throw;
+    }
+
+    offset = sizeof(FrameRecording::FileHeader);
+}
+
+
+FrameReader::~FrameReader()
+{
+    munmap(const_cast<char *>(data), size);
+    close(fd);
+}
+
+
+uint32_t FrameReader::getFrameCount() const
+{
+    return frameCount;
+}
+
+
+bool FrameReader::next()
+{
+    if (offset >= recordsEnd)
+        return false;
+
+    decodeRecord();
+
+    return true;
+}
+
+
+void FrameReader::seek(uint32_t frame)
+{
+    if (frame >= frameCount)
+        throw std::out_of_range("frame " + std::to_string(frame) + " is beyond the end of the recording");
+
+    auto keyframe = std::upper_bound(keyframes.begin(), keyframes.end(), frame,
+        [](uint32_t target, const FrameRecording::KeyframeEntry & entry) { return target < entry.frameIndex; });
+    if (keyframe == keyframes.begin())
+        throw std::runtime_error("recording does not start with a keyframe");
+    --keyframe;
+
+    // Continue from the current frame when it already lies between the keyframe and the target
+    if (!hasCurrent || current.frameIndex > frame || current.frameIndex < keyframe->frameIndex)
+    {
+        offset = size_t(keyframe->offset);
+        decodeRecord();
+    }
+
+    while (current.frameIndex < frame)
+        if (!next())
+            throw std::runtime_error("recording ends before frame " + std::to_string(frame));
+
+    return;
+}
+
+
+uint32_t FrameReader::getFrameIndex() const
+{
+    return current.frameIndex;
+}
+
+
+uint64_t FrameReader::getTimestamp() const
+{
+    return current.timestamp;
+}
+
+
+size_t FrameReader::getHeight() const
+{
+    return current.height;
+}
+
+
+size_t FrameReader::getWidth() const
+{
+    return current.width;
+}
+
+
+const std::vector <FrameRecording::PackedCell> & FrameReader::getCells() const
+{
+    return cells;
+}
+
+
+void FrameReader::toGrid(std::vector < std::vector < OneSymbol > > & grid) const
+{
+    FrameRecording::unpackFrame(cells, current.height, current.width, grid, glyphCache);
+
+    return;
+}
+
+
+template <typename T>
+T FrameReader::readValue(size_t at, size_t limit) const
+{
+    if (at + sizeof(T) > limit)
+        throw std::runtime_error("truncated frame recording");
+
+    T value;
+    std::memcpy(&value, data + at, sizeof(T));
+    return value;
+}
+
+
+void FrameReader::loadIndex()
+{
+    recordsEnd = size;
+
+    if (size >= sizeof(FrameRecording::FileHeader) + sizeof(FrameRecording::IndexFooter))
+    {
+        auto footer = readValue<FrameRecording::IndexFooter>(size - sizeof(FrameRecording::IndexFooter), size);
+        size_t indexBytes = size_t(footer.keyframeCount) * sizeof(FrameRecording::KeyframeEntry);
+        size_t indexEnd = size - sizeof(footer);
+
+        if (std::memcmp(footer.magic, FrameRecording::INDEX_MAGIC, sizeof(footer.magic)) == 0)
+        {
+            // Compared without sums, so an offset near the top of the range cannot wrap around into a match
+            if (footer.indexOffset < sizeof(FrameRecording::FileHeader) || footer.indexOffset > indexEnd
+                || indexBytes != indexEnd - size_t(footer.indexOffset))
+                throw std::runtime_error("malformed keyframe index in frame recording");
+
+            recordsEnd = size_t(footer.indexOffset);
+            frameCount = footer.frameCount;
+            keyframes.resize(footer.keyframeCount);
+            std::memcpy(keyframes.data(), data + recordsEnd, indexBytes);
+
+            // Every entry must point at a record header, in frame and file order, for seek() to trust it
+            for (size_t i = 0; i < keyframes.size(); i++)
+            {
+                const FrameRecording::KeyframeEntry & entry = keyframes[i];
+                if (entry.offset < sizeof(FrameRecording::FileHeader) || entry.offset > recordsEnd
+                    || recordsEnd - entry.offset < sizeof(FrameRecording::RecordHeader)
+                    || (i > 0 && (entry.frameIndex <= keyframes[i - 1].frameIndex || entry.offset <= keyframes[i - 1].offset)))
+                    throw std::runtime_error("malformed keyframe index in frame recording");
+            }
+            return;
+        }
+    }
+
+    // No footer (the recorder did not shut down cleanly): rebuild the index from record headers
+    for (size_t at = sizeof(FrameRecording::FileHeader); at + sizeof(FrameRecording::RecordHeader) <= size; )
+    {
+        auto header = readValue<FrameRecording::RecordHeader>(at, size);
+        size_t itemSize = header.type == FrameRecording::RecordType::Keyframe ? sizeof(FrameRecording::PackedCell) : sizeof(FrameRecording::DeltaEntry);
+        size_t recordEnd = at + sizeof(header) + size_t(header.count) * itemSize;
+        if (recordEnd > size)
+            break;
+
+        if (header.type == FrameRecording::RecordType::Keyframe)
+            keyframes.push_back({header.frameIndex, 0, at, header.timestamp});
+        frameCount = header.frameIndex + 1;
+        at = recordEnd;
+        recordsEnd = at;
+    }
+
+    return;
+}
+
+
+void FrameReader::decodeRecord()
+{
+    auto header = readValue<FrameRecording::RecordHeader>(offset, recordsEnd);
+    size_t at = offset + sizeof(header);
+    size_t frameCells = size_t(header.height) * header.width;
+
+    if (header.type == FrameRecording::RecordType::Keyframe)
+    {
+        size_t bytes = size_t(header.count) * sizeof(FrameRecording::PackedCell);
+        if (header.count != frameCells || at + bytes > recordsEnd)
+            throw std::runtime_error("malformed keyframe in frame recording");
+
+        cells.resize(frameCells);
+        std::memcpy(cells.data(), data + at, bytes);
+        at += bytes;
+    }
+    else if (header.type == FrameRecording::RecordType::Delta)
+    {
+        if (!hasCurrent || cells.size() != frameCells)
+            throw std::runtime_error("delta frame without a matching keyframe in frame recording");
+
+        for (uint32_t i = 0; i < header.count; i++, at += sizeof(FrameRecording::DeltaEntry))
+        {
+            auto delta = readValue<FrameRecording::DeltaEntry>(at, recordsEnd);
+            if (delta.index >= frameCells)
+                throw std::runtime_error("delta outside of frame in frame recording");
+            cells[delta.index] = delta.cell;
+        }
+    }
+    else
+        throw std::runtime_error("unknown record type in frame recording");
+
+    current = header;
+    hasCurrent = true;
+    offset = at;
+
+    return;
+}
@@ -0,0 +1,305 @@
+#include "FrameRecorder.h"
+
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+#include "FrameEncoder.h"
+#include "FrameReader.h"
+#include "InputReader.h"
+
+
+namespace
+{
+    /**
+     * @brief Appends `text` to `out` as the contents of a JSON string literal.
+     */
+    void appendJsonEscaped(std::string & out, std::string_view text)
+    {
+        static constexpr char HEX[] = "0123456789abcdef";
+
+        for (char ch : text)
+        {
+            unsigned char byte = static_cast<unsigned char>(ch);
+            if (ch == '"' || ch == '\\')
+            {
+                out += '\\';
+                out += ch;
+            }
+            else if (byte < 0x20)
+            {
+                out += "\\u00";
+                out += HEX[byte >> 4];
+                out += HEX[byte & 0xF];
+            }
+            else
+                out += ch;
+        }
+
+        return;
+    }
+}
+
+
+FrameRecorder::FrameRecorder(const std::string & path, uint32_t KeyframeInterval)
+    : fd(open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)), indexFd(-1), keyframeInterval(std::max(KeyframeInterval, 1u)),
+      frameCount(0), framesSinceKeyframe(0), fileOffset(0), height(0), width(0), keyframeCount(0), spilledKeyframes(0), pendingFull(false),
+      stopping(false), writeFailed(false)
+{
+    if (fd < 0)
+        throw std::runtime_error("cannot create recording file '" + path + "'");
+
+    indexFd = memfd_create("frame-recording-index", MFD_CLOEXEC);
+    if (indexFd < 0)
+    {
+        close(fd);
+        throw std::runtime_error("cannot create the keyframe index of '" + path + "'");
+    }
+
+    currentChunk.reserve(CHUNK_BYTES * 2);
+    pendingChunk.reserve(CHUNK_BYTES * 2);
+
+    FrameRecording::FileHeader header{};
+    std::memcpy(header.magic, FrameRecording::FILE_MAGIC, sizeof(header.magic));
+    header.keyframeInterval = keyframeInterval;
+    append(&header, sizeof(header));
+
+    writer = std::thread(&FrameRecorder::writerLoop, this);
+}
+
+
+FrameRecorder::~FrameRecorder()
+{
+    FrameRecording::IndexFooter footer{};
+    footer.indexOffset = fileOffset;
+    footer.keyframeCount = uint32_t(spilledKeyframes + keyframeCount);
+    footer.frameCount = frameCount;
+    std::memcpy(footer.magic, FrameRecording::INDEX_MAGIC, sizeof(footer.magic));
+
+    // Spilled blocks hold the older entries; the index ends with the block still in memory
+    std::vector <FrameRecording::KeyframeEntry> spilled(spilledKeyframes);
+    size_t spilledBytes = spilled.size() * sizeof(FrameRecording::KeyframeEntry);
+    for (size_t done = 0; done < spilledBytes; )
+    {
+        ssize_t result = pread(indexFd, reinterpret_cast<char *>(spilled.data()) + done, spilledBytes - done, off_t(done));
+        if (result > 0)
+            done += size_t(result);
+        else if (result == 0 || errno != EINTR)
+        {
+            writeFailed.store(true, std::memory_order_relaxed);
+            break;
+        }
+    }
+    close(indexFd);
+
+    append(spilled.data(), spilledBytes);
+    append(keyframes.data(), keyframeCount * sizeof(FrameRecording::KeyframeEntry));
+    append(&footer, sizeof(footer));
+    submitChunk();
+
+    {
+        std::lock_guard <std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    writer.join();
+
+    close(fd);
+}
+
+
+void FrameRecorder::captureFrame(const std::vector < std::vector < OneSymbol > > & grid)
+{
+    if (writeFailed.load(std::memory_order_relaxed))
+        throw std::runtime_error("writing the frame recording failed");
+
+    auto now = std::chrono::steady_clock::now();
+    if (frameCount == 0)
+        startTime = now;
+    uint64_t timestamp = uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(now - startTime).count());
+
+    size_t newHeight = grid.size();
+    size_t newWidth = grid.empty() ? 0 : grid.front().size();
+    size_t cells = newHeight * newWidth;
+    bool sizeChanged = newHeight != height || newWidth != width;
+
+    if (sizeChanged)
+    {
+        currentFrame.resize(cells);
+        deltas.reserve(cells);
+    }
+
+    for (size_t i = 0; i < newHeight; i++)
+        for (size_t ii = 0; ii < newWidth; ii++)
+            currentFrame[i * newWidth + ii] = FrameRecording::packCell(grid[i][ii]);
+
+    bool keyframe = frameCount == 0 || sizeChanged || framesSinceKeyframe >= keyframeInterval;
+    if (!keyframe)
+    {
+        deltas.clear();
+        for (size_t i = 0; i < cells; i++)
+            if (currentFrame[i] != previousFrame[i])
+                deltas.push_back({uint32_t(i), currentFrame[i]});
+
+        // A delta entry is a third larger than a cell, so dense changes are cheaper as a keyframe
+        keyframe = deltas.size() > cells / 2;
+    }
+
+    FrameRecording::RecordHeader header{};
+    header.frameIndex = frameCount;
+    header.timestamp = timestamp;
+    header.height = uint16_t(newHeight);
+    header.width = uint16_t(newWidth);
+
+    if (keyframe)
+    {
+        keyframes[keyframeCount++] = {frameCount, 0, fileOffset, timestamp};
+        if (keyframeCount == INDEX_BLOCK)
+            spillKeyframes();
+        header.type = FrameRecording::RecordType::Keyframe;
+        header.count = uint32_t(cells);
+        append(&header, sizeof(header));
+        append(currentFrame.data(), cells * sizeof(FrameRecording::PackedCell));
+        framesSinceKeyframe = 0;
+    }
+    else
+    {
+        header.type = FrameRecording::RecordType::Delta;
+        header.count = uint32_t(deltas.size());
+        append(&header, sizeof(header));
+        append(deltas.data(), deltas.size() * sizeof(FrameRecording::DeltaEntry));
+    }
+
+    framesSinceKeyframe++;
+    frameCount++;
+    height = newHeight;
+    width = newWidth;
+    std::swap(previousFrame, currentFrame);
+    if (sizeChanged)
+        currentFrame.resize(cells);
+
+    if (currentChunk.size() >= CHUNK_BYTES)
+        submitChunk();
+
+    return;
+}
+
+
+void FrameRecorder::exportAsciicast(const std::string & recordingPath, const std::string & castPath)
+{
+    FrameReader reader(recordingPath);
+
+    std::ofstream output(castPath, std::ios::binary);
+    if (!output)
+        throw std::runtime_error("cannot create '" + castPath + "'");
+
+    FrameEncoder encoder;
+    std::vector < std::vector < OneSymbol > > grid;
+    std::string frame, line;
+
+    for (bool first = true; reader.next(); first = false)
+    {
+        if (first)
+            output << "{\"version\": 2, \"width\": " << reader.getWidth() << ", \"height\": " << reader.getHeight() << "}\n";
+
+        reader.toGrid(grid);
+        frame.resize(FrameEncoder::maxEncodedSize(grid));
+        frame.resize(encoder.encode(grid, frame.data()));
+
+        line = "[" + std::to_string(double(reader.getTimestamp()) / 1e6) + ", \"o\", \"";
+        appendJsonEscaped(line, "\033[H");
+        appendJsonEscaped(line, frame);
+        line += "\"]\n";
+        output << line;
+    }
+
+    if (!output)
+        throw std::runtime_error("writing '" + castPath + "' failed");
+
+    return;
+}
+
+
+void FrameRecorder::append(const void * data, size_t size)
+{
+    const char * bytes = static_cast<const char *>(data);
+    currentChunk.insert(currentChunk.end(), bytes, bytes + size);
+    fileOffset += size;
+
+    return;
+}
+
+
+void FrameRecorder::spillKeyframes()
+{
+    // A write to a memory file only copies pages, so the capturing thread does it without waiting on disk
+    const char * bytes = reinterpret_cast<const char *>(keyframes.data());
+    size_t size = keyframeCount * sizeof(FrameRecording::KeyframeEntry);
+    for (size_t written = 0; written < size; )
+    {
+        ssize_t result = write(indexFd, bytes + written, size - written);
+        if (result > 0)
+            written += size_t(result);
+        else if (result == 0 || errno != EINTR)
+        {
+            writeFailed.store(true, std::memory_order_relaxed);
+            break;
+        }
+    }
+
+    spilledKeyframes += uint32_t(keyframeCount);
+    keyframeCount = 0;
+
+    return;
+}
+
+
+void FrameRecorder::submitChunk()
+{
+    std::unique_lock <std::mutex> lock(mutex);
+    condition.wait(lock, [this] { return !pendingFull; });
+
+    std::swap(currentChunk, pendingChunk);
+    pendingFull = true;
+    condition.notify_all();
+
+    return;
+}
+
+
+void FrameRecorder::writerLoop()
+{
+    // The recorder may start before the loop reads input, and its signals must still reach the loop
+    InputReader::blockSignals();
+
+    std::unique_lock <std::mutex> lock(mutex);
+    while (true)
+    {
+        condition.wait(lock, [this] { return pendingFull || stopping; });
+
+        if (!pendingFull)
+            return;
+
+        // The capturing thread does not touch pendingChunk while pendingFull is set
+        lock.unlock();
+        for (size_t written = 0; written < pendingChunk.size() && !writeFailed.load(std::memory_order_relaxed); )
+        {
+            ssize_t result = write(fd, pendingChunk.data() + written, pendingChunk.size() - written);
+            if (result > 0)
+                written += size_t(result);
+            else if (result == 0 || errno != EINTR)
+                writeFailed.store(true, std::memory_order_relaxed);
+        }
+        lock.lock();
+
+        pendingChunk.clear();
+        pendingFull = false;
+        condition.notify_all();
+    }
+}
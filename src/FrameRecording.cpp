@@ -0,0 +1,108 @@
+#include "FrameRecording.h"
+
+
+static_assert(sizeof(FrameRecording::PackedCell) == 12, "PackedCell must stay tightly packed");
+static_assert(sizeof(FrameRecording::FileHeader) == 16, "FileHeader layout changed");
+static_assert(sizeof(FrameRecording::RecordHeader) == 24, "RecordHeader layout changed");
+static_assert(sizeof(FrameRecording::DeltaEntry) == 16, "DeltaEntry layout changed");
+static_assert(sizeof(FrameRecording::KeyframeEntry) == 24, "KeyframeEntry layout changed");
+static_assert(sizeof(FrameRecording::IndexFooter) == 24, "IndexFooter layout changed");
+
+
+namespace
+{
+    inline uint32_t packColor(const Color & color)
+    {
+        return uint32_t(std::clamp(color.getRed(), 0, 255)) << 16
+             | uint32_t(std::clamp(color.getGreen(), 0, 255)) << 8
+             | uint32_t(std::clamp(color.getBlue(), 0, 255));
+    }
+
+
+    inline Color unpackColor(uint32_t packed)
+    {
+        return Color(double(packed >> 16 & 0xFF), double(packed >> 8 & 0xFF), double(packed & 0xFF));
+    }
+
+
+    /**
+     * @brief Interns the glyph of packed UTF-8 bytes; ASCII and CONTINUATION map to their IDs without a lookup.
+     */
+    GlyphId unpackGlyph(uint32_t packed)
+    {
+        if (packed < 0x80)
+            return GlyphId(packed);
+
+        char bytes[4];
+        size_t length = 0;
+        for (; packed != 0 && length < 4; packed >>= 8)
+            bytes[length++] = char(packed & 0xFF);
+
+        return GlyphTable::intern(std::string_view(bytes, length));
+    }
+}
+
+
+FrameRecording::PackedCell FrameRecording::packCell(const OneSymbol & oneSymbol)
+{
+    // Glyph IDs are only meaningful within one process, so the UTF-8 bytes are stored; clusters
+    // longer than four bytes keep their first code point, whose length the lead byte gives, or
+    // become an ideographic space when that code point alone is narrower and would shift the row
+    const GlyphTable::Glyph * glyph = &GlyphTable::get(oneSymbol.symbol);
+    unsigned char lead = static_cast<unsigned char>(glyph->bytes[0]);
+    size_t length = glyph->length <= 4 ? glyph->length : lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : 2;
+    if (length < glyph->length)
+    {
+        const GlyphTable::Glyph & first = GlyphTable::get(GlyphTable::intern(std::string_view(glyph->bytes, length)));
+        glyph = first.width == glyph->width ? &first : &GlyphTable::get(GlyphTable::intern(U'\u3000'));
+        length = glyph->length;
+    }
+
+    uint32_t bytes = 0;
+    for (size_t i = length; i > 0; i--)
+        bytes = bytes << 8 | static_cast<unsigned char>(glyph->bytes[i - 1]);
+
+    return PackedCell{packColor(oneSymbol.foregroundColor), packColor(oneSymbol.backgroundColor), bytes};
+}
+
+
+OneSymbol FrameRecording::unpackCell(const PackedCell & cell)
+{
+    return OneSymbol(unpackGlyph(cell.glyph), unpackColor(cell.foreground), unpackColor(cell.background));
+}
+
+
+OneSymbol FrameRecording::unpackCell(const PackedCell & cell, GlyphCache & cache)
+{
+    if (cell.glyph < 0x80)
+        return OneSymbol(GlyphId(cell.glyph), unpackColor(cell.foreground), unpackColor(cell.background));
+
+    // Fibonacci hashing spreads the lead and continuation bytes over the slots
+    size_t slot = size_t(cell.glyph * 0x9E3779B1u >> 24) % GlyphCache::SIZE;
+    if (cache.bytes[slot] != cell.glyph)
+    {
+        cache.bytes[slot] = cell.glyph;
+        cache.ids[slot] = unpackGlyph(cell.glyph);
+    }
+
+    return OneSymbol(cache.ids[slot], unpackColor(cell.foreground), unpackColor(cell.background));
+}
+
+
+void FrameRecording::unpackFrame(const std::vector <PackedCell> & cells, size_t height, size_t width, std::vector < std::vector < OneSymbol > > & grid,
+                                 GlyphCache & cache)
+{
+    if (grid.size() != height)
+        grid.resize(height);
+
+    for (size_t i = 0; i < height; i++)
+    {
+        if (grid[i].size() != width)
+            grid[i].resize(width);
+
+        for (size_t ii = 0; ii < width; ii++)
+            grid[i][ii] = unpackCell(cells[i * width + ii], cache);
+    }
+
+    return;
+}
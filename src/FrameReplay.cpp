@@ -0,0 +1,64 @@
+#include "FrameReplay.h"
+
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+
+#include "TerminalControl.h"
+
+
+FrameReplay::FrameReplay(const std::string & path)
+    : reader(path) {}
+
+
+FrameReplay::Statistics FrameReplay::play(Timing timing, Output output, uint32_t firstFrame)
+{
+    Statistics statistics{0, 0, 0.0};
+    if (reader.getFrameCount() == 0)
+        return statistics;
+
+    std::unique_ptr <TerminalControl> terminal;
+    if (output == Output::Terminal)
+        terminal = std::make_unique<TerminalControl>(0, 0);
+
+    std::vector < std::vector < OneSymbol > > grid;
+    auto startTime = std::chrono::steady_clock::now();
+    uint64_t firstTimestamp = 0;
+
+    reader.seek(firstFrame);
+    for (bool decoded = true; decoded; decoded = reader.next())
+    {
+        if (statistics.frames == 0)
+            firstTimestamp = reader.getTimestamp();
+
+        if (timing == Timing::Original)
+            std::this_thread::sleep_until(startTime + std::chrono::microseconds(reader.getTimestamp() - firstTimestamp));
+
+        if (terminal)
+        {
+            char ch;
+            if (read(STDIN_FILENO, &ch, 1) > 0 && (ch == 'Q' || ch == 'q'))
+                break;
+
+            reader.toGrid(GRID(*terminal));
+            terminal->setUpScaledGrid(true);
+            terminal->clearTerminal();
+            statistics.bytes += terminal->printTerminal();
+            terminal->endFrame();
+        }
+        else
+        {
+            reader.toGrid(grid);
+            statistics.bytes += encoder.encode(grid, arena).size();
+            arena.reset();
+        }
+
+        statistics.frames++;
+    }
+
+    statistics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    return statistics;
+}
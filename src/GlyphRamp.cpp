@@ -0,0 +1,28 @@
+#include "GlyphRamp.h"
+
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+GlyphRamp::GlyphRamp(std::string_view Ramp)
+{
+    if (Ramp.empty())
+        Ramp = DEFAULT_RAMP;
+
+    std::vector <GlyphId> glyphs;
+    for (size_t offset = 0; offset < Ramp.size();)
+    {
+        size_t used = GlyphTable::next(Ramp.substr(offset), glyphs.emplace_back());
+
+        // ASCII art writes one glyph per cell, so a wide glyph would push the rest of its row one column right
+        if (GlyphTable::get(glyphs.back()).width != 1)
+            throw std::invalid_argument("glyph ramp entry '" + std::string(Ramp.substr(offset, used)) + "' is not one column wide");
+        offset += used;
+    }
+
+    size_t last = glyphs.size() - 1;
+    for (size_t luminance = 0; luminance < table.size(); luminance++)
+        table[luminance] = glyphs[(luminance * last + 127) / 255];
+}
@@ -0,0 +1,266 @@
+#include "GlyphTable.h"
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+
+namespace
+{
+    /// An inclusive range of code points.
+    struct Range
+    {
+        char32_t first;
+        char32_t last;
+    };
+
+
+    /// Combining marks, zero-width spaces and joiners and variation selectors, sorted.
+    constexpr Range ZERO_WIDTH[] = {
+        {0x0300, 0x036F}, {0x0483, 0x0489}, {0x0591, 0x05BD}, {0x05BF, 0x05BF}, {0x05C1, 0x05C2}, {0x05C4, 0x05C5},
+        {0x0610, 0x061A}, {0x064B, 0x065F}, {0x0670, 0x0670}, {0x06D6, 0x06DC}, {0x06DF, 0x06E4}, {0x0E31, 0x0E31},
+        {0x0E34, 0x0E3A}, {0x0E47, 0x0E4E}, {0x1AB0, 0x1AFF}, {0x1DC0, 0x1DFF}, {0x200B, 0x200F}, {0x20D0, 0x20FF},
+        {0xFE00, 0xFE0F}, {0xFE20, 0xFE2F}, {0xE0100, 0xE01EF}};
+
+
+    /// East Asian wide and fullwidth characters and emoji shown as pictures by default, sorted.
+    constexpr Range WIDE[] = {
+        {0x1100, 0x115F}, {0x231A, 0x231B}, {0x2329, 0x232A}, {0x23E9, 0x23EC}, {0x23F0, 0x23F0}, {0x23F3, 0x23F3},
+        {0x25FD, 0x25FE}, {0x2614, 0x2615}, {0x2648, 0x2653}, {0x267F, 0x267F}, {0x2693, 0x2693}, {0x26A1, 0x26A1},
+        {0x26AA, 0x26AB}, {0x26BD, 0x26BE}, {0x26C4, 0x26C5}, {0x26CE, 0x26CE}, {0x26D4, 0x26D4}, {0x26EA, 0x26EA},
+        {0x26F2, 0x26F3}, {0x26F5, 0x26F5}, {0x26FA, 0x26FA}, {0x26FD, 0x26FD}, {0x2705, 0x2705}, {0x270A, 0x270B},
+        {0x2728, 0x2728}, {0x274C, 0x274C}, {0x274E, 0x274E}, {0x2753, 0x2755}, {0x2757, 0x2757}, {0x2795, 0x2797},
+        {0x27B0, 0x27B0}, {0x27BF, 0x27BF}, {0x2B1B, 0x2B1C}, {0x2B50, 0x2B50}, {0x2B55, 0x2B55}, {0x2E80, 0x303E},
+        {0x3041, 0x33FF}, {0x3400, 0x4DBF}, {0x4E00, 0x9FFF}, {0xA000, 0xA4CF}, {0xA960, 0xA97F}, {0xAC00, 0xD7A3},
+        {0xF900, 0xFAFF}, {0xFE10, 0xFE19}, {0xFE30, 0xFE6F}, {0xFF00, 0xFF60}, {0xFFE0, 0xFFE6}, {0x1F004, 0x1F004},
+        {0x1F0CF, 0x1F0CF}, {0x1F18E, 0x1F18E}, {0x1F191, 0x1F19A}, {0x1F200, 0x1F251}, {0x1F300, 0x1F64F},
+        {0x1F680, 0x1F6FF}, {0x1F7E0, 0x1F7EB}, {0x1F90C, 0x1F9FF}, {0x1FA70, 0x1FAFF}, {0x20000, 0x2FFFD},
+        {0x30000, 0x3FFFD}};
+
+
+    constexpr char32_t ZERO_WIDTH_JOINER = 0x200D;
+    constexpr char32_t EMOJI_PRESENTATION = 0xFE0F;
+
+
+    template <size_t N>
+    bool inRanges(const Range (& ranges)[N], char32_t codePoint)
+    {
+        const Range * range = std::upper_bound(ranges, ranges + N, codePoint, [](char32_t value, const Range & r) { return value < r.first; });
+        return range != ranges && codePoint <= (range - 1)->last;
+    }
+
+
+    /**
+     * @brief Decodes the code point at the start of `bytes`.
+     *
+     * @return size_t Bytes used, 0 if the sequence is malformed, overlong, a surrogate or out of range.
+     */
+    size_t decodeUtf8(std::string_view bytes, char32_t & codePoint)
+    {
+        unsigned char first = static_cast<unsigned char>(bytes[0]);
+        size_t length = first < 0x80 ? 1 : first >= 0xF0 && first < 0xF8 ? 4 : first >= 0xE0 ? 3 : first >= 0xC2 ? 2 : 0;
+        if (length == 0 || bytes.size() < length || (length == 4 && first >= 0xF5))
+            return 0;
+
+        codePoint = length == 1 ? first : first & (0x7Fu >> length);
+        for (size_t i = 1; i < length; i++)
+        {
+            unsigned char next = static_cast<unsigned char>(bytes[i]);
+            if ((next & 0xC0) != 0x80)
+                return 0;
+            codePoint = codePoint << 6 | (next & 0x3Fu);
+        }
+
+        static constexpr char32_t SMALLEST[5] = {0, 0, 0x80, 0x800, 0x10000};
+        if (codePoint < SMALLEST[length] || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+            return 0;
+
+        return length;
+    }
+
+
+    /**
+     * @brief Encodes a valid code point as UTF-8.
+     *
+     * @return size_t Bytes written, at most 4.
+     */
+    size_t encodeUtf8(char32_t codePoint, char * out)
+    {
+        if (codePoint < 0x80)
+        {
+            out[0] = char(codePoint);
+            return 1;
+        }
+        if (codePoint < 0x800)
+        {
+            out[0] = char(0xC0 | codePoint >> 6);
+            out[1] = char(0x80 | (codePoint & 0x3F));
+            return 2;
+        }
+        if (codePoint < 0x10000)
+        {
+            out[0] = char(0xE0 | codePoint >> 12);
+            out[1] = char(0x80 | (codePoint >> 6 & 0x3F));
+            out[2] = char(0x80 | (codePoint & 0x3F));
+            return 3;
+        }
+        out[0] = char(0xF0 | codePoint >> 18);
+        out[1] = char(0x80 | (codePoint >> 12 & 0x3F));
+        out[2] = char(0x80 | (codePoint >> 6 & 0x3F));
+        out[3] = char(0x80 | (codePoint & 0x3F));
+        return 4;
+    }
+
+
+    bool isRegionalIndicator(char32_t codePoint)
+    {
+        return codePoint >= 0x1F1E6 && codePoint <= 0x1F1FF;
+    }
+
+
+    /**
+     * @brief Reports whether a code point joins the glyph before it: marks, selectors, joiners and skin tones.
+     */
+    bool extendsGlyph(char32_t codePoint)
+    {
+        return codePoint == ZERO_WIDTH_JOINER || inRanges(ZERO_WIDTH, codePoint) || (codePoint >= 0x1F3FB && codePoint <= 0x1F3FF);
+    }
+
+
+    std::mutex internMutex;                                 ///< Serializes `intern()`.
+    std::unordered_map <std::string, GlyphId> interned;     ///< IDs of the non-ASCII glyphs by their bytes.
+    std::atomic <size_t> glyphCount{0};                     ///< Entries in use.
+}
+
+
+GlyphTable::Glyph GlyphTable::glyphs[GlyphTable::CAPACITY];
+
+
+// Defined after the storage it fills, so it runs after it is constructed
+const bool GlyphTable::reserved = []
+{
+    GlyphTable::add("", 0);
+    for (int ascii = 1; ascii < 128; ascii++)
+    {
+        char byte = char(ascii);
+        GlyphTable::add(std::string_view(&byte, 1), 1);
+    }
+    GlyphTable::add("\xEF\xBF\xBD", 1);
+    return true;
+}();
+
+
+GlyphId GlyphTable::intern(std::string_view utf8)
+{
+    if (utf8.empty())
+        return ' ';
+    if (utf8.size() == 1 && static_cast<unsigned char>(utf8[0]) < 0x80)
+        return GlyphId(utf8[0]);
+    if (utf8.size() > MAX_GLYPH_BYTES)
+        return REPLACEMENT;
+
+    // The glyph is as wide as its first code point, or two columns when an emoji selector asks for a picture
+    // or it is a flag, a pair of regional indicators
+    int width = 0;
+    for (size_t offset = 0; offset < utf8.size();)
+    {
+        char32_t codePoint;
+        size_t used = decodeUtf8(utf8.substr(offset), codePoint);
+        if (used == 0 || (codePoint >= 0x80 && codePoint < 0xA0))
+            return REPLACEMENT;
+
+        if (offset == 0)
+            width = std::max(displayWidth(codePoint), 1);
+        else if (codePoint == EMOJI_PRESENTATION || isRegionalIndicator(codePoint))
+            width = 2;
+        offset += used;
+    }
+
+    std::lock_guard <std::mutex> lock(internMutex);
+    auto found = interned.find(std::string(utf8));
+    if (found != interned.end())
+        return found->second;
+    if (glyphCount.load(std::memory_order_relaxed) == CAPACITY)
+        return REPLACEMENT;
+
+    return add(utf8, uint8_t(width));
+}
+
+
+GlyphId GlyphTable::intern(char32_t codePoint)
+{
+    if (codePoint < 0x80)
+        return GlyphId(codePoint);
+    if (codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+        return REPLACEMENT;
+
+    char bytes[4];
+    return intern(std::string_view(bytes, encodeUtf8(codePoint, bytes)));
+}
+
+
+size_t GlyphTable::next(std::string_view text, GlyphId & id)
+{
+    char32_t codePoint;
+    size_t used = decodeUtf8(text, codePoint);
+    if (used == 0)
+    {
+        id = REPLACEMENT;
+        return 1;
+    }
+
+    // Approximate grapheme clusters: extending code points, whatever follows a joiner, and flag pairs
+    bool joined = false, flag = isRegionalIndicator(codePoint);
+    while (used < text.size())
+    {
+        char32_t following;
+        size_t length = decodeUtf8(text.substr(used), following);
+        if (length == 0 || !(joined || extendsGlyph(following) || (flag && isRegionalIndicator(following))))
+            break;
+
+        joined = following == ZERO_WIDTH_JOINER;
+        flag = false;
+        used += length;
+    }
+
+    id = intern(text.substr(0, used));
+    return used;
+}
+
+
+int GlyphTable::displayWidth(char32_t codePoint)
+{
+    if (codePoint < 0x300)
+        return 1;
+    if (inRanges(ZERO_WIDTH, codePoint))
+        return 0;
+
+    return inRanges(WIDE, codePoint) ? 2 : 1;
+}
+
+
+size_t GlyphTable::size()
+{
+    return glyphCount.load(std::memory_order_acquire);
+}
+
+
+GlyphId GlyphTable::add(std::string_view bytes, uint8_t width)
+{
+    size_t id = glyphCount.load(std::memory_order_relaxed);
+    Glyph & glyph = glyphs[id];
+    std::memcpy(glyph.bytes, bytes.data(), bytes.size());
+    glyph.length = uint8_t(bytes.size());
+    glyph.width = width;
+
+    // Published after the entry is complete, for readers that learn IDs through size()
+    if (id >= 128)
+        interned.emplace(bytes, GlyphId(id));
+    glyphCount.store(id + 1, std::memory_order_release);
+
+    return GlyphId(id);
+}
@@ -25,8 +25,11 @@ GrayScaleGradient::GrayScaleGradient(double FrameRate, bool ScaleRatio)
         tmp.setBlue(tmp.getB() - increment);
     }
 
-    terminal.setUpScaledGrid(scaleRatio);
-    terminal.printTerminal();
+
+    // Fades in from black, then warms up for a while and cools back down
+    timeline.blend(0, 45, Colors::BLACK).key(0, 1.0).key(45, 0.0, EffectTimeline::Easing::EaseOut);
+    timeline.colorIncrement(150, 450, Colors::BLACK, Color(40.0, 10.0, -30.0))
+        .key(150, 0.0).key(240, 1.0, EffectTimeline::Easing::EaseInOut).key(360, 1.0).key(450, 0.0, EffectTimeline::Easing::EaseInOut);
 
     return;
 }
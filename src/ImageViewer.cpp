@@ -0,0 +1,34 @@
+#include "ImageViewer.h"
+
+
+#include <cmath>
+
+
+#include "MappedImage.h"
+
+
+ImageViewer::ImageViewer(const std::string & path, bool LinearLight, double FrameRate, bool ScaleRatio)
+    : TerminalLoop(DIMENSIONS, DIMENSIONS, FrameRate, ScaleRatio)
+{
+    {
+        MappedImage image(path);
+        const PixelView & view = image.getView();
+
+        // Terminal cells are roughly twice as tall as they are wide
+        double cellRows = double(view.height) / 2.0;
+        double scale = std::min({1.0, 2.0 * DIMENSIONS / double(view.width), DIMENSIONS / cellRows});
+        size_t width = std::max<size_t>(1, size_t(std::lround(double(view.width) * scale)));
+        size_t height = std::max<size_t>(1, size_t(std::lround(cellRows * scale)));
+
+        terminal.setLinearLight(LinearLight);
+        terminal.loadImage(view, height, width);
+    }
+
+    return;
+}
+
+
+void ImageViewer::update()
+{
+    return;
+}
@@ -0,0 +1,434 @@
+#include "InputReader.h"
+
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+
+
+namespace
+{
+    /// Replacement for malformed UTF-8.
+    constexpr uint32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+
+    /**
+     * @brief Parses the `;`-separated numbers of a CSI sequence; missing numbers are 0.
+     */
+    size_t parseParameters(std::string_view parameters, uint32_t * values, size_t capacity)
+    {
+        size_t count = 0;
+        uint32_t value = 0;
+        for (char ch : parameters)
+        {
+            if (ch == ';')
+            {
+                if (count < capacity)
+                    values[count] = value;
+                count++;
+                value = 0;
+            }
+            else if (ch >= '0' && ch <= '9')
+                value = value * 10 + uint32_t(ch - '0');
+        }
+        if (count < capacity)
+            values[count] = value;
+
+        return count + 1;
+    }
+
+
+    /**
+     * @brief Maps the number of a `CSI number ~` sequence to a key, or 0.
+     */
+    uint32_t tildeKey(uint32_t number)
+    {
+        switch (number)
+        {
+            case 1: case 7: return InputEvent::HOME;
+            case 2: return InputEvent::INSERT;
+            case 3: return InputEvent::DELETE;
+            case 4: case 8: return InputEvent::END;
+            case 5: return InputEvent::PAGE_UP;
+            case 6: return InputEvent::PAGE_DOWN;
+            case 11: case 12: case 13: case 14: case 15: return InputEvent::F1 + (number - 11);
+            case 17: case 18: case 19: case 20: case 21: return InputEvent::F6 + (number - 17);
+            case 23: return InputEvent::F11;
+            case 24: return InputEvent::F12;
+            default: return 0;
+        }
+    }
+
+
+    /**
+     * @brief Maps the final byte of a CSI or SS3 sequence to a key, or 0.
+     */
+    uint32_t letterKey(char final)
+    {
+        switch (final)
+        {
+            case 'A': return InputEvent::UP;
+            case 'B': return InputEvent::DOWN;
+            case 'C': return InputEvent::RIGHT;
+            case 'D': return InputEvent::LEFT;
+            case 'H': return InputEvent::HOME;
+            case 'F': return InputEvent::END;
+            case 'P': return InputEvent::F1;
+            case 'Q': return InputEvent::F2;
+            case 'R': return InputEvent::F3;
+            case 'S': return InputEvent::F4;
+            default: return 0;
+        }
+    }
+}
+
+
+InputReader::InputReader()
+    : descriptor(-1), signalDescriptor(-1), stopDescriptor(-1), readyDescriptor(-1), previousMask{}, mouseTracking(false)
+{
+    sigset_t handled;
+    sigemptyset(&handled);
+    sigaddset(&handled, SIGWINCH);
+    sigaddset(&handled, SIGINT);
+    sigaddset(&handled, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &handled, &previousMask);
+
+    signalDescriptor = signalfd(-1, &handled, SFD_NONBLOCK | SFD_CLOEXEC);
+    stopDescriptor = eventfd(0, EFD_CLOEXEC);
+    readyDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (signalDescriptor < 0 || stopDescriptor < 0 || readyDescriptor < 0)
+    {
+        for (int opened : {signalDescriptor, stopDescriptor, readyDescriptor})
+            if (opened >= 0)
+                close(opened);
+        pthread_sigmask(SIG_SETMASK, &previousMask, nullptr);
+        throw std::runtime_error("cannot create input descriptors");
+    }
+}
+
+
+InputReader::~InputReader()
+{
+    stop();
+    setMouseTracking(false);
+
+    close(signalDescriptor);
+    close(stopDescriptor);
+    close(readyDescriptor);
+    pthread_sigmask(SIG_SETMASK, &previousMask, nullptr);
+}
+
+
+void InputReader::start(int Descriptor)
+{
+    stop();
+    descriptor = Descriptor;
+    thread = std::thread(&InputReader::readerLoop, this);
+
+    return;
+}
+
+
+void InputReader::stop()
+{
+    if (!thread.joinable())
+        return;
+
+    uint64_t wake = 1;
+    [[maybe_unused]] ssize_t result = write(stopDescriptor, &wake, sizeof(wake));
+    thread.join();
+
+    // Leave the descriptor unsignalled for the next start()
+    result = read(stopDescriptor, &wake, sizeof(wake));
+
+    return;
+}
+
+
+bool InputReader::poll(InputEvent & event)
+{
+    return events.pop(event);
+}
+
+
+bool InputReader::wait(std::chrono::milliseconds timeout)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (events.empty())
+    {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        struct pollfd ready = {readyDescriptor, POLLIN, 0};
+        if (remaining.count() <= 0 || ::poll(&ready, 1, int(remaining.count())) <= 0)
+            break;
+
+        // The counter only says that something was pushed; the queue says what is left
+        uint64_t count;
+        [[maybe_unused]] ssize_t result = read(readyDescriptor, &count, sizeof(count));
+    }
+
+    return !events.empty();
+}
+
+
+void InputReader::blockSignals()
+{
+    sigset_t signals;
+    sigfillset(&signals);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    return;
+}
+
+
+void InputReader::setMouseTracking(bool enabled)
+{
+    if (enabled == mouseTracking)
+        return;
+
+    // Button and wheel reports (1000) in the SGR encoding (1006), which has no coordinate limit
+    std::cout << (enabled ? "\033[?1000h\033[?1006h" : "\033[?1006l\033[?1000l");
+    std::cout.flush();
+    mouseTracking = enabled;
+
+    return;
+}
+
+
+size_t InputReader::decode(std::string_view bytes, InputEvent & event, bool final)
+{
+    event = InputEvent{};
+    if (bytes.empty())
+        return 0;
+
+    unsigned char first = static_cast<unsigned char>(bytes[0]);
+    if (first == 0x1B)
+    {
+        if (bytes.size() == 1)
+        {
+            event.key = InputEvent::ESCAPE;
+            return final ? 1 : 0;
+        }
+
+        if (bytes[1] == '[')
+        {
+            // CSI: parameter and intermediate bytes up to a final byte in 0x40-0x7E
+            size_t end = 2;
+            while (end < bytes.size() && (bytes[end] < 0x40 || bytes[end] > 0x7E))
+                end++;
+            if (end == bytes.size())
+            {
+                event.key = InputEvent::ESCAPE;
+                return final ? 1 : 0;
+            }
+
+            std::string_view parameters = bytes.substr(2, end - 2);
+            char finalByte = bytes[end];
+            uint32_t values[3] = {0, 0, 0};
+
+            if (!parameters.empty() && parameters[0] == '<' && (finalByte == 'M' || finalByte == 'm'))
+            {
+                // SGR mouse: CSI < button ; column ; row M (press) or m (release)
+                parseParameters(parameters.substr(1), values, 3);
+                event.type = InputEvent::Type::Mouse;
+                event.button = uint8_t(values[0] & ~uint32_t(4 | 8 | 16));
+                event.modifiers = uint8_t(((values[0] & 4) ? InputEvent::SHIFT : 0) | ((values[0] & 8) ? InputEvent::ALT : 0)
+                                          | ((values[0] & 16) ? InputEvent::CONTROL : 0));
+                event.pressed = finalByte == 'M';
+                event.col = uint16_t(values[1] > 0 ? values[1] - 1 : 0);
+                event.row = uint16_t(values[2] > 0 ? values[2] - 1 : 0);
+                return end + 1;
+            }
+
+            // xterm encodes modifiers as 1 + bits in the second parameter, e.g. CSI 1;5A is Control+Up
+            size_t count = parseParameters(parameters, values, 3);
+            if (count >= 2 && values[1] > 1)
+                event.modifiers = uint8_t((values[1] - 1) & (InputEvent::SHIFT | InputEvent::ALT | InputEvent::CONTROL));
+
+            if (finalByte == '~')
+                event.key = tildeKey(values[0]);
+            else if (finalByte == 'Z')
+            {
+                event.key = InputEvent::TAB;
+                event.modifiers |= InputEvent::SHIFT;
+            }
+            else
+                event.key = letterKey(finalByte);
+            return end + 1;
+        }
+
+        if (bytes[1] == 'O')
+        {
+            // SS3: ESC O letter, sent for cursor keys in application mode and for F1-F4
+            if (bytes.size() < 3)
+            {
+                event.key = InputEvent::ESCAPE;
+                return final ? 1 : 0;
+            }
+            event.key = letterKey(bytes[2]);
+            return 3;
+        }
+
+        if ((bytes[1] == 'P' || bytes[1] == ']' || bytes[1] == '_') && (bytes.size() > 2 || !final))
+        {
+            // DCS, OSC and APC strings run up to ST (ESC \) or BEL; they are answers to queries, like a capability
+            // probe reply that missed its timeout, and are discarded whole so their text never turns into keys
+            for (size_t end = 2; end < bytes.size(); end++)
+            {
+                if (bytes[end] == 0x07)
+                    return end + 1;
+                if (bytes[end] == 0x1B && end + 1 < bytes.size() && bytes[end + 1] == '\\')
+                    return end + 2;
+            }
+
+            // Unfinished: wait for the rest, or drop the part that came when no more is coming
+            return final ? bytes.size() : 0;
+        }
+
+        if (bytes[1] != 0x1B)
+        {
+            // ESC followed by a key is that key with Alt
+            size_t used = decode(bytes.substr(1), event, final);
+            if (used == 0)
+                return 0;
+            event.modifiers |= InputEvent::ALT;
+            return used + 1;
+        }
+
+        event.key = InputEvent::ESCAPE;
+        return 1;
+    }
+
+    if (first == '\r' || first == '\n')
+        event.key = InputEvent::ENTER;
+    else if (first == '\t')
+        event.key = InputEvent::TAB;
+    else if (first == 0x7F || first == 0x08)
+        event.key = InputEvent::BACKSPACE;
+    else if (first == 0)
+    {
+        event.key = ' ';
+        event.modifiers = InputEvent::CONTROL;
+    }
+    else if (first < 0x20)
+    {
+        event.key = 'a' + (first - 1);
+        event.modifiers = InputEvent::CONTROL;
+    }
+    else if (first < 0x80)
+        event.key = first;
+    else
+    {
+        // UTF-8: the lead byte gives the length of the sequence
+        size_t length = first >= 0xF0 ? 4 : first >= 0xE0 ? 3 : first >= 0xC0 ? 2 : 0;
+        if (length == 0)
+        {
+            event.key = REPLACEMENT_CHARACTER;
+            return 1;
+        }
+        if (bytes.size() < length)
+        {
+            event.key = REPLACEMENT_CHARACTER;
+            return final ? 1 : 0;
+        }
+
+        uint32_t codePoint = first & (0x7Fu >> length);
+        for (size_t i = 1; i < length; i++)
+        {
+            unsigned char next = static_cast<unsigned char>(bytes[i]);
+            if ((next & 0xC0) != 0x80)
+            {
+                event.key = REPLACEMENT_CHARACTER;
+                return i;
+            }
+            codePoint = codePoint << 6 | (next & 0x3Fu);
+        }
+        event.key = codePoint;
+        return length;
+    }
+
+    return 1;
+}
+
+
+void InputReader::readerLoop()
+{
+    char buffer[256];
+    size_t length = 0;
+    int input = descriptor;
+    bool terminal = input >= 0 && isatty(input);
+
+    for (;;)
+    {
+        struct pollfd watched[3] = {{stopDescriptor, POLLIN, 0}, {signalDescriptor, POLLIN, 0}, {input, POLLIN, 0}};
+
+        // A partial escape sequence waits briefly for the rest before it is decoded as typed
+        int ready = ::poll(watched, 3, length > 0 ? ESCAPE_TIMEOUT_MILLISECONDS : -1);
+        if (ready < 0 && errno == EINTR)
+            continue;
+        if (ready < 0 || (watched[0].revents & POLLIN))
+            break;
+
+        if (watched[1].revents & POLLIN)
+        {
+            struct signalfd_siginfo information;
+            while (read(signalDescriptor, &information, sizeof(information)) == ssize_t(sizeof(information)))
+            {
+                InputEvent event;
+                event.type = information.ssi_signo == SIGWINCH ? InputEvent::Type::Resize : InputEvent::Type::Interrupt;
+                publish(event);
+            }
+        }
+
+        bool final = ready == 0;
+        if (input >= 0 && (watched[2].revents & (POLLIN | POLLHUP | POLLERR)))
+        {
+            ssize_t count = read(input, buffer + length, sizeof(buffer) - length);
+            // A raw terminal returns nothing when another reader, like the capability probe, took the bytes first;
+            // only a hang-up ends it
+            bool endOfInput = (watched[2].revents & POLLHUP) != 0 || !terminal;
+            if (count > 0)
+                length += size_t(count);
+            else if ((count == 0 && endOfInput) || (count < 0 && errno != EAGAIN && errno != EINTR))
+            {
+                // End of input: stop watching it and flush what is left
+                input = -1;
+                final = true;
+            }
+        }
+
+        size_t offset = 0;
+        while (offset < length)
+        {
+            InputEvent event;
+            size_t used = decode(std::string_view(buffer + offset, length - offset), event, final || length == sizeof(buffer));
+            if (used == 0)
+                break;
+            offset += used;
+
+            // Sequences decoded to key 0 are recognized but not mapped, e.g. focus reports
+            if (event.type != InputEvent::Type::Key || event.key != 0)
+                publish(event);
+        }
+        std::memmove(buffer, buffer + offset, length - offset);
+        length -= offset;
+    }
+
+    return;
+}
+
+
+void InputReader::publish(const InputEvent & event)
+{
+    if (!events.push(event))
+        return;
+
+    uint64_t one = 1;
+    [[maybe_unused]] ssize_t result = write(readyDescriptor, &one, sizeof(one));
+
+    return;
+}
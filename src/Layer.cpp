@@ -0,0 +1,248 @@
+#include "Layer.h"
+
+
+#include <algorithm>
+
+
+Layer::Layer(size_t Height, size_t Width, int ZOrder, double Opacity)
+    : height(0), width(0), tileCols(0), transparentCells(0), opacity(std::clamp(Opacity, 0.0, 1.0)), zOrder(ZOrder), visible(true), dirty(false)
+{
+    resize(Height, Width);
+}
+
+
+void Layer::resize(size_t newHeight, size_t newWidth)
+{
+    std::vector <uint8_t> newCoverage(newHeight * newWidth, 0);
+    for (size_t i = 0; i < std::min(height, newHeight); i++)
+        std::copy_n(coverage.begin() + ptrdiff_t(i * width), std::min(width, newWidth), newCoverage.begin() + ptrdiff_t(i * newWidth));
+
+    grid.resize(newHeight);
+    for (auto & row : grid)
+        row.resize(newWidth);
+
+    coverage.swap(newCoverage);
+    transparentCells = size_t(std::count(coverage.begin(), coverage.end(), 0));
+    height = newHeight;
+    width = newWidth;
+    tileCols = (width + TILE_COLS - 1) / TILE_COLS;
+    dirtyTiles.assign((height + TILE_ROWS - 1) / TILE_ROWS * tileCols, 0);
+    markAll();
+
+    return;
+}
+
+
+void Layer::setSymbol(size_t row, size_t col, const OneSymbol & oneSymbol)
+{
+    if (row >= height || col >= width)
+        return;
+
+    grid[row][col] = oneSymbol;
+    setCoverage(row, col, 255);
+    markCell(row, col);
+
+    return;
+}
+
+
+void Layer::setText(size_t row, size_t col, std::string_view text, const Color & foregroundColor, const Color & backgroundColor)
+{
+    for (size_t offset = 0; offset < text.size() && col < width;)
+    {
+        GlyphId glyph;
+        offset += GlyphTable::next(text.substr(offset), glyph);
+
+        // A wide glyph that does not fit is clipped as a whole
+        if (GlyphTable::get(glyph).width == 2 && col + 1 >= width)
+            break;
+        setSymbol(row, col++, OneSymbol(glyph, foregroundColor, backgroundColor));
+        if (GlyphTable::get(glyph).width == 2)
+            setSymbol(row, col++, OneSymbol(GlyphTable::CONTINUATION, foregroundColor, backgroundColor));
+    }
+
+    return;
+}
+
+
+void Layer::clearSymbol(size_t row, size_t col)
+{
+    if (row >= height || col >= width || coverage[row * width + col] == 0)
+        return;
+
+    setCoverage(row, col, 0);
+    markCell(row, col);
+
+    return;
+}
+
+
+void Layer::clear()
+{
+    std::fill(coverage.begin(), coverage.end(), 0);
+    transparentCells = coverage.size();
+    markAll();
+
+    return;
+}
+
+
+void Layer::fill(const OneSymbol & oneSymbol)
+{
+    for (auto & row : grid)
+        std::fill(row.begin(), row.end(), oneSymbol);
+    std::fill(coverage.begin(), coverage.end(), 255);
+    transparentCells = 0;
+    markAll();
+
+    return;
+}
+
+
+std::vector < std::vector < OneSymbol > > & Layer::getGrid()
+{
+    if (transparentCells > 0)
+    {
+        std::fill(coverage.begin(), coverage.end(), 255);
+        transparentCells = 0;
+    }
+    markAll();
+
+    return grid;
+}
+
+
+void Layer::markDirty(size_t row, size_t col, size_t rows, size_t cols)
+{
+    size_t lastRow = std::min(row + rows, height);
+    size_t lastCol = std::min(col + cols, width);
+    if (row >= lastRow || col >= lastCol)
+        return;
+
+    for (size_t tileRow = row / TILE_ROWS; tileRow <= (lastRow - 1) / TILE_ROWS; tileRow++)
+        for (size_t tileCol = col / TILE_COLS; tileCol <= (lastCol - 1) / TILE_COLS; tileCol++)
+            dirtyTiles[tileRow * tileCols + tileCol] = 1;
+    dirty = true;
+
+    return;
+}
+
+
+void Layer::setOpacity(double newOpacity)
+{
+    newOpacity = std::clamp(newOpacity, 0.0, 1.0);
+    if (newOpacity != opacity)
+    {
+        opacity = newOpacity;
+        markAll();
+    }
+
+    return;
+}
+
+
+double Layer::getOpacity() const
+{
+    return opacity;
+}
+
+
+void Layer::setZOrder(int newZOrder)
+{
+    if (newZOrder != zOrder)
+    {
+        zOrder = newZOrder;
+        markAll();
+    }
+
+    return;
+}
+
+
+int Layer::getZOrder() const
+{
+    return zOrder;
+}
+
+
+void Layer::setVisible(bool newVisible)
+{
+    if (newVisible != visible)
+    {
+        visible = newVisible;
+        markAll();
+    }
+
+    return;
+}
+
+
+bool Layer::isVisible() const
+{
+    return visible;
+}
+
+
+size_t Layer::getHeight() const
+{
+    return height;
+}
+
+
+size_t Layer::getWidth() const
+{
+    return width;
+}
+
+
+bool Layer::isDrawn() const
+{
+    return visible && opacity > 0.0;
+}
+
+
+bool Layer::isOpaque() const
+{
+    return visible && opacity >= 1.0 && transparentCells == 0;
+}
+
+
+void Layer::markCell(size_t row, size_t col)
+{
+    dirtyTiles[row / TILE_ROWS * tileCols + col / TILE_COLS] = 1;
+    dirty = true;
+
+    return;
+}
+
+
+void Layer::markAll()
+{
+    std::fill(dirtyTiles.begin(), dirtyTiles.end(), 1);
+    dirty = true;
+
+    return;
+}
+
+
+void Layer::markClean()
+{
+    if (dirty)
+        std::fill(dirtyTiles.begin(), dirtyTiles.end(), 0);
+    dirty = false;
+
+    return;
+}
+
+
+void Layer::setCoverage(size_t row, size_t col, uint8_t value)
+{
+    uint8_t & cell = coverage[row * width + col];
+    if (cell == 0 && value != 0)
+        transparentCells--;
+    else if (cell != 0 && value == 0)
+        transparentCells++;
+    cell = value;
+
+    return;
+}
@@ -0,0 +1,94 @@
+#include "LayeredOverlay.h"
+
+
+#include <algorithm>
+#include <charconv>
+
+
+namespace
+{
+    constexpr size_t SPRITE_ROWS = 6;
+    constexpr size_t SPRITE_COLS = 16;
+
+    /// The background scrolls once every this many frames.
+    constexpr size_t BACKGROUND_PERIOD = 4;
+}
+
+
+LayeredOverlay::LayeredOverlay(double FrameRate, bool ScaleRatio)
+    : TerminalLoop(DIMENSIONS, DIMENSIONS, FrameRate, ScaleRatio), compositor(DIMENSIONS, DIMENSIONS),
+      background(compositor.addLayer(0)), sprite(compositor.addLayer(1, 0.6)), hud(compositor.addLayer(2)),
+      frame(0), spriteRow(4), spriteCol(10), rowStep(1), colStep(2), composedTiles(0)
+{
+    drawBackground();
+
+    for (size_t i = 0; i < SPRITE_ROWS; i++)
+        for (size_t ii = 0; ii < SPRITE_COLS; ii++)
+            sprite.setSymbol(spriteRow + i, spriteCol + ii, OneSymbol(Colors::WHITE, Colors::GOLD));
+
+    return;
+}
+
+
+void LayeredOverlay::update()
+{
+    frame++;
+
+    // Compose at the terminal's resolution so the status line is scaled 1:1
+    const auto & screen = terminal.getScaledGrid();
+    if (!screen.empty() && (screen.size() != background.getHeight() || screen.front().size() != background.getWidth()))
+    {
+        compositor.resize(screen.size(), screen.front().size());
+        spriteRow = std::min(spriteRow, screen.size() > SPRITE_ROWS ? screen.size() - SPRITE_ROWS : 0);
+        spriteCol = std::min(spriteCol, screen.front().size() > SPRITE_COLS + 2 ? screen.front().size() - SPRITE_COLS - 2 : 0);
+        drawBackground();
+    }
+    else if (frame % BACKGROUND_PERIOD == 0)
+        drawBackground();
+
+    // Move the sprite by clearing its old cells and writing the new ones
+    for (size_t i = 0; i < SPRITE_ROWS; i++)
+        for (size_t ii = 0; ii < SPRITE_COLS; ii++)
+            sprite.clearSymbol(spriteRow + i, spriteCol + ii);
+
+    if ((rowStep < 0 && spriteRow == 0) || (rowStep > 0 && spriteRow + SPRITE_ROWS >= background.getHeight()))
+        rowStep = -rowStep;
+    if ((colStep < 0 && spriteCol < 2) || (colStep > 0 && spriteCol + SPRITE_COLS + 2 > background.getWidth()))
+        colStep = -colStep;
+    spriteRow = size_t(ptrdiff_t(spriteRow) + rowStep);
+    spriteCol = size_t(ptrdiff_t(spriteCol) + colStep);
+
+    for (size_t i = 0; i < SPRITE_ROWS; i++)
+        for (size_t ii = 0; ii < SPRITE_COLS; ii++)
+            sprite.setSymbol(spriteRow + i, spriteCol + ii, OneSymbol(Colors::WHITE, Colors::GOLD));
+
+    char status[64] = "frame ";
+    char * end = std::to_chars(status + 6, status + 32, frame).ptr;
+    end = std::copy_n("  tiles ", 8, end);
+    end = std::to_chars(end, status + 48, composedTiles).ptr;
+
+    // Pad to a fixed width so shorter numbers overwrite longer ones
+    std::fill(end, status + 48, ' ');
+    hud.setText(0, 0, std::string_view(status, 32), Colors::LIME, Colors::BLACK);
+
+    composedTiles = compositor.composite(GRID(terminal));
+
+    return;
+}
+
+
+void LayeredOverlay::drawBackground()
+{
+    auto & grid = background.getGrid();
+    for (size_t i = 0; i < grid.size(); i++)
+    {
+        double phase = double((i + frame / BACKGROUND_PERIOD) % 32) / 32.0;
+        Color band(Colors::DARK_BLUE);
+        band.blendWith(Colors::PURPLE, phase < 0.5 ? 2.0 * phase : 2.0 - 2.0 * phase);
+
+        for (auto & symbol : grid[i])
+            symbol.backgroundColor = band;
+    }
+
+    return;
+}
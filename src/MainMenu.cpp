@@ -7,6 +7,45 @@
 #include "MainMenu.h"
 
 
+#include <cmath>
+#include <thread>
+
+
+namespace
+{
+    /**
+     * @brief Draws a plasma into grids from a FrameQueue at 60 FPS, twice the display rate, until asked to stop.
+     */
+    void producePlasma(std::stop_token stop, FrameQueue & queue)
+    {
+        InputReader::blockSignals();
+        constexpr size_t ROWS = 50, COLS = 100;
+
+        for (size_t frame = 0; !stop.stop_requested(); frame++)
+        {
+            FrameQueue::Grid * grid = queue.acquire(ROWS, COLS);
+            if (grid == nullptr)
+                return;
+
+            double time = double(frame) / 60.0;
+            for (size_t i = 0; i < ROWS; i++)
+                for (size_t j = 0; j < COLS; j++)
+                {
+                    double x = double(j) / double(COLS), y = double(i) / double(ROWS);
+                    double value = std::sin(10.0 * x + time) + std::sin(8.0 * y - 1.3 * time) + std::sin(7.0 * (x + y) + 0.7 * time);
+                    (*grid)[i][j].backgroundColor.setColor(127.5 + 127.5 * std::sin(value), 127.5 + 127.5 * std::sin(value + 2.1),
+                                                           127.5 + 127.5 * std::sin(value + 4.2));
+                }
+
+            queue.submit(grid);
+            std::this_thread::sleep_for(std::chrono::microseconds(16667));
+        }
+
+        return;
+    }
+}
+
+
 void displayMenu(const std::vector<MenuOption> &options)
 {
     std::vector <OneSymbol> headerText = stringToOneSymbolVector("Welcome to ", Colors::WHITE, Colors::BLACK);
@@ -29,22 +68,77 @@ void displayMenu(const std::vector<MenuOption> &options)
 }
 
 
-void runMainMenu()
+void runMainMenu(const LoopOptions & options)
 {
     bool running = true;
 
     std::vector <MenuOption> menuOptions =
     {
         {
-            stringToOneSymbolVector("Random Colors Grid", Colors::GREEN, Colors::BLACK),[]()
+            stringToOneSymbolVector("Random Colors Grid", Colors::GREEN, Colors::BLACK),[&options]()
             {
-                RandomColors randomColors; randomColors.run();
+                RandomColors randomColors;
+                randomColors.configure(options);
+                randomColors.run();
             }
         },
         {
-            stringToOneSymbolVector("Grayscale Gradient", Colors::GRAY, Colors::BLACK),[]()
+            stringToOneSymbolVector("Grayscale Gradient", Colors::GRAY, Colors::BLACK),[&options]()
             {
-                GrayScaleGradient grayScale; grayScale.run();
+                GrayScaleGradient grayScale;
+                grayScale.configure(options);
+                grayScale.run();
+            }
+        },
+        {
+            stringToOneSymbolVector("Layered Overlay", Colors::GOLD, Colors::BLACK),[&options]()
+            {
+                LayeredOverlay layeredOverlay;
+                layeredOverlay.configure(options);
+                layeredOverlay.run();
+            }
+        },
+        {
+            stringToOneSymbolVector("Scene Tour (0-2, Tab)", Colors::CYAN, Colors::BLACK),[&options]()
+            {
+                // Every scene in turn, each shown for five seconds and crossfaded over one
+                SceneManager tour(options, 30, 150);
+                tour.addScene([]() { return std::make_unique<RandomColors>(); });
+                tour.addScene([]() { return std::make_unique<GrayScaleGradient>(); });
+                tour.addScene([]() { return std::make_unique<LayeredOverlay>(); });
+                tour.configure(options);
+                tour.run();
+            }
+        },
+        {
+            stringToOneSymbolVector("Widget Swarm (Space)", Colors::CORAL, Colors::BLACK),[&options]()
+            {
+                WidgetSwarm widgetSwarm;
+                widgetSwarm.configure(options);
+                widgetSwarm.run();
+            }
+        },
+        {
+            stringToOneSymbolVector("Tiled Panels (click, Space)", Colors::TURQUOISE, Colors::BLACK),[&options]()
+            {
+                // Four panels at their own rates; the random colors change only a few times a second
+                TiledLayout panels(options);
+                panels.addPanel(std::make_unique<RandomColors>(), 0.0, 0.0, 0.5, 0.5, 4.0);
+                panels.addPanel(std::make_unique<GrayScaleGradient>(), 0.0, 0.5, 0.5, 0.5);
+                panels.addPanel(std::make_unique<LayeredOverlay>(), 0.5, 0.0, 0.5, 0.5, 15.0);
+                panels.addPanel(std::make_unique<WidgetSwarm>(), 0.5, 0.5, 0.5, 0.5);
+                panels.configure(options);
+                panels.run();
+            }
+        },
+        {
+            stringToOneSymbolVector("Frame Queue (producer thread)", Colors::VIOLET, Colors::BLACK),[&options]()
+            {
+                // The plasma is drawn on a thread of its own and only handed to the loop
+                FrameQueueSource source;
+                source.configure(options);
+                std::jthread producer(producePlasma, std::ref(source.getQueue()));
+                source.run();
             }
         }
     };
@@ -86,14 +180,27 @@ void runMainMenu()
 std::vector <OneSymbol> stringToOneSymbolVector(const std::string & text, const Color & fgColor, const Color & bgColor)
 {
     std::vector <OneSymbol> result;
+    stringToOneSymbolVector(text, fgColor, bgColor, result);
+
+    return result;
+}
+
+
+void stringToOneSymbolVector(std::string_view text, const Color & fgColor, const Color & bgColor, std::vector <OneSymbol> & result)
+{
+    result.clear();
     result.reserve(text.size());
 
-    for (char ch : text)
+    for (size_t offset = 0; offset < text.size();)
     {
-        result.emplace_back(ch, fgColor, bgColor);
+        GlyphId glyph;
+        offset += GlyphTable::next(text.substr(offset), glyph);
+        result.emplace_back(glyph, fgColor, bgColor);
+        if (GlyphTable::get(glyph).width == 2)
+            result.emplace_back(GlyphTable::CONTINUATION, fgColor, bgColor);
     }
 
-    return result;
+    return;
 }
 
 
@@ -0,0 +1,166 @@
+#include "MappedImage.h"
+
+
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace
+{
+    template <typename T>
+    T readLittleEndian(const uint8_t * data, size_t size, size_t offset)
+    {
+        if (offset + sizeof(T) > size)
+            throw std::runtime_error("truncated bitmap header");
+
+        T value = 0;
+        for (size_t i = 0; i < sizeof(T); i++)
+            value = T(value | T(T(data[offset + i]) << (8 * i)));
+        return value;
+    }
+
+
+    bool isSpace(uint8_t ch)
+    {
+        return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\v' || ch == '\f';
+    }
+}
+
+
+MappedImage::MappedImage(const std::string & path)
+    : data(nullptr), size(0), view{}
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::runtime_error("cannot open image '" + path + "'");
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size < 2)
+    {
+        close(fd);
+        throw std::runtime_error("'" + path + "' is not an image");
+    }
+
+    size = size_t(status.st_size);
+    void * mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        throw std::runtime_error("cannot map image '" + path + "'");
+    data = static_cast<const uint8_t *>(mapping);
+
+    try
+    {
+        if (data[0] == 'P' && (data[1] == '5' || data[1] == '6'))
+            parseNetpbm();
+        else if (data[0] == 'B' && data[1] == 'M')
+            parseBitmap();
+        else
+            throw std::runtime_error("unsupported image format");
+    }
+    catch (const std::exception & error)
+    {
+        munmap(mapping, size);
+        throw std::runtime_error("'" + path + "': " + error.what());
+    }
+}
+
+
+MappedImage::~MappedImage()
+{
+    munmap(const_cast<uint8_t *>(data), size);
+}
+
+
+const PixelView & MappedImage::getView() const
+{
+    return view;
+}
+
+
+void MappedImage::parseNetpbm()
+{
+    size_t offset = 2;
+    size_t fields[3] = {0, 0, 0};
+
+    for (size_t & field : fields)
+    {
+        while (offset < size && (isSpace(data[offset]) || data[offset] == '#'))
+        {
+            if (data[offset] == '#')
+                while (offset < size && data[offset] != '\n')
+                    offset++;
+            else
+                offset++;
+        }
+
+        size_t digits = 0;
+        for (; offset < size && data[offset] >= '0' && data[offset] <= '9' && digits < 9; offset++, digits++)
+            field = field * 10 + size_t(data[offset] - '0');
+        if (digits == 0 || field == 0)
+            throw std::runtime_error("malformed header");
+    }
+
+    // Exactly one whitespace byte separates the header from the pixels
+    if (offset >= size || !isSpace(data[offset]))
+        throw std::runtime_error("malformed header");
+    offset++;
+
+    if (fields[2] != 255)
+        throw std::runtime_error("only 8-bit samples are supported");
+
+    view.channels = data[1] == '5' ? 1 : 3;
+    view.width = fields[0];
+    view.height = fields[1];
+    view.rowStride = ptrdiff_t(view.width * view.channels);
+    view.bgr = false;
+    view.data = data + offset;
+
+    if (size - offset < view.height * view.width * view.channels)
+        throw std::runtime_error("truncated pixel data");
+
+    return;
+}
+
+
+void MappedImage::parseBitmap()
+{
+    uint32_t pixelOffset = readLittleEndian<uint32_t>(data, size, 10);
+    int32_t width = int32_t(readLittleEndian<uint32_t>(data, size, 18));
+    int32_t height = int32_t(readLittleEndian<uint32_t>(data, size, 22));
+    uint16_t bitCount = readLittleEndian<uint16_t>(data, size, 28);
+    uint32_t compression = readLittleEndian<uint32_t>(data, size, 30);
+
+    // 32-bit bitmaps commonly use BI_BITFIELDS with the standard BGRA masks
+    if ((bitCount != 24 && bitCount != 32) || (compression != 0 && !(compression == 3 && bitCount == 32)))
+        throw std::runtime_error("only uncompressed 24/32-bit bitmaps are supported");
+    if (width <= 0 || height == 0)
+        throw std::runtime_error("invalid bitmap size");
+
+    bool bottomUp = height > 0;
+    view.width = size_t(width);
+    view.height = size_t(bottomUp ? height : -int64_t(height));
+    view.channels = bitCount / 8;
+    view.bgr = true;
+
+    size_t stride = (view.width * bitCount + 31) / 32 * 4;
+    if (pixelOffset > size || size - pixelOffset < stride * view.height)
+        throw std::runtime_error("truncated pixel data");
+
+    // Bottom-up bitmaps store the top image row last
+    if (bottomUp)
+    {
+        view.data = data + pixelOffset + stride * (view.height - 1);
+        view.rowStride = -ptrdiff_t(stride);
+    }
+    else
+    {
+        view.data = data + pixelOffset;
+        view.rowStride = ptrdiff_t(stride);
+    }
+
+    return;
+}
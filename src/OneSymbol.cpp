@@ -1,10 +1,11 @@
 #include "OneSymbol.h"
+#include "FrameEncoder.h"
 
 OneSymbol::OneSymbol()
     : symbol(u' '), foregroundColor(Colors::BLACK), backgroundColor(Colors::WHITE) {};
 
 
-OneSymbol::OneSymbol(const char Symbol, const Color & ForegroundColor, const Color & BackgroundColor)
+OneSymbol::OneSymbol(const GlyphId Symbol, const Color & ForegroundColor, const Color & BackgroundColor)
     : symbol(Symbol), foregroundColor(ForegroundColor), backgroundColor(BackgroundColor) {};
 
 
@@ -23,13 +24,8 @@ void OneSymbol::invertColor()
 
 std::ostream & operator<<(std::ostream &os, const OneSymbol & oneSymbol)
 {
-    const auto & [symbol,foregroundColor,backgroundColor] = oneSymbol;
-    os  << "\033[38;2;"
-        << foregroundColor.getRed() << ";" << foregroundColor.getGreen() << ";" << foregroundColor.getBlue() << "m"
-        << "\033[48;2;"
-        << backgroundColor.getRed() << ";" << backgroundColor.getGreen() << ";" << backgroundColor.getBlue() << "m"
-        << symbol
-        << "\033[0m";
+    char buffer[FrameEncoder::MAX_CELL_BYTES];
+    os.write(buffer, std::streamsize(FrameEncoder::encodeCell(oneSymbol, buffer)));
 
     return os;
 }
@@ -37,11 +33,6 @@ std::ostream & operator<<(std::ostream &os, const OneSymbol & oneSymbol)
 
 std::string OneSymbol::toString() const
 {
-    return
-        "\033[38;2;"
-        + std::to_string(foregroundColor.getRed()) + ";" + std::to_string(foregroundColor.getGreen()) + ";" + std::to_string(foregroundColor.getBlue()) + "m"
-        + "\033[48;2;"
-        + std::to_string(backgroundColor.getRed()) + ";" + std::to_string(backgroundColor.getGreen()) + ";" +std::to_string(backgroundColor.getBlue()) + "m"
-        + symbol
-        + "\033[0m";
+    char buffer[FrameEncoder::MAX_CELL_BYTES];
+    return std::string(buffer, FrameEncoder::encodeCell(*this, buffer));
 }
@@ -10,8 +10,6 @@ RandomColors::RandomColors(double FrameRate, bool ScaleRatio)
         for (size_t ii = 0; ii < DIMENSIONS; ii++)
             grid[i][ii].backgroundColor.setColor(Color(std::rand() % 256, std::rand() % 256, std::rand() % 256));
 
-    terminal.setUpScaledGrid(scaleRatio);
-    terminal.printTerminal();
     return;
 }
 
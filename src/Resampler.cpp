@@ -0,0 +1,179 @@
+#include "Resampler.h"
+
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+
+
+#include "TileScheduler.h"
+
+
+namespace
+{
+    double kernelRadius(Resampler::Filter filter)
+    {
+        return filter == Resampler::Filter::Lanczos3 ? 3.0 : 1.0;
+    }
+
+
+    double kernelWeight(Resampler::Filter filter, double x)
+    {
+        x = std::abs(x);
+        if (filter == Resampler::Filter::Bilinear)
+            return std::max(0.0, 1.0 - x);
+
+        if (x < 1e-9)
+            return 1.0;
+        if (x >= 3.0)
+            return 0.0;
+        double px = std::numbers::pi * x;
+        return 3.0 * std::sin(px) * std::sin(px / 3.0) / (px * px);
+    }
+}
+
+
+Resampler::Filter Resampler::parseFilter(std::string_view name)
+{
+    if (name == "area")
+        return Filter::Area;
+    if (name == "nearest")
+        return Filter::Nearest;
+    if (name == "bilinear")
+        return Filter::Bilinear;
+    if (name == "lanczos")
+        return Filter::Lanczos3;
+
+    throw std::invalid_argument("unknown filter '" + std::string(name) + "'");
+}
+
+
+void Resampler::setFilter(Filter newFilter)
+{
+    filter = newFilter;
+
+    return;
+}
+
+
+Resampler::Filter Resampler::getFilter() const
+{
+    return filter;
+}
+
+
+void Resampler::resample(const float * source, size_t sourceHeight, size_t sourceWidth,
+                         float * target, size_t targetHeight, size_t targetWidth,
+                         double rowScale, double colScale, FrameArena & arena)
+{
+    updateKernel(rowKernel, targetHeight, sourceHeight, rowScale);
+    updateKernel(columnKernel, targetWidth, sourceWidth, colScale);
+
+    // Rows first: every target row is a weighted sum of whole source rows
+    float * rows = arena.allocateArray<float>(3 * targetHeight * sourceWidth);
+    const size_t rowTaps = rowKernel.taps;
+    const size_t * rowFirst = rowKernel.first.data();
+    const float * rowWeight = rowKernel.weight.data();
+
+    TileScheduler::instance().parallelFor(3 * targetHeight, 1, [&](size_t first, size_t last)
+    {
+        for (size_t index = first; index < last; index++)
+        {
+            size_t plane = index / targetHeight, i = index % targetHeight;
+            float * out = rows + index * sourceWidth;
+            std::fill(out, out + sourceWidth, 0.0f);
+
+            for (size_t k = 0; k < rowTaps; k++)
+            {
+                float weight = rowWeight[i * rowTaps + k];
+                if (weight == 0.0f)
+                    continue;
+
+                const float * in = source + (plane * sourceHeight + rowFirst[i] + k) * sourceWidth;
+                #pragma omp simd
+                for (size_t c = 0; c < sourceWidth; c++)
+                    out[c] += weight * in[c];
+            }
+        }
+    });
+
+    // Then columns, within each filtered row
+    const size_t colTaps = columnKernel.taps;
+    const size_t * colFirst = columnKernel.first.data();
+    const float * colWeight = columnKernel.weight.data();
+
+    TileScheduler::instance().parallelFor(3 * targetHeight, 1, [&](size_t first, size_t last)
+    {
+        for (size_t index = first; index < last; index++)
+        {
+            const float * in = rows + index * sourceWidth;
+            float * out = target + index * targetWidth;
+
+            #pragma omp simd
+            for (size_t j = 0; j < targetWidth; j++)
+            {
+                float sum = 0.0f;
+                for (size_t k = 0; k < colTaps; k++)
+                    sum += colWeight[j * colTaps + k] * in[colFirst[j] + k];
+                out[j] = sum;
+            }
+        }
+    });
+
+    return;
+}
+
+
+void Resampler::updateKernel(Kernel & kernel, size_t targetSize, size_t sourceSize, double scale) const
+{
+    if (kernel.targetSize == targetSize && kernel.sourceSize == sourceSize && kernel.scale == scale && kernel.filter == filter)
+        return;
+
+    kernel.targetSize = targetSize;
+    kernel.sourceSize = sourceSize;
+    kernel.scale = scale;
+    kernel.filter = filter;
+
+    // Shrinking widens the kernel so it still covers every source cell
+    double stretch = std::max(scale, 1.0);
+    double support = filter == Filter::Nearest ? 0.5 : kernelRadius(filter) * stretch;
+    kernel.taps = filter == Filter::Nearest ? 1 : std::min(sourceSize, 2 * size_t(std::ceil(support)) + 1);
+
+    kernel.first.assign(targetSize, 0);
+    kernel.weight.assign(targetSize * kernel.taps, 0.0f);
+
+    for (size_t t = 0; t < targetSize; t++)
+    {
+        // Cells past the end of the source, left over by uniform scaling, stay black
+        double center = ((double)t + 0.5) * scale;
+        if (center >= (double)sourceSize)
+            continue;
+
+        float * weight = kernel.weight.data() + t * kernel.taps;
+        if (filter == Filter::Nearest)
+        {
+            kernel.first[t] = size_t(center);
+            weight[0] = 1.0f;
+            continue;
+        }
+
+        // Source cell s is centered at s + 0.5
+        center -= 0.5;
+        size_t low = size_t(std::max(0.0, std::ceil(center - support)));
+        size_t high = std::min(sourceSize - 1, size_t(std::max(0.0, std::floor(center + support))));
+        kernel.first[t] = std::min(low, sourceSize - kernel.taps);
+
+        double sum = 0.0;
+        for (size_t s = low; s <= high; s++)
+            sum += kernelWeight(filter, ((double)s - center) / stretch);
+        if (sum <= 0.0)
+            continue;
+
+        for (size_t s = low; s <= high; s++)
+            weight[s - kernel.first[t]] = float(kernelWeight(filter, ((double)s - center) / stretch) / sum);
+    }
+
+    return;
+}
@@ -0,0 +1,121 @@
+#include "SceneManager.h"
+
+
+#include <stdexcept>
+
+
+#include "TileScheduler.h"
+
+
+SceneManager::SceneManager(const LoopOptions & SceneOptions, size_t TransitionFrames, size_t AutoAdvanceFrames, double FrameRate)
+    : TerminalLoop(1, 1, FrameRate), sceneOptions(SceneOptions), currentIndex(0), currentFrame(0), outgoingFrame(0),
+      transitionFrames(TransitionFrames), transitionFrame(0), autoAdvanceFrames(AutoAdvanceFrames) {}
+
+
+void SceneManager::addScene(Factory factory)
+{
+    factories.push_back(std::move(factory));
+
+    return;
+}
+
+
+void SceneManager::switchTo(size_t index)
+{
+    if (index >= factories.size())
+        throw std::out_of_range("no scene " + std::to_string(index));
+
+    // Building a scene allocates its grids, and its first frames warm up like those of a standalone run
+    allowAllocations(AllocationCounter::WARMUP_FRAMES);
+    std::unique_ptr <TerminalLoop> scene = factories[index]();
+    scene->configureScaling(sceneOptions);
+
+    if (current && transitionFrames > 0)
+    {
+        outgoing = std::move(current);
+        outgoingFrame = currentFrame;
+        transitionFrame = 0;
+    }
+    current = std::move(scene);
+    currentIndex = index;
+    currentFrame = 0;
+
+    return;
+}
+
+
+void SceneManager::update()
+{
+    if (!current && !factories.empty())
+        switchTo(0);
+    else if (autoAdvanceFrames > 0 && !outgoing && currentFrame >= autoAdvanceFrames && factories.size() > 1)
+        switchTo((currentIndex + 1) % factories.size());
+
+    return;
+}
+
+
+void SceneManager::compose()
+{
+    terminal.resizeScaledGrid();
+    std::vector < std::vector < OneSymbol > > & frame = terminal.getScaledGrid();
+    if (!current)
+        return;
+
+    const std::vector < std::vector < OneSymbol > > & incoming = current->renderOffscreen(currentFrame++);
+    if (!outgoing)
+    {
+        frame = incoming;
+        return;
+    }
+
+    // Both scenes scale to the same terminal, so their grids only differ in size right after a resize
+    const std::vector < std::vector < OneSymbol > > & previous = outgoing->renderOffscreen(outgoingFrame++);
+    if (previous.size() == incoming.size() && (incoming.empty() || previous.front().size() == incoming.front().size()))
+    {
+        frame = previous;
+        double factor = double(transitionFrame + 1) / double(transitionFrames);
+        size_t rows = frame.size();
+
+        TileScheduler::instance().parallelFor(rows, 1, [&](size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; i++)
+                TerminalEffects::crossfadeRow(frame[i].data(), incoming[i].data(), frame[i].size(), factor);
+        });
+    }
+    else
+        frame = incoming;
+
+    if (++transitionFrame >= transitionFrames)
+        outgoing.reset();
+
+    return;
+}
+
+
+void SceneManager::handleInput(const InputEvent & event)
+{
+    if (event.type == InputEvent::Type::Key && event.modifiers == 0 && !factories.empty())
+    {
+        size_t count = factories.size();
+        if (event.key >= '0' && event.key <= '9' && event.key - '0' < count)
+        {
+            switchTo(event.key - '0');
+            return;
+        }
+        if (event.key == InputEvent::TAB || event.key == InputEvent::RIGHT)
+        {
+            switchTo((currentIndex + 1) % count);
+            return;
+        }
+        if (event.key == InputEvent::LEFT)
+        {
+            switchTo((currentIndex + count - 1) % count);
+            return;
+        }
+    }
+
+    TerminalLoop::handleInput(event);
+
+    return;
+}
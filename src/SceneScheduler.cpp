@@ -0,0 +1,249 @@
+#include "SceneScheduler.h"
+
+
+#include <new>
+#include <utility>
+
+
+namespace
+{
+    /// Coroutine frames are rounded up to a multiple of this many bytes.
+    constexpr size_t FRAME_GRANULE = 64;
+
+    /// Number of size classes; larger frames go straight to the heap.
+    constexpr size_t FRAME_CLASSES = 64;
+
+
+    /**
+     * @brief A recycled coroutine frame, linked through its first bytes.
+     */
+    struct FreeFrame
+    {
+        FreeFrame * next;
+    };
+
+
+    /// Set once this thread's pool is gone, so frames destroyed later in thread exit go straight back to the heap.
+    thread_local bool poolReleased = false;
+
+
+    /**
+     * @brief This thread's free frames by size class, returned to the heap when the thread ends.
+     */
+    struct FramePool
+    {
+        FreeFrame * heads[FRAME_CLASSES] = {};
+
+        ~FramePool()
+        {
+            for (FreeFrame *& head : heads)
+                while (head != nullptr)
+                {
+                    FreeFrame * frame = head;
+                    head = frame->next;
+                    ::operator delete(frame);
+                }
+            poolReleased = true;
+        }
+    };
+
+
+    thread_local FramePool framePool;
+}
+
+
+void * SceneTask::promise_type::operator new(size_t size)
+{
+    size_t sizeClass = (size + FRAME_GRANULE - 1) / FRAME_GRANULE;
+    if (sizeClass > FRAME_CLASSES || poolReleased)
+        return ::operator new(size);
+
+    FreeFrame *& head = framePool.heads[sizeClass - 1];
+    if (head == nullptr)
+        return ::operator new(sizeClass * FRAME_GRANULE);
+
+    FreeFrame * frame = head;
+    head = frame->next;
+
+    return frame;
+}
+
+
+void SceneTask::promise_type::operator delete(void * pointer, size_t size)
+{
+    size_t sizeClass = (size + FRAME_GRANULE - 1) / FRAME_GRANULE;
+    if (sizeClass > FRAME_CLASSES || poolReleased)
+    {
+        ::operator delete(pointer);
+        return;
+    }
+
+    FreeFrame *& head = framePool.heads[sizeClass - 1];
+    head = new (pointer) FreeFrame{head};
+
+    return;
+}
+
+
+void SceneTask::FrameAwaiter::await_suspend(std::coroutine_handle <promise_type> handle) const noexcept
+{
+    promise_type & promise = handle.promise();
+    promise.wait = Wait::Frame;
+    promise.resumeFrame = promise.scheduler->getFrame() + count;
+
+    return;
+}
+
+
+void SceneTask::TimeAwaiter::await_suspend(std::coroutine_handle <promise_type> handle) const noexcept
+{
+    promise_type & promise = handle.promise();
+    promise.wait = Wait::Time;
+    promise.resumeFrame = promise.scheduler->getFrame() + 1;
+    promise.resumeTime = promise.scheduler->getTime() + duration;
+
+    return;
+}
+
+
+void SceneTask::InputAwaiter::await_suspend(std::coroutine_handle <promise_type> handle) noexcept
+{
+    promise = &handle.promise();
+    promise->wait = Wait::Input;
+
+    return;
+}
+
+
+SceneTask::SceneTask(std::coroutine_handle <promise_type> Handle)
+    : handle(Handle) {}
+
+
+SceneTask::SceneTask(SceneTask && other) noexcept
+    : handle(std::exchange(other.handle, nullptr)) {}
+
+
+SceneTask & SceneTask::operator = (SceneTask && other) noexcept
+{
+    if (this != &other)
+    {
+        if (handle)
+            handle.destroy();
+        handle = std::exchange(other.handle, nullptr);
+    }
+
+    return *this;
+}
+
+
+SceneTask::~SceneTask()
+{
+    if (handle)
+        handle.destroy();
+}
+
+
+SceneScheduler::SceneScheduler(size_t Capacity)
+    : frame(0), time(0.0)
+{
+    tasks.reserve(Capacity);
+}
+
+
+void SceneScheduler::spawn(SceneTask task)
+{
+    task.handle.promise().scheduler = this;
+    tasks.push_back(std::move(task));
+
+    return;
+}
+
+
+void SceneScheduler::tick()
+{
+    auto now = std::chrono::steady_clock::now();
+    if (frame == 0)
+        start = now;
+    frame++;
+    time = std::chrono::duration<double>(now - start).count();
+
+    // Tasks spawned during the loop are appended and reached in the same tick
+    for (size_t i = 0; i < tasks.size();)
+    {
+        const SceneTask::promise_type & promise = tasks[i].handle.promise();
+        bool due = (promise.wait == SceneTask::Wait::Frame && frame >= promise.resumeFrame)
+                   || (promise.wait == SceneTask::Wait::Time && frame >= promise.resumeFrame && time >= promise.resumeTime);
+
+        if (!due || resume(i))
+            i++;
+    }
+
+    return;
+}
+
+
+bool SceneScheduler::dispatch(const InputEvent & event)
+{
+    bool delivered = false;
+    for (size_t i = 0; i < tasks.size();)
+    {
+        SceneTask::promise_type & promise = tasks[i].handle.promise();
+        if (promise.wait != SceneTask::Wait::Input)
+        {
+            i++;
+            continue;
+        }
+
+        // Resumed tasks that wait for input again get the next event, not this one
+        promise.event = event;
+        promise.wait = SceneTask::Wait::Frame;
+        delivered = true;
+        if (resume(i))
+            i++;
+    }
+
+    return delivered;
+}
+
+
+void SceneScheduler::clear()
+{
+    tasks.clear();
+
+    return;
+}
+
+
+size_t SceneScheduler::getFrame() const
+{
+    return frame;
+}
+
+
+double SceneScheduler::getTime() const
+{
+    return time;
+}
+
+
+size_t SceneScheduler::size() const
+{
+    return tasks.size();
+}
+
+
+bool SceneScheduler::resume(size_t index)
+{
+    // Copy the handle: a spawn from inside the task may move the list
+    std::coroutine_handle <SceneTask::promise_type> handle = tasks[index].handle;
+    handle.resume();
+    if (!handle.done())
+        return true;
+
+    std::exception_ptr exception = handle.promise().exception;
+    tasks.erase(tasks.begin() + ptrdiff_t(index));
+    if (exception)
+        std::rethrow_exception(exception);
+
+    return false;
+}
@@ -0,0 +1,107 @@
+#include "SharedFrameSource.h"
+
+
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+
+SharedFrameSource::SharedFrameSource(const std::string & name, double FrameRate, bool ScaleRatio)
+    : TerminalLoop(DIMENSIONS, DIMENSIONS, FrameRate, ScaleRatio), frame(nullptr), size(0), shownSequence(0), framesShown(0), framesTorn(0)
+{
+    int fd = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0)
+        throw std::runtime_error("cannot open shared frame '" + name + "'");
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || size_t(status.st_size) < sizeof(SharedFrame))
+    {
+        close(fd);
+        throw std::runtime_error("'" + name + "' is not a shared frame");
+    }
+
+    size = size_t(status.st_size);
+    void * mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        throw std::runtime_error("cannot map shared frame '" + name + "'");
+    frame = static_cast<const SharedFrame *>(mapping);
+
+    if (frame->magic.load(std::memory_order_acquire) != SharedFrame::MAGIC || frame->version != SharedFrame::VERSION
+        || frame->height == 0 || frame->width == 0 || SharedFrame::getSize(frame->height, frame->width) > size)
+    {
+        munmap(mapping, size);
+        throw std::runtime_error("'" + name + "' is not a shared frame");
+    }
+
+    // Both grids get the frame size up front, so swapping them never reallocates
+    GRID(terminal).assign(frame->height, std::vector <OneSymbol>(frame->width));
+    pending.assign(frame->height, std::vector <OneSymbol>(frame->width));
+}
+
+
+SharedFrameSource::~SharedFrameSource()
+{
+    munmap(const_cast<SharedFrame *>(frame), size);
+}
+
+
+SharedFrameSource::Statistics SharedFrameSource::getStatistics() const
+{
+    return Statistics{framesShown, framesTorn, frame->sequence.load(std::memory_order_relaxed) / 2};
+}
+
+
+SharedFrameSource::Read SharedFrameSource::readFrame(const SharedFrame & frame, uint64_t & shownSequence,
+                                                    std::vector < std::vector < OneSymbol > > & grid)
+{
+    // The writer closes after publishing its last frame, so reading the flag first never skips that frame
+    bool closed = frame.closed.load(std::memory_order_acquire) != 0;
+    uint64_t sequence = frame.beginRead();
+    if ((sequence & 1) != 0)
+        return Read::Busy;
+    if (sequence == shownSequence)
+        return closed ? Read::Closed : Read::Unchanged;
+
+    const std::atomic <uint32_t> * cell = frame.getCells();
+    for (auto & row : grid)
+        for (auto & symbol : row)
+        {
+            uint32_t packed = (cell++)->load(std::memory_order_relaxed);
+            symbol.backgroundColor.setColor(double(packed >> 16 & 0xFF), double(packed >> 8 & 0xFF), double(packed & 0xFF));
+        }
+
+    // A writer that started meanwhile may have changed any cell; the next frame reads again
+    if (!frame.endRead(sequence))
+        return Read::Torn;
+
+    shownSequence = sequence;
+
+    return Read::Shown;
+}
+
+
+void SharedFrameSource::update()
+{
+    switch (readFrame(*frame, shownSequence, pending))
+    {
+        case Read::Shown:
+            std::swap(GRID(terminal), pending);
+            framesShown++;
+            break;
+        case Read::Torn:
+            framesTorn++;
+            break;
+        case Read::Closed:
+            stop();
+            break;
+        case Read::Unchanged:
+        case Read::Busy:
+            break;
+    }
+
+    return;
+}
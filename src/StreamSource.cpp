@@ -0,0 +1,343 @@
+#include "StreamSource.h"
+
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+
+
+namespace
+{
+    /// Size of the buffer used for header bytes; pixel data bypasses it.
+    constexpr size_t READ_BUFFER_BYTES = size_t(1) << 16;
+
+
+    bool isSpace(int ch)
+    {
+        return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\v' || ch == '\f';
+    }
+
+
+    size_t parseDimension(const std::string & token, const char * what)
+    {
+        size_t value = 0;
+        for (char ch : token)
+        {
+            if (ch < '0' || ch > '9' || value > 1000000)
+                throw std::runtime_error(std::string("invalid ") + what + " '" + token + "' in stream header");
+            value = value * 10 + size_t(ch - '0');
+        }
+        if (token.empty() || value == 0)
+            throw std::runtime_error(std::string("missing ") + what + " in stream header");
+
+        return value;
+    }
+}
+
+
+StreamSource::StreamSource(const std::string & path, Format StreamFormat, size_t RawWidth, size_t RawHeight, double FrameRate, bool ScaleRatio)
+    : TerminalLoop(DIMENSIONS, DIMENSIONS, FrameRate, ScaleRatio), sourceDescriptor(-1), ttyDescriptor(-1), ttySettings{}, wakeDescriptor(-1),
+      format(StreamFormat), rawWidth(RawWidth), rawHeight(RawHeight), readBuffer(READ_BUFFER_BYTES), readPosition(0), readEnd(0),
+      readyFull(false), endOfStream(false), stopping(false), framesRead(0), framesShown(0), bytesRead(0), openTime(std::chrono::steady_clock::now())
+{
+    if (format == Format::RawRGB24 && (rawWidth == 0 || rawHeight == 0))
+        throw std::runtime_error("raw RGB24 streams need a frame size");
+
+    if (path == "-")
+    {
+        sourceDescriptor = STDIN_FILENO;
+
+        // Standard input carries the frames, so the quit key has to come from the controlling terminal
+        ttyDescriptor = open("/dev/tty", O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (ttyDescriptor >= 0 && tcgetattr(ttyDescriptor, &ttySettings) == 0)
+        {
+            struct termios tty = ttySettings;
+            tty.c_lflag &= tcflag_t(~(ECHO | ICANON));
+            tcsetattr(ttyDescriptor, TCSANOW, &tty);
+        }
+        inputDescriptor = ttyDescriptor;
+    }
+    else
+        sourceDescriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    wakeDescriptor = eventfd(0, EFD_CLOEXEC);
+    if (sourceDescriptor < 0 || wakeDescriptor < 0)
+    {
+        if (sourceDescriptor > STDIN_FILENO)
+            close(sourceDescriptor);
+        if (wakeDescriptor >= 0)
+            close(wakeDescriptor);
+        if (ttyDescriptor >= 0)
+            close(ttyDescriptor);
+        throw std::runtime_error("cannot open stream '" + path + "'");
+    }
+
+    reader = std::thread(&StreamSource::readerLoop, this);
+}
+
+
+StreamSource::~StreamSource()
+{
+    {
+        std::lock_guard <std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+
+    uint64_t wake = 1;
+    [[maybe_unused]] ssize_t result = write(wakeDescriptor, &wake, sizeof(wake));
+    reader.join();
+
+    close(wakeDescriptor);
+    if (sourceDescriptor != STDIN_FILENO)
+        close(sourceDescriptor);
+    if (ttyDescriptor >= 0)
+    {
+        tcsetattr(ttyDescriptor, TCSANOW, &ttySettings);
+        close(ttyDescriptor);
+    }
+}
+
+
+StreamSource::Statistics StreamSource::getStatistics() const
+{
+    std::lock_guard <std::mutex> lock(mutex);
+    return Statistics{framesRead, framesShown, bytesRead.load(std::memory_order_relaxed),
+                      std::chrono::duration<double>(std::chrono::steady_clock::now() - openTime).count()};
+}
+
+
+void StreamSource::update()
+{
+    {
+        std::lock_guard <std::mutex> lock(mutex);
+        if (!readerError.empty())
+            throw std::runtime_error(readerError);
+
+        if (!readyFull)
+        {
+            if (endOfStream)
+                stop();
+            return;
+        }
+
+        std::swap(readyFrame, frontFrame);
+        readyFull = false;
+        framesShown++;
+    }
+    condition.notify_all();
+
+    auto & grid = GRID(terminal);
+    if (grid.size() != frontFrame.height)
+        grid.resize(frontFrame.height);
+
+    const uint8_t * pixel = frontFrame.pixels.data();
+    for (auto & row : grid)
+    {
+        if (row.size() != frontFrame.width)
+            row.resize(frontFrame.width);
+
+        for (auto & symbol : row)
+        {
+            if (frontFrame.channels < 3)
+                symbol.backgroundColor.setColor(pixel[0], pixel[0], pixel[0]);
+            else
+                symbol.backgroundColor.setColor(pixel[0], pixel[1], pixel[2]);
+            pixel += frontFrame.channels;
+        }
+    }
+
+    return;
+}
+
+
+void StreamSource::readerLoop()
+{
+    // The reader starts with the source, before the loop reads input, and its signals must still reach the loop
+    InputReader::blockSignals();
+
+    try
+    {
+        while (readFrame())
+        {
+            std::unique_lock <std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return !readyFull || stopping; });
+            if (stopping)
+                return;
+
+            std::swap(backFrame, readyFrame);
+            readyFull = true;
+            framesRead++;
+        }
+    }
+    catch (const std::exception & error)
+    {
+        std::lock_guard <std::mutex> lock(mutex);
+        if (!stopping)
+            readerError = error.what();
+    }
+
+    std::lock_guard <std::mutex> lock(mutex);
+    endOfStream = true;
+
+    return;
+}
+
+
+bool StreamSource::readFrame()
+{
+    if (format == Format::RawRGB24)
+    {
+        backFrame.width = rawWidth;
+        backFrame.height = rawHeight;
+        backFrame.channels = 3;
+    }
+    else if (!readNetpbmHeader())
+        return false;
+
+    backFrame.pixels.resize(backFrame.width * backFrame.height * backFrame.channels);
+
+    return readExact(backFrame.pixels.data(), backFrame.pixels.size());
+}
+
+
+bool StreamSource::readExact(uint8_t * destination, size_t size)
+{
+    size_t buffered = std::min(size, readEnd - readPosition);
+    std::memcpy(destination, readBuffer.data() + readPosition, buffered);
+    readPosition += buffered;
+
+    for (size_t done = buffered; done < size; )
+    {
+        struct pollfd descriptors[2] = {{sourceDescriptor, POLLIN, 0}, {wakeDescriptor, POLLIN, 0}};
+        if (poll(descriptors, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error("waiting for stream data failed");
+        }
+        if (descriptors[1].revents)
+            return false;
+
+        ssize_t result = read(sourceDescriptor, destination + done, size - done);
+        if (result < 0 && (errno == EINTR || errno == EAGAIN))
+            continue;
+        if (result < 0)
+            throw std::runtime_error("reading the stream failed");
+        if (result == 0)
+        {
+            if (done > 0)
+                throw std::runtime_error("stream ended in the middle of a frame");
+            return false;
+        }
+
+        done += size_t(result);
+        bytesRead.fetch_add(size_t(result), std::memory_order_relaxed);
+    }
+
+    return true;
+}
+
+
+int StreamSource::nextByte()
+{
+    if (readPosition == readEnd)
+    {
+        readPosition = readEnd = 0;
+        while (true)
+        {
+            struct pollfd descriptors[2] = {{sourceDescriptor, POLLIN, 0}, {wakeDescriptor, POLLIN, 0}};
+            if (poll(descriptors, 2, -1) < 0 && errno != EINTR)
+                throw std::runtime_error("waiting for stream data failed");
+            if (descriptors[1].revents)
+                return -1;
+
+            ssize_t result = read(sourceDescriptor, readBuffer.data(), readBuffer.size());
+            if (result < 0 && (errno == EINTR || errno == EAGAIN))
+                continue;
+            if (result < 0)
+                throw std::runtime_error("reading the stream failed");
+            if (result == 0)
+                return -1;
+
+            readEnd = size_t(result);
+            bytesRead.fetch_add(size_t(result), std::memory_order_relaxed);
+            break;
+        }
+    }
+
+    return readBuffer[readPosition++];
+}
+
+
+std::string StreamSource::nextToken()
+{
+    int ch = nextByte();
+    while (ch == '#' || isSpace(ch))
+    {
+        if (ch == '#')
+            while (ch != '\n' && ch != -1)
+                ch = nextByte();
+        ch = nextByte();
+    }
+
+    std::string token;
+    while (ch != -1 && !isSpace(ch))
+    {
+        token += char(ch);
+        ch = nextByte();
+    }
+
+    return token;
+}
+
+
+bool StreamSource::readNetpbmHeader()
+{
+    std::string magic = nextToken();
+    if (magic.empty())
+        return false;
+
+    size_t maxValue = 0;
+    if (magic == "P5" || magic == "P6")
+    {
+        backFrame.width = parseDimension(nextToken(), "width");
+        backFrame.height = parseDimension(nextToken(), "height");
+        maxValue = parseDimension(nextToken(), "maximum value");
+        backFrame.channels = magic == "P5" ? 1 : 3;
+    }
+    else if (magic == "P7")
+    {
+        backFrame.width = backFrame.height = backFrame.channels = 0;
+        for (std::string key = nextToken(); key != "ENDHDR"; key = nextToken())
+        {
+            if (key.empty())
+                throw std::runtime_error("stream ended inside a PAM header");
+            else if (key == "WIDTH")
+                backFrame.width = parseDimension(nextToken(), "width");
+            else if (key == "HEIGHT")
+                backFrame.height = parseDimension(nextToken(), "height");
+            else if (key == "DEPTH")
+                backFrame.channels = parseDimension(nextToken(), "depth");
+            else if (key == "MAXVAL")
+                maxValue = parseDimension(nextToken(), "maximum value");
+            else if (key == "TUPLTYPE")
+                nextToken();
+            else
+                throw std::runtime_error("unknown PAM header field '" + key + "'");
+        }
+        if (backFrame.width == 0 || backFrame.height == 0)
+            throw std::runtime_error("PAM header without frame size");
+        if (backFrame.channels != 1 && backFrame.channels != 3 && backFrame.channels != 4)
+            throw std::runtime_error("unsupported PAM depth " + std::to_string(backFrame.channels));
+    }
+    else
+        throw std::runtime_error("unsupported frame type '" + magic + "'");
+
+    if (maxValue != 255)
+        throw std::runtime_error("only 8-bit frames are supported");
+
+    return true;
+}
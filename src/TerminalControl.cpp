@@ -5,14 +5,81 @@
 
 
 #include "TerminalControl.h"
+#include "ColorSpace.h"
+#include "FixedColor.h"
+#include "GlyphTable.h"
+#include "TileScheduler.h"
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+
+
+namespace
+{
+	/// Begins and ends a synchronized update (DEC private mode 2026).
+	constexpr std::string_view BEGIN_SYNCHRONIZED = "\033[?2026h";
+	constexpr std::string_view END_SYNCHRONIZED = "\033[?2026l";
+
+	/// Live TerminalControl instances; the terminal is set up by the first and restored by the last.
+	size_t liveInstances = 0;
+
+
+	/**
+	 * @brief Writes buffers to standard output in order, resuming after partial writes.
+	 *
+	 * @return size_t Number of bytes written.
+	 */
+	size_t writeParts(iovec * parts, size_t count)
+	{
+		// Anything still buffered in std::cout must reach the terminal first
+		std::cout.flush();
+
+		size_t written = 0;
+		while (count > 0)
+		{
+			ssize_t result = writev(STDOUT_FILENO, parts, int(count));
+			if (result < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				if (errno != EAGAIN)
+					break;
+
+				pollfd descriptor{STDOUT_FILENO, POLLOUT, 0};
+				poll(&descriptor, 1, -1);
+				continue;
+			}
+
+			// Skip the parts written completely and trim the one written in part
+			size_t left = size_t(result);
+			written += left;
+			for (; count > 0 && left >= parts->iov_len; parts++, count--)
+				left -= parts->iov_len;
+			if (count > 0)
+			{
+				parts->iov_base = static_cast<char *>(parts->iov_base) + left;
+				parts->iov_len -= left;
+			}
+		}
+
+		return written;
+	}
+}
 
 
 TerminalControl::TerminalControl(const size_t Height, const size_t Width)
+	: width(0), height(0), outputWidth(0), outputHeight(0), resized(false), linearLight(false), synchronizedOutput(false), sparseFrames(false)
 {
 	activeGrid.resize(Height);
 	for (size_t i = 0; i < Height; i++)
 		activeGrid[i].resize(Width);
 
+	if (liveInstances++ > 0)
+		return;
+
 	// Disable cursor visibility
 	std::cout << "\033[?25l";
 	std::cout.flush();
@@ -30,6 +97,9 @@ TerminalControl::TerminalControl(const size_t Height, const size_t Width)
 
 TerminalControl::~TerminalControl()
 {
+	if (--liveInstances > 0)
+		return;
+
 	// Re-enable cursor visibility
 	std::cout << "\033[?25h";
 	std::cout.flush();
@@ -51,6 +121,13 @@ TerminalControl::operator std::vector <std::vector<OneSymbol> > & ()
 
 void TerminalControl::getTerminalSize()
 {
+	if (outputHeight > 0 && outputWidth > 0)
+	{
+		width = outputWidth;
+		height = outputHeight;
+		return;
+	}
+
 	struct winsize w;
 	if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0)
 	{
@@ -73,6 +150,10 @@ void TerminalControl::clearTerminal() const
 
 void TerminalControl::setTerminalSize()
 {
+	resized = scaledGrid.size() != height || (height > 0 && scaledGrid.front().size() != width);
+	if (!resized)
+		return;
+
 	scaledGrid.resize(height);
 	for (size_t i = 0; i < height; i++)
 		scaledGrid[i].resize(width);
@@ -81,64 +162,466 @@ void TerminalControl::setTerminalSize()
 }
 
 
-void TerminalControl::printTerminal() const
+size_t TerminalControl::printTerminal()
+{
+	bool sparse = synchronizedOutput && sparseFrames && printedGrid.size() == scaledGrid.size()
+				  && !printedGrid.empty() && printedGrid.front().size() == scaledGrid.front().size();
+
+	size_t capacity = (sparse ? FrameEncoder::maxDiffSize(scaledGrid) : FrameEncoder::maxEncodedSize(scaledGrid))
+					  + BEGIN_SYNCHRONIZED.size() + END_SYNCHRONIZED.size();
+	char * frame = frameArena.allocateArray<char>(capacity);
+	iovec * parts = frameArena.allocateArray<iovec>(FrameEncoder::MAX_SLICES + 2);
+	size_t count = 0;
+
+	// Rows are encoded in parallel into slices of one buffer, then written in order by a single writev
+	if (synchronizedOutput)
+	{
+		std::memcpy(frame, BEGIN_SYNCHRONIZED.data(), BEGIN_SYNCHRONIZED.size());
+		parts[count++] = iovec{frame, BEGIN_SYNCHRONIZED.size()};
+	}
+	count += encoder.encodeSlices(scaledGrid, sparse ? &printedGrid : nullptr, frame + BEGIN_SYNCHRONIZED.size(), parts + count);
+	if (synchronizedOutput)
+	{
+		char * end = frame + capacity - END_SYNCHRONIZED.size();
+		std::memcpy(end, END_SYNCHRONIZED.data(), END_SYNCHRONIZED.size());
+		parts[count++] = iovec{end, END_SYNCHRONIZED.size()};
+	}
+
+	size_t length = writeParts(parts, count);
+
+	// Same-sized rows are copied in place, so steady-state frames do not allocate
+	if (synchronizedOutput && sparseFrames)
+		printedGrid = scaledGrid;
+
+	return length;
+}
+
+
+size_t TerminalControl::printRegions(const std::vector <FrameEncoder::Region> & regions)
 {
-	for (size_t i = 0; i < scaledGrid.size(); i++)
-		for (size_t ii = 0; ii < scaledGrid.front().size(); ii++)
-			std::cout << scaledGrid[i][ii];
+	size_t capacity = BEGIN_SYNCHRONIZED.size() + END_SYNCHRONIZED.size();
+	for (const FrameEncoder::Region & region : regions)
+		capacity += FrameEncoder::maxRegionSize(region);
+
+	char * frame = frameArena.allocateArray<char>(capacity);
+	size_t length = 0;
+
+	if (synchronizedOutput)
+	{
+		std::memcpy(frame, BEGIN_SYNCHRONIZED.data(), BEGIN_SYNCHRONIZED.size());
+		length += BEGIN_SYNCHRONIZED.size();
+	}
+	for (const FrameEncoder::Region & region : regions)
+		length += encoder.encodeRegion(scaledGrid, region, frame + length);
+	if (synchronizedOutput)
+	{
+		std::memcpy(frame + length, END_SYNCHRONIZED.data(), END_SYNCHRONIZED.size());
+		length += END_SYNCHRONIZED.size();
+	}
+
+	std::cout.write(frame, std::streamsize(length));
 	std::cout.flush();
 
+	// Keep the grid sparse frames diff against in step with the screen
+	if (printedGrid.size() == scaledGrid.size())
+		for (const FrameEncoder::Region & region : regions)
+			for (size_t i = region.top; i < std::min(region.top + region.height, scaledGrid.size()); i++)
+			{
+				size_t first = std::min(region.left, scaledGrid[i].size());
+				size_t last = std::min(region.left + region.width, scaledGrid[i].size());
+				if (printedGrid[i].size() == scaledGrid[i].size())
+					std::copy(scaledGrid[i].begin() + ptrdiff_t(first), scaledGrid[i].begin() + ptrdiff_t(last), printedGrid[i].begin() + ptrdiff_t(first));
+			}
+
+	return length;
+}
+
+
+void TerminalControl::setOutputSize(size_t Height, size_t Width)
+{
+	outputHeight = Height;
+	outputWidth = Width;
+
+	return;
+}
+
+
+void TerminalControl::setSynchronizedOutput(bool enabled)
+{
+	synchronizedOutput = enabled;
+	printedGrid.clear();
+
+	return;
+}
+
+
+bool TerminalControl::hasSynchronizedOutput() const
+{
+	return synchronizedOutput;
+}
+
+
+void TerminalControl::setSparseFrames(bool enabled)
+{
+	sparseFrames = enabled;
+	printedGrid.clear();
+
 	return;
 }
 
 
 std::string TerminalControl::toString() const
 {
-	std::string buffer;
-	for (size_t i = 0; i < scaledGrid.size(); i++)
-		for (size_t ii = 0; ii < scaledGrid.front().size(); ii++)
-			buffer += scaledGrid[i][ii].toString();
+	std::string buffer(FrameEncoder::maxEncodedSize(scaledGrid), '\0');
+	buffer.resize(encoder.encodeParallel(scaledGrid, buffer.data()));
 
 	return buffer;
 }
 
 
+const std::vector < std::vector < OneSymbol > > & TerminalControl::getScaledGrid() const
+{
+	return scaledGrid;
+}
+
+
+std::vector < std::vector < OneSymbol > > & TerminalControl::getScaledGrid()
+{
+	return scaledGrid;
+}
+
+
+FrameEncoder & TerminalControl::getEncoder()
+{
+	return encoder;
+}
+
+
+FrameArena & TerminalControl::getFrameArena()
+{
+	return frameArena;
+}
+
+
+void TerminalControl::endFrame()
+{
+	frameArena.reset();
+
+	return;
+}
+
+
+bool TerminalControl::wasResized() const
+{
+	return resized;
+}
+
+
 void TerminalControl::setUpScaledGrid(bool scaleRatio)
+{
+	resizeScaledGrid();
+
+	size_t sourceHeight = activeGrid.size(), sourceWidth = activeGrid[0].size();
+	if (resampler.getFilter() != Resampler::Filter::Area)
+		resampleBackground(scaleRatio);
+	else if (linearLight)
+	{
+		// Convert every source cell once per frame instead of once per overlapping target cell
+		uint16_t * linear = frameArena.allocateArray<uint16_t>(3 * sourceHeight * sourceWidth);
+		for (size_t i = 0; i < sourceHeight; i++)
+		{
+			const OneSymbol * row = activeGrid[i].data();
+			uint16_t * out = linear + 3 * i * sourceWidth;
+			for (size_t j = 0; j < sourceWidth; j++)
+			{
+				out[3 * j] = ColorSpace::toLinear(row[j].backgroundColor.getR());
+				out[3 * j + 1] = ColorSpace::toLinear(row[j].backgroundColor.getG());
+				out[3 * j + 2] = ColorSpace::toLinear(row[j].backgroundColor.getB());
+			}
+		}
+
+		scaleArea<true>([linear, sourceWidth](size_t row, size_t col)
+						{
+							const uint16_t * cell = linear + 3 * (row * sourceWidth + col);
+							return Color(cell[0], cell[1], cell[2]);
+						},
+						sourceHeight, sourceWidth, scaledGrid, scaleRatio);
+	}
+	else
+	{
+		// Bytes are all the fixed-point scaler needs; truncation matches what the encoder prints
+		uint8_t * bytes = frameArena.allocateArray<uint8_t>(3 * sourceHeight * sourceWidth);
+		for (size_t i = 0; i < sourceHeight; i++)
+		{
+			const OneSymbol * row = activeGrid[i].data();
+			FixedColor::Rgb * out = reinterpret_cast<FixedColor::Rgb *>(bytes + 3 * i * sourceWidth);
+			for (size_t j = 0; j < sourceWidth; j++)
+				out[j] = FixedColor::fromColor(row[j].backgroundColor);
+		}
+
+		scaleAreaFixed(PixelView{bytes, sourceWidth, sourceHeight, 3, ptrdiff_t(3 * sourceWidth), false}, scaledGrid, scaleRatio);
+	}
+
+	// Glyphs cannot be averaged, so each cell takes the glyph and ink of the source cell under its center; a wide glyph
+	// always lands together with its right half, and a half that cannot be paired becomes a blank
+	double rowScale, colScale;
+	computeScalingFactors(activeGrid.size(), activeGrid[0].size(), height, width, rowScale, colScale, scaleRatio);
+	auto sourceColumn = [colScale](size_t j, size_t columns) { return std::min(size_t(((double)j + 0.5) * colScale), columns - 1); };
+	for (size_t i = 0; i < height; i++)
+	{
+		const auto & source = activeGrid[std::min(size_t(((double)i + 0.5) * rowScale), activeGrid.size() - 1)];
+		OneSymbol * scaled = scaledGrid[i].data();
+		for (size_t j = 0; j < width; j++)
+		{
+			size_t col = sourceColumn(j, source.size());
+			const OneSymbol * nearest = &source[col];
+
+			// A right half sampled without its left half brings the whole glyph along when the next column is free
+			if (nearest->symbol == GlyphTable::CONTINUATION && col > 0 && GlyphTable::isWide(source[col - 1].symbol) && j + 1 < width)
+			{
+				GlyphId next = source[sourceColumn(j + 1, source.size())].symbol;
+				if (next == ' ' || next == GlyphTable::CONTINUATION)
+					nearest = &source[col - 1];
+			}
+
+			scaled[j].foregroundColor = nearest->foregroundColor;
+			if (GlyphTable::isWide(nearest->symbol) && j + 1 < width)
+			{
+				scaled[j].symbol = nearest->symbol;
+				scaled[++j].symbol = GlyphTable::CONTINUATION;
+				scaled[j].foregroundColor = nearest->foregroundColor;
+			}
+			else if (GlyphTable::isWide(nearest->symbol) || nearest->symbol == GlyphTable::CONTINUATION)
+				scaled[j].symbol = ' ';
+			else
+				scaled[j].symbol = nearest->symbol;
+		}
+	}
+
+	return;
+}
+
+
+void TerminalControl::resizeScaledGrid()
 {
 	getTerminalSize();
 	setTerminalSize();
 
+	return;
+}
+
+
+void TerminalControl::loadImage(const PixelView & image, size_t Height, size_t Width)
+{
+	activeGrid.resize(Height);
+	for (size_t i = 0; i < Height; i++)
+		activeGrid[i].resize(Width);
+
+	if (linearLight)
+		scaleArea<true>([&image](size_t row, size_t col)
+						{
+							Color color = image.getColor(row, col);
+							return Color(ColorSpace::SRGB_TO_LINEAR[size_t(color.getRed())], ColorSpace::SRGB_TO_LINEAR[size_t(color.getGreen())],
+										 ColorSpace::SRGB_TO_LINEAR[size_t(color.getBlue())]);
+						}, image.height, image.width, activeGrid, true);
+	else
+		scaleAreaFixed(image, activeGrid, true);
+
+	return;
+}
+
+
+void TerminalControl::setLinearLight(bool enabled)
+{
+	linearLight = enabled;
+
+	return;
+}
+
+
+void TerminalControl::setResampleFilter(Resampler::Filter filter)
+{
+	resampler.setFilter(filter);
+
+	return;
+}
+
+
+void TerminalControl::resampleBackground(bool scaleRatio)
+{
+	size_t sourceHeight = activeGrid.size(), sourceWidth = activeGrid[0].size();
+	size_t sourcePlane = sourceHeight * sourceWidth, targetPlane = height * width;
+
+	// Planar channels keep both resampling passes on contiguous memory
+	float * source = frameArena.allocateArray<float>(3 * sourcePlane);
+	for (size_t i = 0; i < sourceHeight; i++)
+	{
+		const OneSymbol * row = activeGrid[i].data();
+		float * red = source + i * sourceWidth;
+		for (size_t j = 0; j < sourceWidth; j++)
+		{
+			const Color & color = row[j].backgroundColor;
+			red[j] = float(linearLight ? ColorSpace::toLinear(color.getR()) : color.getR());
+			red[j + sourcePlane] = float(linearLight ? ColorSpace::toLinear(color.getG()) : color.getG());
+			red[j + 2 * sourcePlane] = float(linearLight ? ColorSpace::toLinear(color.getB()) : color.getB());
+		}
+	}
+
 	double rowScale, colScale;
-	computeScalingFactors(rowScale, colScale, scaleRatio);
+	computeScalingFactors(sourceHeight, sourceWidth, height, width, rowScale, colScale, scaleRatio);
+
+	float * target = frameArena.allocateArray<float>(3 * targetPlane);
+	resampler.resample(source, sourceHeight, sourceWidth, target, height, width, rowScale, colScale, frameArena);
 
-	#pragma omp target teams distribute parallel for collapse(2)
 	for (size_t i = 0; i < height; i++)
 	{
+		OneSymbol * row = scaledGrid[i].data();
+		const float * red = target + i * width;
 		for (size_t j = 0; j < width; j++)
 		{
-			double srcRowStart, srcRowEnd;
-			getSourceRowRange(i, rowScale, srcRowStart, srcRowEnd);
+			// Lanczos lobes overshoot; setColor clamps and toSrgb saturates
+			if (linearLight)
+				row[j].backgroundColor.setColor(ColorSpace::toSrgb(red[j]), ColorSpace::toSrgb(red[j + targetPlane]),
+												ColorSpace::toSrgb(red[j + 2 * targetPlane]));
+			else
+				row[j].backgroundColor.setColor(red[j], red[j + targetPlane], red[j + 2 * targetPlane]);
+		}
+	}
+
+	return;
+}
+
+
+template <bool LinearLight, typename Sample>
+void TerminalControl::scaleArea(const Sample & sample, size_t sourceHeight, size_t sourceWidth,
+								std::vector < std::vector < OneSymbol > > & target, bool scaleRatio) const
+{
+	size_t targetHeight = target.size();
+	size_t targetWidth = target.empty() ? 0 : target.front().size();
+
+	double rowScale, colScale;
+	computeScalingFactors(sourceHeight, sourceWidth, targetHeight, targetWidth, rowScale, colScale, scaleRatio);
+
+	TileScheduler::instance().parallelFor(targetHeight, 1, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; i++)
+		{
+			for (size_t j = 0; j < targetWidth; j++)
+			{
+				double srcRowStart, srcRowEnd;
+				getSourceRowRange(i, rowScale, srcRowStart, srcRowEnd);
 
-			double srcColStart, srcColEnd;
-			getSourceColRange(j, colScale, srcColStart, srcColEnd);
+				double srcColStart, srcColEnd;
+				getSourceColRange(j, colScale, srcColStart, srcColEnd);
 
-			size_t rowStart, rowEnd, colStart, colEnd;
-			getSourceBounds(srcRowStart, srcRowEnd, srcColStart, srcColEnd, rowStart, rowEnd, colStart, colEnd);
+				size_t rowStart, rowEnd, colStart, colEnd;
+				getSourceBounds(srcRowStart, srcRowEnd, srcColStart, srcColEnd, sourceHeight, sourceWidth, rowStart, rowEnd, colStart, colEnd);
 
-			Color computedColor(0,0,0);
-			computeAveragedColor(rowStart, rowEnd, colStart, colEnd, srcRowStart, srcRowEnd, srcColStart, srcColEnd, computedColor);
+				Color computedColor(0,0,0);
+				computeAveragedColor<LinearLight>(sample, rowStart, rowEnd, colStart, colEnd, srcRowStart, srcRowEnd, srcColStart, srcColEnd, computedColor);
 
-			scaledGrid[i][j].backgroundColor.setColor(computedColor);
+				target[i][j].backgroundColor.setColor(computedColor);
+			}
 		}
-	}
+	});
+
+	return;
+}
+
+void TerminalControl::scaleAreaFixed(const PixelView & source, std::vector < std::vector < OneSymbol > > & target, bool scaleRatio)
+{
+	size_t targetHeight = target.size();
+	size_t targetWidth = target.empty() ? 0 : target.front().size();
+
+	double rowScale, colScale;
+	computeScalingFactors(source.height, source.width, targetHeight, targetWidth, rowScale, colScale, scaleRatio);
+
+	AxisWeights rows = buildAxisWeights(targetHeight, source.height, rowScale, frameArena);
+	AxisWeights cols = buildAxisWeights(targetWidth, source.width, colScale, frameArena);
+
+	size_t channels = source.channels;
+	size_t redIndex = channels < 3 ? 0 : source.bgr ? 2 : 0;
+	size_t greenIndex = channels < 3 ? 0 : 1;
+	size_t blueIndex = channels < 3 ? 0 : source.bgr ? 0 : 2;
+
+	TileScheduler::instance().parallelFor(targetHeight, 1, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; i++)
+		{
+			for (size_t j = 0; j < targetWidth; j++)
+			{
+				uint64_t rSum = 0, gSum = 0, bSum = 0, sumWeight = 0;
+
+				for (size_t r = rows.offset[i]; r < rows.offset[i + 1]; r++)
+				{
+					const uint8_t * sourceRow = source.data + ptrdiff_t(rows.first[i] + r - rows.offset[i]) * source.rowStride;
+					for (size_t c = cols.offset[j]; c < cols.offset[j + 1]; c++)
+					{
+						const uint8_t * pixel = sourceRow + (cols.first[j] + c - cols.offset[j]) * channels;
+						uint32_t weight = uint32_t(rows.weight[r]) * cols.weight[c];
+						rSum += uint64_t(pixel[redIndex]) * weight;
+						gSum += uint64_t(pixel[greenIndex]) * weight;
+						bSum += uint64_t(pixel[blueIndex]) * weight;
+						sumWeight += weight;
+					}
+				}
+
+				// One reciprocal instead of three 64-bit divisions
+				if (sumWeight > 0)
+				{
+					double reciprocal = 1.0 / double(sumWeight);
+					target[i][j].backgroundColor.setColor(std::floor(double(rSum) * reciprocal + 0.5), std::floor(double(gSum) * reciprocal + 0.5),
+														  std::floor(double(bSum) * reciprocal + 0.5));
+				}
+				else
+					target[i][j].backgroundColor.setColor(Colors::BLACK);
+			}
+		}
+	});
 
 	return;
 }
 
-void TerminalControl::computeScalingFactors(double & rowScale, double & colScale, bool scaleRatio) const
+
+TerminalControl::AxisWeights TerminalControl::buildAxisWeights(size_t targetSize, size_t sourceSize, double scale, FrameArena & arena)
+{
+	AxisWeights axis;
+	size_t * first = arena.allocateArray<size_t>(targetSize);
+	size_t * offset = arena.allocateArray<size_t>(targetSize + 1);
+
+	// Each target cell overlaps at most ceil(scale) + 1 source cells
+	size_t maxTaps = size_t(scale) + 2;
+	FixedColor::Coefficient * weight = arena.allocateArray<FixedColor::Coefficient>(targetSize * maxTaps);
+
+	size_t taps = 0;
+	for (size_t t = 0; t < targetSize; t++)
+	{
+		double start = (double)t * scale;
+		double end = ((double)t + 1) * scale;
+		first[t] = size_t(start);
+		offset[t] = taps;
+
+		for (size_t s = first[t]; s <= std::min(size_t(end), sourceSize - 1) && s < sourceSize; s++)
+		{
+			double overlap = std::max(0.0, std::min(end, s + 1.0) - std::max(start, static_cast<double>(s)));
+			weight[taps++] = FixedColor::toCoefficient(overlap);
+		}
+	}
+	offset[targetSize] = taps;
+
+	axis.first = first;
+	axis.offset = offset;
+	axis.weight = weight;
+
+	return axis;
+}
+
+
+void TerminalControl::computeScalingFactors(size_t sourceHeight, size_t sourceWidth, size_t targetHeight, size_t targetWidth,
+											double & rowScale, double & colScale, bool scaleRatio) const
 {
-	rowScale = (double)activeGrid.size() / (double)height;
-	colScale = (double)activeGrid[0].size() / (double)width;
+	rowScale = (double)sourceHeight / (double)targetHeight;
+	colScale = (double)sourceWidth / (double)targetWidth;
 
 	if (scaleRatio)
 		return;
@@ -167,17 +650,19 @@ void TerminalControl::getSourceColRange(size_t j, double colScale, double &srcCo
 }
 
 void TerminalControl::getSourceBounds(double srcRowStart, double srcRowEnd, double srcColStart, double srcColEnd,
+									  size_t sourceHeight, size_t sourceWidth,
 									  size_t & rowStart, size_t & rowEnd, size_t & colStart, size_t & colEnd) const
 {
 	rowStart = (size_t)srcRowStart;
-	rowEnd = std::min((size_t)srcRowEnd, activeGrid.size() - 1);
+	rowEnd = std::min((size_t)srcRowEnd, sourceHeight - 1);
 	colStart = (size_t)srcColStart;
-	colEnd = std::min((size_t)srcColEnd, activeGrid[0].size() - 1);
+	colEnd = std::min((size_t)srcColEnd, sourceWidth - 1);
 
 	return;
 }
 
-void TerminalControl::computeAveragedColor(size_t rowStart, size_t rowEnd, size_t colStart, size_t colEnd,
+template <bool LinearLight, typename Sample>
+void TerminalControl::computeAveragedColor(const Sample & sample, size_t rowStart, size_t rowEnd, size_t colStart, size_t colEnd,
 										   double srcRowStart, double srcRowEnd, double srcColStart,
 										   double srcColEnd, Color &computedColor) const
 {
@@ -193,15 +678,17 @@ void TerminalControl::computeAveragedColor(size_t rowStart, size_t rowEnd, size_
 			double colOverlap = std::min(srcColEnd, srcCol + 1.0) - std::max(srcColStart, static_cast<double>(srcCol));
 			double weight = rowOverlap * colOverlap;
 
-			const OneSymbol &sample = activeGrid[srcRow][srcCol]; // Use reference to avoid copying
-			rSum += sample.backgroundColor.getR() * weight;
-			gSum += sample.backgroundColor.getG() * weight;
-			bSum += sample.backgroundColor.getB() * weight;
+			const Color & color = sample(srcRow, srcCol); // Reference when the source stores Colors
+			rSum += color.getR() * weight;
+			gSum += color.getG() * weight;
+			bSum += color.getB() * weight;
 			sumWeight += weight;
 		}
 	}
 
-	if (sumWeight > 0.0)
+	if (sumWeight > 0.0 && LinearLight)
+		computedColor.setColor(ColorSpace::toSrgb(rSum / sumWeight), ColorSpace::toSrgb(gSum / sumWeight), ColorSpace::toSrgb(bSum / sumWeight));
+	else if (sumWeight > 0.0)
 	{
 		computedColor.setRed(rSum / sumWeight);
 		computedColor.setGreen(gSum / sumWeight);
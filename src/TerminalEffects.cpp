@@ -1,6 +1,34 @@
 #include "TerminalEffects.h"
 
 
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+
+#include "FixedColor.h"
+#include "GlyphTable.h"
+
+
+namespace
+{
+    /// Whole, reasonably sized increments can be applied with integer arithmetic.
+    bool isWhole(double value)
+    {
+        return value == std::trunc(value) && std::abs(value) <= 255.0;
+    }
+
+
+    /// Effects that fill every cell with one glyph need one that covers exactly one column.
+    void requireNarrow(GlyphId glyph)
+    {
+        const GlyphTable::Glyph & entry = GlyphTable::get(glyph);
+        if (entry.width != 1)
+            throw std::invalid_argument("glyph '" + std::string(entry.bytes, entry.length) + "' is not one column wide");
+    }
+}
+
+
 void TerminalEffects::changeBackgroundColorEffect(std::vector < std::vector <OneSymbol> > & terminalGrid, const Color & newColor)
 {
     for (auto & row : terminalGrid)
@@ -21,8 +49,9 @@ void TerminalEffects::changeForegroundColorEffect(std::vector < std::vector <One
 }
 
 
-void TerminalEffects::changeSymbolEffect(std::vector < std::vector <OneSymbol> > & terminalGrid, const char newSymbol)
+void TerminalEffects::changeSymbolEffect(std::vector < std::vector <OneSymbol> > & terminalGrid, const GlyphId newSymbol)
 {
+    requireNarrow(newSymbol);
     for (auto & row : terminalGrid)
         for (auto & symbol : row)
             symbol.symbol = newSymbol;
@@ -31,8 +60,9 @@ void TerminalEffects::changeSymbolEffect(std::vector < std::vector <OneSymbol> >
 }
 
 
-void TerminalEffects::changeTerminalToEffect(std::vector<std::vector<OneSymbol>> &terminalGrid, const char newSymbol, const Color &newForegroundColor, const Color &newBackgroundColor)
+void TerminalEffects::changeTerminalToEffect(std::vector<std::vector<OneSymbol>> &terminalGrid, const GlyphId newSymbol, const Color &newForegroundColor, const Color &newBackgroundColor)
 {
+    requireNarrow(newSymbol);
     for (auto & row : terminalGrid)
         for (auto & symbol : row)
         {
@@ -57,6 +87,19 @@ void TerminalEffects::invertColorEffect(std::vector<std::vector<OneSymbol>> &ter
 
 void TerminalEffects::adjustBrightnessByIncrementEffect(std::vector<std::vector<OneSymbol>> &terminalGrid, const double increment)
 {
+    if (isWhole(increment))
+    {
+        int step = int(increment);
+        for (auto & row : terminalGrid)
+            for (auto & symbol : row)
+            {
+                symbol.backgroundColor = FixedColor::toColor(FixedColor::adjust(FixedColor::fromColor(symbol.backgroundColor), step, step, step));
+                symbol.foregroundColor = FixedColor::toColor(FixedColor::adjust(FixedColor::fromColor(symbol.foregroundColor), step, step, step));
+            }
+
+        return;
+    }
+
     for (auto & row : terminalGrid)
         for (auto & symbol : row)
         {
@@ -71,6 +114,20 @@ void TerminalEffects::adjustBrightnessByIncrementEffect(std::vector<std::vector<
 
 void TerminalEffects::incrementColorEffect(std::vector<std::vector<OneSymbol>> &terminalGrid, const Color foregroundColorIncrement, const Color backgroundColorIncrement)
 {
+    const Color & fg = foregroundColorIncrement;
+    const Color & bg = backgroundColorIncrement;
+    if (isWhole(fg.getR()) && isWhole(fg.getG()) && isWhole(fg.getB()) && isWhole(bg.getR()) && isWhole(bg.getG()) && isWhole(bg.getB()))
+    {
+        for (auto & row : terminalGrid)
+            for (auto & symbol : row)
+            {
+                symbol.foregroundColor = FixedColor::toColor(FixedColor::adjust(FixedColor::fromColor(symbol.foregroundColor), fg.getRed(), fg.getGreen(), fg.getBlue()));
+                symbol.backgroundColor = FixedColor::toColor(FixedColor::adjust(FixedColor::fromColor(symbol.backgroundColor), bg.getRed(), bg.getGreen(), bg.getBlue()));
+            }
+
+        return;
+    }
+
     for (auto & row : terminalGrid)
         for (auto & symbol : row)
         {
@@ -80,3 +137,147 @@ void TerminalEffects::incrementColorEffect(std::vector<std::vector<OneSymbol>> &
 
     return;
 }
+
+
+void TerminalEffects::asciiArtEffect(std::vector<std::vector<OneSymbol>> &terminalGrid, const GlyphRamp &ramp, FrameArena &arena, bool detectEdges)
+{
+    size_t rows = terminalGrid.size();
+    size_t cols = rows > 0 ? terminalGrid.front().size() : 0;
+    uint8_t * luminance = arena.allocateArray<uint8_t>(rows * cols);
+
+    // Rec. 709 luma in one branch-free pass per row
+    for (size_t i = 0; i < rows; i++)
+    {
+        const OneSymbol * row = terminalGrid[i].data();
+        uint8_t * rowLuminance = luminance + i * cols;
+
+        #pragma omp simd
+        for (size_t ii = 0; ii < cols; ii++)
+        {
+            const Color & color = row[ii].backgroundColor;
+            double value = 0.2126 * color.getR() + 0.7152 * color.getG() + 0.0722 * color.getB();
+            rowLuminance[ii] = uint8_t(std::clamp(value, 0.0, 255.0) + 0.5);
+        }
+    }
+
+    // Sum of absolute Sobel responses above which a cell counts as an edge
+    constexpr int EDGE_THRESHOLD = 384;
+
+    for (size_t i = 0; i < rows; i++)
+    {
+        size_t up = i > 0 ? i - 1 : i;
+        size_t down = i + 1 < rows ? i + 1 : i;
+
+        for (size_t ii = 0; ii < cols; ii++)
+        {
+            OneSymbol & symbol = terminalGrid[i][ii];
+            symbol.symbol = ramp.getGlyph(luminance[i * cols + ii]);
+
+            if (detectEdges)
+            {
+                size_t left = ii > 0 ? ii - 1 : ii;
+                size_t right = ii + 1 < cols ? ii + 1 : ii;
+                auto at = [&](size_t row, size_t col) { return int(luminance[row * cols + col]); };
+
+                int gx = at(up, right) + 2 * at(i, right) + at(down, right) - at(up, left) - 2 * at(i, left) - at(down, left);
+                int gy = at(down, left) + 2 * at(down, ii) + at(down, right) - at(up, left) - 2 * at(up, ii) - at(up, right);
+                int ax = std::abs(gx), ay = std::abs(gy);
+
+                // The edge runs perpendicular to the luminance gradient
+                if (ax + ay > EDGE_THRESHOLD)
+                {
+                    if (ax > 2 * ay)
+                        symbol.symbol = '|';
+                    else if (ay > 2 * ax)
+                        symbol.symbol = '-';
+                    else
+                        symbol.symbol = (gx > 0) == (gy > 0) ? '/' : '\\';
+                }
+            }
+
+            symbol.foregroundColor.setColor(symbol.backgroundColor);
+            symbol.backgroundColor.setColor(Colors::BLACK);
+        }
+    }
+
+    return;
+}
+
+
+void TerminalEffects::blendRow(OneSymbol * destination, const OneSymbol * source, size_t count, double factor, const uint8_t * coverage)
+{
+    factor = std::clamp(factor, 0.0, 1.0);
+    double coverageScale = factor / 255.0;
+
+    #pragma omp simd
+    for (size_t i = 0; i < count; i++)
+    {
+        double alpha = coverage ? coverageScale * coverage[i] : factor;
+        double keep = 1.0 - alpha;
+        const Color & under = destination[i].backgroundColor;
+        const Color & over = source[i].backgroundColor;
+
+        Color background(keep * under.getR() + alpha * over.getR(),
+                         keep * under.getG() + alpha * over.getG(),
+                         keep * under.getB() + alpha * over.getB());
+
+        // A source glyph wins over the destination glyph as soon as it is visible at all; a wide glyph and its right
+        // half are decided together by the coverage of the left half, and only when both fit
+        GlyphId symbol = source[i].symbol;
+        bool rightHalf = symbol == GlyphTable::CONTINUATION && i > 0 && GlyphTable::isWide(source[i - 1].symbol);
+        double headAlpha = rightHalf ? (coverage ? coverageScale * coverage[i - 1] : factor) : alpha;
+        bool glyph = headAlpha > 0.0 && (rightHalf || (GlyphTable::isWide(symbol) ? i + 1 < count : symbol != ' ' && symbol != GlyphTable::CONTINUATION));
+        const Color & ink = glyph ? source[i].foregroundColor : destination[i].foregroundColor;
+        const Color & fade = glyph ? background : over;
+        double inkWeight = glyph ? alpha : keep;
+
+        destination[i].foregroundColor = Color(inkWeight * ink.getR() + (1.0 - inkWeight) * fade.getR(),
+                                               inkWeight * ink.getG() + (1.0 - inkWeight) * fade.getG(),
+                                               inkWeight * ink.getB() + (1.0 - inkWeight) * fade.getB());
+        destination[i].backgroundColor = background;
+        destination[i].symbol = glyph ? symbol : destination[i].symbol;
+    }
+
+    // A source glyph that covered one half of a destination wide glyph leaves the other half blank
+    for (size_t i = 0; i < count; i++)
+    {
+        if (GlyphTable::isWide(destination[i].symbol) && i + 1 < count)
+        {
+            if (destination[i + 1].symbol == GlyphTable::CONTINUATION)
+                i++;
+            else
+                destination[i].symbol = ' ';
+        }
+        else if (destination[i].symbol == GlyphTable::CONTINUATION && i > 0)
+            destination[i].symbol = ' ';
+    }
+
+    return;
+}
+
+
+void TerminalEffects::crossfadeRow(OneSymbol * destination, const OneSymbol * source, size_t count, double factor)
+{
+    factor = std::clamp(factor, 0.0, 1.0);
+    double keep = 1.0 - factor;
+    bool incomingGlyph = factor >= 0.5;
+
+    #pragma omp simd
+    for (size_t i = 0; i < count; i++)
+    {
+        const Color & outFg = destination[i].foregroundColor;
+        const Color & outBg = destination[i].backgroundColor;
+        const Color & inFg = source[i].foregroundColor;
+        const Color & inBg = source[i].backgroundColor;
+
+        destination[i].foregroundColor = Color(keep * outFg.getR() + factor * inFg.getR(),
+                                               keep * outFg.getG() + factor * inFg.getG(),
+                                               keep * outFg.getB() + factor * inFg.getB());
+        destination[i].backgroundColor = Color(keep * outBg.getR() + factor * inBg.getR(),
+                                               keep * outBg.getG() + factor * inBg.getG(),
+                                               keep * outBg.getB() + factor * inBg.getB());
+        destination[i].symbol = incomingGlyph ? source[i].symbol : destination[i].symbol;
+    }
+
+    return;
+}
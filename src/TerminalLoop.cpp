@@ -1,39 +1,234 @@
 #include "TerminalLoop.h"
 
 
+#include <algorithm>
+
+
 TerminalLoop::TerminalLoop(size_t Height, size_t Width, double FrameRate, bool ScaleRatio)
-    : terminal(Height, Width), scaleRatio(ScaleRatio), frameDuration(1000.0 / FrameRate) {}
+    : terminal(Height, Width), scaleRatio(ScaleRatio), inputDescriptor(STDIN_FILENO), frameDuration(1000.0 / FrameRate), stopRequested(false),
+      interrupted(false), frameNumber(0), exemptFrames(0), mouseTracking(false), running(false), asciiArt(false), asciiEdges(false) {}
 
 
 void TerminalLoop::run()
 {
-    while (true)
+    stopRequested = false;
+    interrupted = false;
+    if (!input)
+        input = std::make_unique<InputReader>();
+    input->start(inputDescriptor);
+    input->setMouseTracking(mouseTracking);
+    running = true;
+
+    for (size_t frame = 0; !stopRequested; frame++)
     {
-        char ch;
-        if (read(STDIN_FILENO, &ch, 1) > 0 && (ch == 'Q' || ch == 'q'))
-            return;
+        InputEvent event;
+        while (!stopRequested && input->poll(event))
+            handleInput(event);
+        if (stopRequested)
+            break;
 
         auto startTime = std::chrono::high_resolution_clock::now();
+        size_t allocationsBefore = AllocationCounter::getCount();
+        frameNumber = frame;
 
+        scheduler.tick();
         update();
         render();
 
+        if (AllocationCounter::ENABLED && frame >= AllocationCounter::WARMUP_FRAMES && !terminal.wasResized() && exemptFrames == 0
+            && AllocationCounter::getCount() != allocationsBefore)
+            throw std::runtime_error("steady-state frame " + std::to_string(frame) + " performed "
+                                     + std::to_string(AllocationCounter::getCount() - allocationsBefore) + " heap allocations");
+        if (exemptFrames > 0)
+            exemptFrames--;
+
         auto endTime = std::chrono::high_resolution_clock::now();
         std::chrono::duration<double, std::milli> elapsed = endTime - startTime;
 
+        // Sleep out the frame, but wake as soon as input arrives
         if (elapsed.count() < frameDuration)
-            std::this_thread::sleep_for(std::chrono::milliseconds((long)(frameDuration - elapsed.count())));
+            input->wait(std::chrono::milliseconds((long)(frameDuration - elapsed.count())));
     }
 
+    running = false;
+    input->setMouseTracking(false);
+    input->stop();
+    if (interrupted)
+        throw std::runtime_error("interrupted");
+
     return;
 }
 
 
-void TerminalLoop::render()
+void TerminalLoop::stop()
+{
+    stopRequested = true;
+
+    return;
+}
+
+
+void TerminalLoop::handleInput(const InputEvent & event)
+{
+    scheduler.dispatch(event);
+
+    if (event.type == InputEvent::Type::Interrupt)
+    {
+        interrupted = true;
+        stop();
+    }
+    else if (event.type == InputEvent::Type::Key && event.modifiers == 0 && (event.key == 'Q' || event.key == 'q'))
+        stop();
+
+    return;
+}
+
+
+void TerminalLoop::deliverInput(const InputEvent & event)
+{
+    handleInput(event);
+
+    return;
+}
+
+
+void TerminalLoop::setMouseTracking(bool enabled)
+{
+    mouseTracking = enabled;
+    if (running)
+        input->setMouseTracking(enabled);
+
+    return;
+}
+
+
+void TerminalLoop::compose()
 {
     terminal.setUpScaledGrid(scaleRatio);
+
+    return;
+}
+
+
+void TerminalLoop::present()
+{
     terminal.clearTerminal();
     terminal.printTerminal();
 
     return;
 }
+
+
+size_t TerminalLoop::getFrameNumber() const
+{
+    return frameNumber;
+}
+
+
+void TerminalLoop::allowAllocations(size_t frames)
+{
+    exemptFrames = std::max(exemptFrames, frames);
+
+    return;
+}
+
+
+const std::vector < std::vector < OneSymbol > > & TerminalLoop::renderOffscreen(size_t frame)
+{
+    frameNumber = frame;
+    scheduler.tick();
+    update();
+    compose();
+    timeline.apply(terminal.getScaledGrid(), frameNumber);
+    terminal.endFrame();
+
+    return terminal.getScaledGrid();
+}
+
+
+void TerminalLoop::setOutputSize(size_t height, size_t width)
+{
+    terminal.setOutputSize(height, width);
+
+    return;
+}
+
+
+void TerminalLoop::render()
+{
+    compose();
+    timeline.apply(terminal.getScaledGrid(), frameNumber);
+    if (grading)
+        grading->applyToGrid(terminal.getScaledGrid());
+    if (asciiArt)
+        TerminalEffects::asciiArtEffect(terminal.getScaledGrid(), glyphRamp, terminal.getFrameArena(), asciiEdges);
+    if (recorder)
+        recorder->captureFrame(terminal.getScaledGrid());
+    present();
+    terminal.endFrame();
+
+    return;
+}
+
+
+void TerminalLoop::startRecording(const std::string & path, uint32_t keyframeInterval)
+{
+    recorder.reset();
+    recorder = std::make_unique<FrameRecorder>(path, keyframeInterval);
+
+    return;
+}
+
+
+void TerminalLoop::stopRecording()
+{
+    recorder.reset();
+
+    return;
+}
+
+
+void TerminalLoop::configure(const LoopOptions & options)
+{
+    asciiArt = options.asciiArt || options.asciiEdges;
+    asciiEdges = options.asciiEdges;
+    glyphRamp = GlyphRamp(options.glyphRamp);
+    configureScaling(options);
+
+    // The cheapest output the terminal is known to understand, unless overridden
+    TerminalProfile profile = TerminalProfile::detect();
+    FrameEncoder & encoder = terminal.getEncoder();
+    encoder.setMode(options.encoderMode);
+    encoder.setPalette(options.palette.value_or(profile.trueColor ? FrameEncoder::Palette::TrueColor : FrameEncoder::Palette::Indexed));
+    encoder.setSpans(options.spans.value_or(profile.repeat ? FrameEncoder::Spans::Repeat
+                                            : profile.erase ? FrameEncoder::Spans::Erase : FrameEncoder::Spans::Plain));
+
+    // Sparse frames are only safe when the terminal applies each frame atomically
+    if (options.synchronization == LoopOptions::Synchronization::Auto)
+        terminal.setSynchronizedOutput(profile.synchronizedOutput);
+    else
+        terminal.setSynchronizedOutput(options.synchronization == LoopOptions::Synchronization::Always);
+    terminal.setSparseFrames(options.sparseFrames);
+
+    grading.reset();
+    if (!options.lut.empty())
+    {
+        bool cubeFile = options.lut.size() > 5 && options.lut.ends_with(".cube");
+        grading = std::make_unique<ColorLut>(cubeFile ? ColorLut::loadCube(options.lut) : ColorLut::preset(options.lut, options.lutSize));
+        grading->setInterpolation(options.lutInterpolation);
+    }
+
+    if (!options.recordPath.empty())
+        startRecording(options.recordPath);
+
+    return;
+}
+
+
+void TerminalLoop::configureScaling(const LoopOptions & options)
+{
+    terminal.setLinearLight(options.linearLight);
+    terminal.setResampleFilter(options.filter);
+
+    return;
+}
@@ -0,0 +1,275 @@
+#include "TerminalProfile.h"
+
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <poll.h>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+
+
+namespace
+{
+    /// Version of the cache file layout; entries with another version are ignored.
+    constexpr std::string_view CACHE_VERSION = "1";
+
+
+    std::string_view environment(const char * name)
+    {
+        const char * value = std::getenv(name);
+        return value ? value : "";
+    }
+
+
+    bool containsIgnoringCase(std::string_view text, std::string_view part)
+    {
+        auto match = std::search(text.begin(), text.end(), part.begin(), part.end(),
+                                 [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b)); });
+        return match != text.end();
+    }
+
+
+    /**
+     * @brief Reports whether `answer` holds a complete primary device attributes report, ESC [ ? digits/semicolons c.
+     */
+    bool hasDeviceAttributes(std::string_view answer)
+    {
+        for (size_t start = answer.find("\033[?"); start != std::string_view::npos; start = answer.find("\033[?", start + 1))
+        {
+            size_t end = answer.find_first_not_of("0123456789;", start + 3);
+            if (end != std::string_view::npos && answer[end] == 'c')
+                return true;
+        }
+
+        return false;
+    }
+
+
+    /**
+     * @brief Reports whether a `TERM` value is one that many different emulators send.
+     */
+    bool isGenericTerm(std::string_view term)
+    {
+        static constexpr std::string_view GENERIC[] = {"", "xterm", "xterm-color", "xterm-256color", "xterm-direct", "screen", "screen-256color",
+                                                       "tmux", "tmux-256color", "vt100", "vt220", "ansi", "dumb", "unknown"};
+
+        return std::find(std::begin(GENERIC), std::end(GENERIC), term) != std::end(GENERIC);
+    }
+}
+
+
+TerminalProfile TerminalProfile::detect(bool useCache, int timeoutMilliseconds)
+{
+    // Every loop configures itself, so later ones reuse this process's answer instead of reading the cache or waiting again
+    static std::optional <TerminalProfile> detected;
+
+    TerminalProfile profile = fromEnvironment();
+    if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO))
+        return profile;
+
+    if (useCache && detected && detected->identity == profile.identity)
+        return *detected;
+
+    // Only a complete answer is cached: a reply that missed the timeout over a slow link must not downgrade later starts for good
+    if ((!useCache || !profile.loadCached()) && profile.probe(timeoutMilliseconds))
+        profile.saveCached();
+    detected = profile;
+
+    return profile;
+}
+
+
+TerminalProfile TerminalProfile::fromEnvironment()
+{
+    TerminalProfile profile;
+    std::string_view term = environment("TERM");
+    std::string_view colorTerm = environment("COLORTERM");
+    std::string_view program = environment("TERM_PROGRAM");
+
+    // Variables that tell emulators apart even when they all claim to be xterm-256color; under ssh or screen often none
+    // of them is set, and then different emulators would share one cache entry, so such terminals get no identity
+    std::string_view programVersion = environment("TERM_PROGRAM_VERSION");
+    std::string_view vteVersion = environment("VTE_VERSION");
+    std::string_view konsoleVersion = environment("KONSOLE_VERSION");
+    bool windowsTerminal = !environment("WT_SESSION").empty();
+    if (!isGenericTerm(term) || !program.empty() || !vteVersion.empty() || !konsoleVersion.empty() || windowsTerminal)
+        profile.identity = std::string(term) + "|" + std::string(colorTerm) + "|" + std::string(program) + "|" + std::string(programVersion) + "|"
+                           + std::string(vteVersion) + "|" + std::string(konsoleVersion) + "|" + (windowsTerminal ? "wt" : "");
+
+    profile.trueColor = colorTerm == "truecolor" || colorTerm == "24bit" || term.ends_with("-direct");
+    profile.erase = !term.empty() && term != "dumb" && term != "unknown";
+
+    std::string_view locale = environment("LC_ALL");
+    if (locale.empty())
+        locale = environment("LC_CTYPE");
+    if (locale.empty())
+        locale = environment("LANG");
+    profile.unicode = containsIgnoringCase(locale, "UTF-8") || containsIgnoringCase(locale, "utf8");
+
+    if (!program.empty())
+        profile.applyKnownTerminal(program);
+    if (!vteVersion.empty() || !konsoleVersion.empty() || windowsTerminal)
+        profile.trueColor = true;
+
+    return profile;
+}
+
+
+bool TerminalProfile::probe(int timeoutMilliseconds)
+{
+    // XTVERSION, DECRQM for mode 2026, then DA1 which closes every exchange
+    std::cout << "\033[>0q\033[?2026$p\033[c";
+    std::cout.flush();
+
+    char reply[256];
+    size_t length = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMilliseconds);
+    while (length < sizeof(reply) && !hasDeviceAttributes(std::string_view(reply, length)))
+    {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        struct pollfd input = {STDIN_FILENO, POLLIN, 0};
+        if (remaining.count() <= 0 || poll(&input, 1, int(remaining.count())) <= 0)
+            break;
+
+        ssize_t count = read(STDIN_FILENO, reply + length, sizeof(reply) - length);
+        if (count <= 0)
+            break;
+        length += size_t(count);
+    }
+
+    std::string_view answer(reply, length);
+
+    // XTVERSION is DCS > | name ST
+    size_t name = answer.find("\033P>|");
+    if (name != std::string_view::npos)
+    {
+        size_t end = answer.find('\033', name + 4);
+        version = std::string(answer.substr(name + 4, end == std::string_view::npos ? std::string_view::npos : end - name - 4));
+        std::erase_if(version, [](char ch) { return std::iscntrl(static_cast<unsigned char>(ch)); });
+        applyKnownTerminal(version);
+    }
+
+    // DECRPM is ESC [ ? 2026 ; Ps $ y with Ps 1 or 2 (set or reset) or 3 (permanently set)
+    size_t report = answer.find("\033[?2026;");
+    if (report != std::string_view::npos && report + 8 < answer.size())
+        synchronizedOutput = answer[report + 8] >= '1' && answer[report + 8] <= '3';
+
+    return hasDeviceAttributes(answer);
+}
+
+
+std::string TerminalProfile::describe() const
+{
+    return (version.empty() ? "unknown terminal" : version) + ": " + (trueColor ? "truecolor" : "256 colors")
+           + (synchronizedOutput ? ", synchronized output" : "") + (repeat ? ", REP" : "") + (erase ? ", ECH" : "")
+           + (unicode ? ", UTF-8" : "");
+}
+
+
+std::string TerminalProfile::cachePath()
+{
+    std::string_view cacheHome = environment("XDG_CACHE_HOME");
+    if (!cacheHome.empty())
+        return std::string(cacheHome) + "/terminal-fun/capabilities";
+
+    std::string_view home = environment("HOME");
+    if (!home.empty())
+        return std::string(home) + "/.cache/terminal-fun/capabilities";
+
+    return "";
+}
+
+
+bool TerminalProfile::loadCached()
+{
+    std::string path = cachePath();
+    if (path.empty() || identity.empty())
+        return false;
+
+    // One entry per line: format version, identity, XTVERSION answer, capability flags, separated by tabs
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::vector <std::string> fields;
+        std::istringstream stream(line);
+        for (std::string field; std::getline(stream, field, '\t');)
+            fields.push_back(field);
+
+        if (fields.size() != 4 || fields[0] != CACHE_VERSION || fields[1] != identity)
+            continue;
+
+        version = fields[2];
+        std::istringstream flags(fields[3]);
+        for (std::string flag; flags >> flag;)
+        {
+            trueColor = trueColor || flag == "truecolor";
+            synchronizedOutput = synchronizedOutput || flag == "sync";
+            repeat = repeat || flag == "rep";
+            erase = erase || flag == "ech";
+        }
+        return true;
+    }
+
+    return false;
+}
+
+
+void TerminalProfile::saveCached() const
+{
+    std::string path = cachePath();
+    if (path.empty() || identity.empty())
+        return;
+
+    std::vector <std::string> lines;
+    {
+        std::ifstream file(path);
+        std::string prefix = std::string(CACHE_VERSION) + "\t" + identity + "\t";
+        for (std::string line; std::getline(file, line);)
+            if (!line.starts_with(prefix))
+                lines.push_back(line);
+    }
+
+    // A placeholder keeps the flags field present when no capability was found
+    std::string flags = std::string("-") + (trueColor ? " truecolor" : "") + (synchronizedOutput ? " sync" : "") + (repeat ? " rep" : "") + (erase ? " ech" : "");
+    lines.push_back(std::string(CACHE_VERSION) + "\t" + identity + "\t" + version + "\t" + flags);
+
+    // Written aside and renamed so a concurrent start never reads half a file
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+    std::string temporary = path + "." + std::to_string(getpid());
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        for (const std::string & line : lines)
+            file << line << "\n";
+        if (!file)
+            return;
+    }
+    std::filesystem::rename(temporary, path, error);
+
+    return;
+}
+
+
+void TerminalProfile::applyKnownTerminal(std::string_view name)
+{
+    // Emulators known to handle 24-bit color, and the subset that also implements REP
+    static constexpr std::string_view TRUE_COLOR[] = {"xterm", "tmux", "kitty", "WezTerm", "foot", "ghostty", "contour", "iTerm", "Alacritty",
+                                                      "Konsole", "VTE", "vscode", "rio"};
+    static constexpr std::string_view REPEAT[] = {"xterm", "tmux", "kitty", "WezTerm", "foot", "ghostty", "contour"};
+
+    for (std::string_view known : TRUE_COLOR)
+        trueColor = trueColor || containsIgnoringCase(name, known);
+    for (std::string_view known : REPEAT)
+        repeat = repeat || containsIgnoringCase(name, known);
+
+    return;
+}
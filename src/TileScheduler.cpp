@@ -0,0 +1,181 @@
+#include "TileScheduler.h"
+
+
+#include <algorithm>
+#include <cstdlib>
+
+
+#include "InputReader.h"
+
+
+namespace
+{
+    /// Tiles per participant when the grain allows it; enough to even out uneven tiles.
+    constexpr size_t TILES_PER_THREAD = 8;
+
+    /// Whether the current thread is running a tile, so stages it issues run inline.
+    thread_local bool insideTile = false;
+}
+
+
+TileScheduler & TileScheduler::instance()
+{
+    static TileScheduler scheduler;
+
+    return scheduler;
+}
+
+
+TileScheduler::TileScheduler()
+    : generation(0), remaining(0), threadLimit(1), stopping(false)
+{
+    size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+    if (const char * value = std::getenv("TERMINAL_THREADS"))
+        threads = std::clamp<size_t>(std::strtoul(value, nullptr, 10), 1, MAX_THREADS);
+    deques = std::make_unique<Deque[]>(threads);
+
+    workers.reserve(threads - 1);
+    for (size_t i = 1; i < threads; i++)
+        workers.emplace_back(&TileScheduler::workerLoop, this, i);
+    threadLimit = threads;
+}
+
+
+TileScheduler::~TileScheduler()
+{
+    stopping = true;
+    generation.fetch_add(1, std::memory_order_release);
+    generation.notify_all();
+
+    for (std::thread & worker : workers)
+        worker.join();
+}
+
+
+size_t TileScheduler::getThreadCount() const
+{
+    return workers.size() + 1;
+}
+
+
+void TileScheduler::setThreadLimit(size_t limit)
+{
+    threadLimit.store(std::clamp<size_t>(limit, 1, getThreadCount()), std::memory_order_relaxed);
+
+    return;
+}
+
+
+size_t TileScheduler::getThreadLimit() const
+{
+    return threadLimit.load(std::memory_order_relaxed);
+}
+
+
+void TileScheduler::run(size_t count, size_t grain, Function function, const void * context)
+{
+    if (count == 0)
+        return;
+
+    size_t participants = getThreadLimit();
+    size_t tiles = std::min({(count + std::max<size_t>(grain, 1) - 1) / std::max<size_t>(grain, 1), participants * TILES_PER_THREAD, MAX_TILES});
+    if (tiles <= 1 || participants == 1 || insideTile || busy.test_and_set(std::memory_order_acquire))
+    {
+        function(context, 0, count);
+        return;
+    }
+
+    // Each participant gets a contiguous share, so neighbouring rows stay on one core unless stolen
+    size_t tileSize = (count + tiles - 1) / tiles;
+    tiles = (count + tileSize - 1) / tileSize;
+    remaining.store(tiles, std::memory_order_relaxed);
+    for (size_t p = 0; p < participants; p++)
+    {
+        Deque & deque = deques[p];
+        while (deque.lock.test_and_set(std::memory_order_acquire))
+            ;
+
+        deque.front = 0;
+        deque.back = 0;
+        for (size_t t = p * tiles / participants; t < (p + 1) * tiles / participants; t++)
+            deque.tiles[deque.back++] = Tile{function, context, t * tileSize, std::min((t + 1) * tileSize, count)};
+
+        deque.lock.clear(std::memory_order_release);
+    }
+
+    generation.fetch_add(1, std::memory_order_release);
+    generation.notify_all();
+
+    insideTile = true;
+    work(0);
+    insideTile = false;
+
+    for (size_t left = remaining.load(std::memory_order_acquire); left != 0; left = remaining.load(std::memory_order_acquire))
+        remaining.wait(left, std::memory_order_acquire);
+
+    busy.clear(std::memory_order_release);
+
+    return;
+}
+
+
+void TileScheduler::work(size_t self)
+{
+    // Workers beyond the limit sit the stage out
+    size_t participants = getThreadLimit();
+    if (self >= participants)
+        return;
+
+    Tile tile;
+
+    while (true)
+    {
+        bool found = take(deques[self], false, tile);
+        for (size_t k = 1; !found && k < participants; k++)
+            found = take(deques[(self + k) % participants], true, tile);
+        if (!found)
+            break;
+
+        tile.function(tile.context, tile.begin, tile.end);
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            remaining.notify_all();
+    }
+
+    return;
+}
+
+
+bool TileScheduler::take(Deque & deque, bool steal, Tile & tile)
+{
+    while (deque.lock.test_and_set(std::memory_order_acquire))
+        ;
+
+    bool found = deque.front < deque.back;
+    if (found)
+        tile = steal ? deque.tiles[--deque.back] : deque.tiles[deque.front++];
+
+    deque.lock.clear(std::memory_order_release);
+
+    return found;
+}
+
+
+void TileScheduler::workerLoop(size_t self)
+{
+    // Signals belong to the InputReader's signalfd, never to a worker
+    InputReader::blockSignals();
+
+    insideTile = true;
+    uint32_t seen = 0;
+    while (true)
+    {
+        generation.wait(seen, std::memory_order_acquire);
+        seen = generation.load(std::memory_order_acquire);
+        if (stopping)
+            break;
+
+        work(self);
+    }
+
+    return;
+}
@@ -0,0 +1,166 @@
+#include "TiledLayout.h"
+
+
+#include <algorithm>
+#include <cmath>
+
+
+#include "TileScheduler.h"
+
+
+namespace
+{
+    /**
+     * @brief Converts a fraction of a terminal dimension to a cell index, so adjacent panels share their edges exactly.
+     */
+    size_t toCells(double fraction, size_t cells)
+    {
+        return size_t(std::lround(std::clamp(fraction, 0.0, 1.0) * double(cells)));
+    }
+}
+
+
+TiledLayout::TiledLayout(const LoopOptions & SceneOptions, double FrameRate)
+    : TerminalLoop(1, 1, FrameRate), sceneOptions(SceneOptions), frameRate(FrameRate), repaint(true), focus(0)
+{
+    setMouseTracking(true);
+}
+
+
+void TiledLayout::addPanel(std::unique_ptr <TerminalLoop> scene, double top, double left, double height, double width, double FrameRate)
+{
+    scene->configureScaling(sceneOptions);
+    double step = FrameRate <= 0.0 || FrameRate >= frameRate ? 1.0 : FrameRate / frameRate;
+
+    // Start due, so every panel has a frame to show from the first one on
+    panels.push_back(Panel{std::move(scene), top, left, height, width, step, 1.0, 0, false, FrameEncoder::Region{0, 0, 0, 0}, nullptr});
+    changed.reserve(panels.size());
+    repaint = true;
+
+    return;
+}
+
+
+void TiledLayout::update()
+{
+    for (Panel & panel : panels)
+    {
+        panel.credit += panel.step;
+        panel.due = panel.credit >= 1.0;
+        if (panel.due)
+            panel.credit -= 1.0;
+    }
+
+    return;
+}
+
+
+void TiledLayout::compose()
+{
+    terminal.resizeScaledGrid();
+    std::vector < std::vector < OneSymbol > > & frame = terminal.getScaledGrid();
+    if (frame.empty())
+        return;
+
+    if (terminal.wasResized() || repaint)
+    {
+        layOut(frame.size(), frame.front().size());
+        for (auto & row : frame)
+            std::fill(row.begin(), row.end(), OneSymbol());
+        repaint = true;
+    }
+
+    // Every panel is a tile of its own, so threads done with cheap panels steal the rest
+    size_t count = panels.size();
+    TileScheduler::instance().parallelFor(count, 1, [&](size_t first, size_t last)
+    {
+        for (size_t p = first; p < last; p++)
+            if (panels[p].due)
+                panels[p].output = &panels[p].scene->renderOffscreen(panels[p].frame++);
+    });
+
+    // Panels that did not render still have their last frame, which grading and effects start from again
+    for (const Panel & panel : panels)
+    {
+        if (panel.output == nullptr)
+            continue;
+
+        const std::vector < std::vector < OneSymbol > > & source = *panel.output;
+        size_t rows = std::min(source.size(), panel.region.height);
+        for (size_t i = 0; i < rows; i++)
+        {
+            size_t cols = std::min(source[i].size(), panel.region.width);
+            std::copy_n(source[i].begin(), cols, frame[panel.region.top + i].begin() + ptrdiff_t(panel.region.left));
+        }
+    }
+
+    return;
+}
+
+
+void TiledLayout::present()
+{
+    // Timeline effects change every panel, and the frame after the last one must undo them
+    if (repaint || timeline.isActive(getFrameNumber()) || (getFrameNumber() > 0 && timeline.isActive(getFrameNumber() - 1)))
+    {
+        TerminalLoop::present();
+        repaint = false;
+        return;
+    }
+
+    changed.clear();
+    for (const Panel & panel : panels)
+        if (panel.due && panel.region.height > 0 && panel.region.width > 0)
+            changed.push_back(panel.region);
+    if (!changed.empty())
+        terminal.printRegions(changed);
+
+    return;
+}
+
+
+void TiledLayout::handleInput(const InputEvent & event)
+{
+    if (event.type == InputEvent::Type::Mouse)
+    {
+        for (size_t p = 0; p < panels.size(); p++)
+        {
+            const FrameEncoder::Region & region = panels[p].region;
+            if (event.row < region.top || event.row >= region.top + region.height
+                || event.col < region.left || event.col >= region.left + region.width)
+                continue;
+
+            if (event.pressed)
+                focus = p;
+            InputEvent local = event;
+            local.row = uint16_t(event.row - region.top);
+            local.col = uint16_t(event.col - region.left);
+            panels[p].scene->deliverInput(local);
+            break;
+        }
+        return;
+    }
+
+    if (event.type == InputEvent::Type::Key && focus < panels.size())
+        panels[focus].scene->deliverInput(event);
+    TerminalLoop::handleInput(event);
+
+    return;
+}
+
+
+void TiledLayout::layOut(size_t rows, size_t cols)
+{
+    for (Panel & panel : panels)
+    {
+        size_t top = toCells(panel.top, rows), bottom = toCells(panel.top + panel.height, rows);
+        size_t left = toCells(panel.left, cols), right = toCells(panel.left + panel.width, cols);
+        panel.region = FrameEncoder::Region{top, left, bottom > top ? bottom - top : 0, right > left ? right - left : 0};
+
+        // A size of 0 would make the scene follow the whole terminal instead
+        panel.scene->setOutputSize(std::max<size_t>(panel.region.height, 1), std::max<size_t>(panel.region.width, 1));
+        panel.due = true;
+    }
+
+    return;
+}
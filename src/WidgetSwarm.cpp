@@ -0,0 +1,148 @@
+#include "WidgetSwarm.h"
+
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+    constexpr size_t MAX_WIDGET_SIZE = 12;
+    constexpr size_t MAX_SPARK_SIZE = 24;
+
+    const Color PALETTE[] = {Colors::CORAL, Colors::GOLD, Colors::TURQUOISE, Colors::LIME, Colors::PINK, Colors::LIGHT_BLUE};
+
+
+    /**
+     * @brief Advances an xorshift state and returns it.
+     */
+    uint32_t nextRandom(uint32_t & state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+
+        return state;
+    }
+}
+
+
+WidgetSwarm::WidgetSwarm(double FrameRate, bool ScaleRatio)
+    : TerminalLoop(DIMENSIONS, DIMENSIONS, FrameRate, ScaleRatio), sparkSeed(0x9E3779B9u)
+{
+    for (size_t i = 0; i < WIDGET_COUNT; i++)
+        scheduler.spawn(animate(widgets[i], uint32_t(i + 1) * 2654435761u));
+    scheduler.spawn(listen());
+
+    return;
+}
+
+
+void WidgetSwarm::update()
+{
+    auto & grid = GRID(terminal);
+    for (auto & row : grid)
+        for (auto & symbol : row)
+            symbol.backgroundColor = Colors::BLACK;
+
+    for (const Widget & widget : widgets)
+        draw(widget);
+    for (const Widget & widget : sparks)
+        draw(widget);
+
+    return;
+}
+
+
+SceneTask WidgetSwarm::animate(Widget & widget, uint32_t seed)
+{
+    while (true)
+    {
+        // Pick a spot and a color, then grow from a single cell
+        size_t target = 4 + nextRandom(seed) % (MAX_WIDGET_SIZE - 3);
+        widget.row = nextRandom(seed) % (DIMENSIONS - target);
+        widget.col = nextRandom(seed) % (DIMENSIONS - target);
+        widget.color = PALETTE[nextRandom(seed) % std::size(PALETTE)];
+        widget.glow = 1.0;
+        for (widget.size = 1; widget.size < target; widget.size++)
+            co_await SceneTask::nextFrame();
+
+        // Pulse for one to three seconds
+        double phase = double(nextRandom(seed) % 628) / 100.0;
+        double end = scheduler.getTime() + 1.0 + double(nextRandom(seed) % 200) / 100.0;
+        while (scheduler.getTime() < end)
+        {
+            widget.glow = 0.65 + 0.35 * std::sin(6.0 * scheduler.getTime() + phase);
+            co_await SceneTask::nextFrame();
+        }
+
+        // Shrink at half the speed it grew, then rest out of sight
+        while (widget.size > 0)
+        {
+            widget.size--;
+            co_await SceneTask::frames(2);
+        }
+        co_await SceneTask::seconds(double(nextRandom(seed) % 150) / 100.0);
+    }
+}
+
+
+SceneTask WidgetSwarm::listen()
+{
+    while (true)
+    {
+        InputEvent event = co_await SceneTask::input();
+        if (event.type != InputEvent::Type::Key || event.key != ' ')
+            continue;
+
+        // Sparks that find every slot taken are dropped
+        auto slot = std::find_if(sparks.begin(), sparks.end(), [](const Widget & widget) { return widget.size == 0; });
+        if (slot == sparks.end())
+            continue;
+
+        slot->row = nextRandom(sparkSeed) % DIMENSIONS;
+        slot->col = nextRandom(sparkSeed) % DIMENSIONS;
+        slot->size = 1;
+        slot->hollow = true;
+        slot->color = Colors::WHITE;
+        scheduler.spawn(spark(*slot));
+    }
+}
+
+
+SceneTask WidgetSwarm::spark(Widget & spark)
+{
+    size_t centerRow = spark.row;
+    size_t centerCol = spark.col;
+
+    for (size_t size = 1; size <= MAX_SPARK_SIZE; size += 2)
+    {
+        spark.row = centerRow - std::min(centerRow, size / 2);
+        spark.col = centerCol - std::min(centerCol, size / 2);
+        spark.size = size;
+        spark.glow = 1.0 - double(size) / double(MAX_SPARK_SIZE + 1);
+        co_await SceneTask::nextFrame();
+    }
+    spark.size = 0;
+}
+
+
+void WidgetSwarm::draw(const Widget & widget)
+{
+    auto & grid = GRID(terminal);
+    size_t lastRow = std::min(widget.row + widget.size, grid.size());
+
+    Color color = widget.color;
+    color.scaleColor(widget.glow);
+
+    for (size_t i = widget.row; i < lastRow; i++)
+    {
+        size_t lastCol = std::min(widget.col + widget.size, grid[i].size());
+        bool edgeRow = i == widget.row || i + 1 == widget.row + widget.size;
+        for (size_t ii = widget.col; ii < lastCol; ii++)
+            if (!widget.hollow || edgeRow || ii == widget.col || ii + 1 == widget.col + widget.size)
+                grid[i][ii].backgroundColor = color;
+    }
+
+    return;
+}
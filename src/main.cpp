@@ -1,10 +1,254 @@
+#include <cstring>
+#include <string_view>
+
+
 #include "MainMenu.h"
+#include "FrameRecorder.h"
+#include "FrameReplay.h"
+#include "StreamSource.h"
+#include "SharedFrameSource.h"
+#include "ImageViewer.h"
+#include "FrameBenchmark.h"
 
 
-int main()
+namespace
+{
+    void printUsage(const char * program)
+    {
+        std::cerr
+            << "usage: " << program << " [--record FILE] [--ascii|--ascii-edges|--blocks] [--fg-only|--mono] [--linear]\n"
+            << "       " << std::string(std::strlen(program), ' ') << "  [--lut FILE.cube|sepia|night|deuteranopia] [--lut-size N] [--trilinear]\n"
+            << "       " << std::string(std::strlen(program), ' ') << "  [--filter area|nearest|bilinear|lanczos] [--spans none|plain|erase|repeat]\n"
+            << "       " << std::string(std::strlen(program), ' ') << "  [--sync auto|on|off] [--full-frames] [--colors truecolor|256]\n"
+            << "       " << program << " --export-cast RECORDING CAST\n"
+            << "       " << program << " --replay RECORDING [--fast] [--headless] [--from FRAME]\n"
+            << "       " << program << " --stream FILE|- [--raw WIDTHxHEIGHT] [--fps RATE] [OPTIONS]\n"
+            << "       " << program << " --shm NAME [--fps RATE] [OPTIONS]\n"
+            << "       " << program << " --image FILE [OPTIONS]\n"
+            << "       " << program << " --bench\n"
+            << "       " << program << " --probe\n";
+    }
+
+
+    FrameEncoder::Spans parseSpans(std::string_view name)
+    {
+        if (name == "none")
+            return FrameEncoder::Spans::None;
+        if (name == "plain")
+            return FrameEncoder::Spans::Plain;
+        if (name == "erase")
+            return FrameEncoder::Spans::Erase;
+        if (name == "repeat")
+            return FrameEncoder::Spans::Repeat;
+
+        throw std::invalid_argument("unknown span mode '" + std::string(name) + "'");
+    }
+
+
+    LoopOptions::Synchronization parseSynchronization(std::string_view name)
+    {
+        if (name == "auto")
+            return LoopOptions::Synchronization::Auto;
+        if (name == "on")
+            return LoopOptions::Synchronization::Always;
+        if (name == "off")
+            return LoopOptions::Synchronization::Never;
+
+        throw std::invalid_argument("unknown synchronization '" + std::string(name) + "'");
+    }
+
+
+    FrameEncoder::Palette parsePalette(std::string_view name)
+    {
+        if (name == "truecolor")
+            return FrameEncoder::Palette::TrueColor;
+        if (name == "256")
+            return FrameEncoder::Palette::Indexed;
+
+        throw std::invalid_argument("unknown color depth '" + std::string(name) + "'");
+    }
+
+
+    void probe()
+    {
+        TerminalProfile profile;
+        {
+            // Answers are only readable once echo and line buffering are off
+            TerminalControl terminal(1, 1);
+            profile = TerminalProfile::detect(false);
+        }
+        std::cout << profile.describe() << "\n";
+    }
+
+
+    void replay(const std::string & path, FrameReplay::Timing timing, FrameReplay::Output output, uint32_t firstFrame)
+    {
+        FrameReplay frameReplay(path);
+        FrameReplay::Statistics statistics = frameReplay.play(timing, output, firstFrame);
+
+        double seconds = std::max(statistics.seconds, 1e-9);
+        std::cerr
+            << "replayed " << statistics.frames << " frames (" << statistics.bytes << " bytes) in " << statistics.seconds << " s: "
+            << double(statistics.frames) / seconds << " fps, " << double(statistics.bytes) / seconds / 1e6 << " MB/s\n";
+    }
+
+
+    void stream(const std::string & path, const std::string & rawSize, double frameRate, const LoopOptions & options)
+    {
+        size_t width = 0, height = 0;
+        StreamSource::Format format = StreamSource::Format::Netpbm;
+        if (!rawSize.empty())
+        {
+            size_t separator = rawSize.find('x');
+            if (separator == std::string::npos)
+                throw std::invalid_argument("raw frame size must look like WIDTHxHEIGHT");
+            width = std::stoul(rawSize.substr(0, separator));
+            height = std::stoul(rawSize.substr(separator + 1));
+            format = StreamSource::Format::RawRGB24;
+        }
+
+        StreamSource::Statistics statistics;
+        {
+            StreamSource source(path, format, width, height, frameRate);
+            source.configure(options);
+            source.run();
+            statistics = source.getStatistics();
+        }
+
+        double seconds = std::max(statistics.seconds, 1e-9);
+        std::cerr
+            << "streamed " << statistics.framesShown << " of " << statistics.framesRead << " frames (" << statistics.bytesRead << " bytes) in "
+            << statistics.seconds << " s: " << double(statistics.framesShown) / seconds << " fps, "
+            << double(statistics.bytesRead) / seconds / 1e6 << " MB/s\n";
+    }
+
+
+    void shareFrames(const std::string & name, double frameRate, const LoopOptions & options)
+    {
+        SharedFrameSource::Statistics statistics;
+        {
+            SharedFrameSource source(name, frameRate);
+            source.configure(options);
+            source.run();
+            statistics = source.getStatistics();
+        }
+
+        std::cerr
+            << "showed " << statistics.framesShown << " of " << statistics.framesWritten << " shared frames, "
+            << statistics.framesTorn << " torn reads retried\n";
+    }
+}
+
+
+int main(int argc, char * argv[])
 {
     std::ios::sync_with_stdio(false);
     std::cout.tie(nullptr);
-    runMainMenu();
+    try
+    {
+        LoopOptions options;
+        std::string replayPath, streamPath, rawSize, imagePath, sharedName;
+        double frameRate = 30.0;
+        FrameReplay::Timing timing = FrameReplay::Timing::Original;
+        FrameReplay::Output output = FrameReplay::Output::Terminal;
+        uint32_t firstFrame = 0;
+
+        for (int i = 1; i < argc; i++)
+        {
+            std::string_view argument = argv[i];
+            if (argument == "--record" && i + 1 < argc)
+                options.recordPath = argv[++i];
+            else if (argument == "--ascii")
+                options.asciiArt = true;
+            else if (argument == "--ascii-edges")
+                options.asciiEdges = true;
+            else if (argument == "--blocks")
+            {
+                options.asciiArt = true;
+                options.glyphRamp = GlyphRamp::BLOCK_RAMP;
+            }
+            else if (argument == "--fg-only")
+                options.encoderMode = FrameEncoder::Mode::ForegroundOnly;
+            else if (argument == "--mono")
+                options.encoderMode = FrameEncoder::Mode::Monochrome;
+            else if (argument == "--linear")
+                options.linearLight = true;
+            else if (argument == "--lut" && i + 1 < argc)
+                options.lut = argv[++i];
+            else if (argument == "--lut-size" && i + 1 < argc)
+                options.lutSize = std::stoul(argv[++i]);
+            else if (argument == "--trilinear")
+                options.lutInterpolation = ColorLut::Interpolation::Trilinear;
+            else if (argument == "--filter" && i + 1 < argc)
+                options.filter = Resampler::parseFilter(argv[++i]);
+            else if (argument == "--spans" && i + 1 < argc)
+                options.spans = parseSpans(argv[++i]);
+            else if (argument == "--sync" && i + 1 < argc)
+                options.synchronization = parseSynchronization(argv[++i]);
+            else if (argument == "--colors" && i + 1 < argc)
+                options.palette = parsePalette(argv[++i]);
+            else if (argument == "--probe")
+            {
+                probe();
+                return 0;
+            }
+            else if (argument == "--full-frames")
+                options.sparseFrames = false;
+            else if (argument == "--replay" && i + 1 < argc)
+                replayPath = argv[++i];
+            else if (argument == "--fast")
+                timing = FrameReplay::Timing::AsFastAsPossible;
+            else if (argument == "--headless")
+                output = FrameReplay::Output::Headless;
+            else if (argument == "--from" && i + 1 < argc)
+                firstFrame = uint32_t(std::stoul(argv[++i]));
+            else if (argument == "--stream" && i + 1 < argc)
+                streamPath = argv[++i];
+            else if (argument == "--shm" && i + 1 < argc)
+                sharedName = argv[++i];
+            else if (argument == "--image" && i + 1 < argc)
+                imagePath = argv[++i];
+            else if (argument == "--raw" && i + 1 < argc)
+                rawSize = argv[++i];
+            else if (argument == "--fps" && i + 1 < argc)
+                frameRate = std::stod(argv[++i]);
+            else if (argument == "--bench")
+            {
+                FrameBenchmark benchmark;
+                benchmark.run(std::cout);
+                return 0;
+            }
+            else if (argument == "--export-cast" && i + 2 < argc)
+            {
+                FrameRecorder::exportAsciicast(argv[i + 1], argv[i + 2]);
+                return 0;
+            }
+            else
+            {
+                printUsage(argv[0]);
+                return 2;
+            }
+        }
+
+        if (!replayPath.empty())
+            replay(replayPath, timing, output, firstFrame);
+        else if (!streamPath.empty())
+            stream(streamPath, rawSize, frameRate, options);
+        else if (!sharedName.empty())
+            shareFrames(sharedName, frameRate, options);
+        else if (!imagePath.empty())
+        {
+            ImageViewer viewer(imagePath, options.linearLight);
+            viewer.configure(options);
+            viewer.run();
+        }
+        else
+            runMainMenu(options);
+    }
+    catch (const std::exception & error)
+    {
+        std::cerr << "terminal-fun: " << error.what() << "\n";
+        return 1;
+    }
     return 0;
 }
@@ -0,0 +1,184 @@
+/**
+ * @file SharedFrameTest.cpp
+ * @brief Self-checking test of the SharedFrame hand-over, run by `make test`.
+ *
+ * Creates a real POSIX shared-memory segment, writes known frames into it
+ * and reads them back through `SharedFrameSource::readFrame()`, the path the
+ * loop uses every frame. It also checks that frames are rejected while the
+ * writer is busy or when it started a frame during the read, that a closed
+ * segment ends the loop, and that a concurrent writer never hands over a
+ * mixed frame. It needs no terminal and exits non-zero on the first failure.
+ */
+
+
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+
+#include "SharedFrameSource.h"
+
+
+namespace
+{
+    constexpr size_t HEIGHT = 9, WIDTH = 14;
+
+    using Grid = std::vector < std::vector < OneSymbol > >;
+
+
+    void check(bool condition, const char * what)
+    {
+        if (condition)
+            return;
+
+        std::cerr << "SharedFrameTest: " << what << "\n";
+        std::exit(1);
+    }
+
+
+    /**
+     * @brief Color of a cell in frame `number`; every cell and frame differs.
+     */
+    uint32_t expectedCell(uint32_t number, size_t row, size_t col)
+    {
+        return SharedFrame::pack(uint8_t(number), uint8_t(row * WIDTH + col), uint8_t(number * 7 + row));
+    }
+
+
+    void writeFrame(SharedFrame & frame, uint32_t number)
+    {
+        frame.beginWrite();
+        std::atomic <uint32_t> * cell = frame.getCells();
+        for (size_t i = 0; i < HEIGHT; i++)
+            for (size_t j = 0; j < WIDTH; j++)
+                (cell++)->store(expectedCell(number, i, j), std::memory_order_relaxed);
+        frame.endWrite();
+    }
+
+
+    /**
+     * @brief Reports whether every cell of a grid holds frame `number`.
+     */
+    bool holdsFrame(const Grid & grid, uint32_t number)
+    {
+        for (size_t i = 0; i < HEIGHT; i++)
+            for (size_t j = 0; j < WIDTH; j++)
+            {
+                uint32_t cell = expectedCell(number, i, j);
+                const Color & color = grid[i][j].backgroundColor;
+                if (color.getRed() != int(cell >> 16 & 0xFF) || color.getGreen() != int(cell >> 8 & 0xFF) || color.getBlue() != int(cell & 0xFF))
+                    return false;
+            }
+
+        return true;
+    }
+
+
+    /**
+     * @brief Returns the frame a grid holds, judged by its first cell.
+     */
+    uint32_t frameOf(const Grid & grid)
+    {
+        return uint32_t(grid[0][0].backgroundColor.getRed());
+    }
+}
+
+
+int main()
+{
+    std::string name = "/terminal-fun-test-" + std::to_string(getpid());
+    size_t size = SharedFrame::getSize(HEIGHT, WIDTH);
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    check(fd >= 0 && ftruncate(fd, off_t(size)) == 0, "cannot create the segment");
+    void * mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    shm_unlink(name.c_str());
+    check(mapping != MAP_FAILED, "cannot map the segment");
+
+    SharedFrame & frame = *new (mapping) SharedFrame{};
+    frame.version = SharedFrame::VERSION;
+    frame.height = HEIGHT;
+    frame.width = WIDTH;
+    frame.magic.store(SharedFrame::MAGIC, std::memory_order_release);
+
+    Grid grid(HEIGHT, std::vector <OneSymbol>(WIDTH));
+    uint64_t shown = 0;
+
+    // Nothing published yet
+    check(SharedFrameSource::readFrame(frame, shown, grid) == SharedFrameSource::Read::Unchanged, "an empty segment was read as a frame");
+
+    // A published frame arrives cell for cell, once
+    writeFrame(frame, 1);
+    check(SharedFrameSource::readFrame(frame, shown, grid) == SharedFrameSource::Read::Shown, "a published frame was not read");
+    check(holdsFrame(grid, 1), "the frame read differs from the one written");
+    check(shown == 2, "the shown sequence does not match the writer's");
+    check(SharedFrameSource::readFrame(frame, shown, grid) == SharedFrameSource::Read::Unchanged, "a frame was read twice");
+
+    // An odd sequence means the writer is busy
+    frame.beginWrite();
+    check(SharedFrameSource::readFrame(frame, shown, grid) == SharedFrameSource::Read::Busy, "a frame being written was read");
+    check(shown == 2, "a busy read moved the shown sequence");
+    frame.endWrite();
+
+    // A frame started while the cells were read is rejected, with beginRead() before and endRead() after the write
+    writeFrame(frame, 2);
+    uint64_t started = frame.beginRead();
+    check(started == 6 && frame.endRead(started), "an untouched read was rejected");
+    writeFrame(frame, 3);
+    check(!frame.endRead(started), "a read overlapping a write was accepted");
+    frame.beginWrite();
+    check(!frame.endRead(frame.beginRead()), "a read started during a write was accepted");
+    frame.endWrite();
+
+    // The newest frame is read, and the closed flag ends the loop only once it has been shown
+    writeFrame(frame, 4);
+    frame.closed.store(1, std::memory_order_release);
+    check(SharedFrameSource::readFrame(frame, shown, grid) == SharedFrameSource::Read::Shown, "the last frame before closing was not read");
+    check(holdsFrame(grid, 4), "the last frame differs from the one written");
+    check(SharedFrameSource::readFrame(frame, shown, grid) == SharedFrameSource::Read::Closed, "a closed segment did not end the loop");
+    frame.closed.store(0, std::memory_order_release);
+
+    // A writer racing the reader: every frame handed over is whole and newer than the one before
+    constexpr uint32_t RACED_FRAMES = 20000;
+    std::thread writer([&frame]
+    {
+        // Yielding now and then leaves gaps between frames for whole reads to land in
+        for (uint32_t number = 5; number < RACED_FRAMES; number++)
+        {
+            writeFrame(frame, number);
+            if (number % 4 == 0)
+                std::this_thread::yield();
+        }
+        frame.closed.store(1, std::memory_order_release);
+    });
+
+    // The empty write above took a sequence number of its own, so count frames from the last one shown
+    const uint64_t base = shown;
+    size_t read = 0;
+    uint32_t last = 4;
+    for (SharedFrameSource::Read result = SharedFrameSource::Read::Unchanged; result != SharedFrameSource::Read::Closed; )
+    {
+        result = SharedFrameSource::readFrame(frame, shown, grid);
+        if (result != SharedFrameSource::Read::Shown)
+            continue;
+
+        uint32_t number = 4 + uint32_t((shown - base) / 2);
+        check(holdsFrame(grid, number), "a racing read handed over a mixed frame");
+        check(number > last && uint8_t(number) == frameOf(grid), "a racing read went back in time");
+        last = number;
+        read++;
+    }
+    writer.join();
+    check(last == RACED_FRAMES - 1, "the last raced frame was not read before the segment closed");
+
+    munmap(mapping, size);
+    std::cout << "SharedFrameTest: passed (" << read << " of " << RACED_FRAMES - 5 << " raced frames read)\n";
+
+    return 0;
+}